@@ -0,0 +1,251 @@
+/**
+ * \file	Autotuner.cpp
+ *
+ * Finds the thread count, strips per worker and drawing tile size that run a
+ * flock fastest on this host, by timing them, and remembers the winner in a
+ * cache file so that later runs start out with it.
+ *
+ * What is fastest depends on the caches and cores of the host as much as on
+ * the flock: a dense flock puts many Boids in each strip and many sprites in
+ * each tile. So the flock is first left to settle for a while, starting from
+ * the population that is about to be run, with its coefficients, until its
+ * density is about what the run will see. Then every combination of thread
+ * count and strips per worker gets a few steps of that flock, and every tile
+ * size a few frames of drawing it off screen, and the fastest step and frame
+ * win. Only the fastest of the repetitions counts, which is least disturbed
+ * by whatever else the host is doing.
+ *
+ * The cache file holds one line per host and kind of run, tab-separated:
+ * host name, a description of the run (see flock.cpp), thread count, strips
+ * per worker and tile size. A home directory shared between hosts can keep
+ * a single file for all of them.
+ *
+ * @since	2026-10-18
+ */
+
+/**
+ * Includes.
+ */
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <stdexcept>
+#include <stdio.h>
+#include <unistd.h>
+#include "WorkerPool.h"
+#include "Simulation.h"
+#include "TileRenderer.h"
+#include "Autotuner.h"
+
+/**
+ * Definitions.
+ */
+#define SETTLE_STEPS 20 // Steps the flock gets to settle before anything is timed
+#define TIMED_STEPS 4 // Timed steps per thread count and strips
+#define TIMED_FRAMES 8 // Timed frames per tile size
+#define MAX_STRIPS_PER_WORKER 8
+
+/**
+ * Name of this host.
+ *
+ * @return	The host name, or "localhost" if it can't be found.
+ */
+string hostName(){
+	char name[256];
+	if(gethostname(name, sizeof(name)) != 0){
+		return "localhost";
+	}
+	name[sizeof(name) - 1] = '\0';
+
+	return name;
+}
+
+/**
+ * Looks up the settings for a kind of run on a host.
+ *
+ * @param path		Path of the cache file. A missing file has no
+ * 			settings in it.
+ * @param host		Name of the host.
+ * @param workload	Description of the kind of run.
+ * @param settings	Set to the cached settings, if any.
+ * @return		true if there were settings in the cache.
+ */
+bool findTuning(const string& path, const string& host, const string& workload, TuningSettings& settings){
+	ifstream file(path.c_str());
+	string line;
+	bool found = false;
+	while(getline(file, line)){
+		istringstream fields(line);
+		string lineHost, lineWorkload;
+		TuningSettings lineSettings;
+		if(getline(fields, lineHost, '\t') && getline(fields, lineWorkload, '\t')
+				&& fields >> lineSettings.threads >> lineSettings.stripsPerWorker >> lineSettings.tileSize
+				&& lineHost == host && lineWorkload == workload
+				&& lineSettings.threads > 0 && lineSettings.stripsPerWorker > 0 && lineSettings.tileSize > 0){
+			settings = lineSettings;
+			found = true;
+		}
+	}
+
+	return found;
+}
+
+/**
+ * Stores the settings for a kind of run on a host, replacing any there were.
+ *
+ * The file is written anew next to the old one and then renamed over it, so
+ * runs tuning at the same time never leave a half-written file behind.
+ *
+ * @param path		Path of the cache file.
+ * @param host		Name of the host.
+ * @param workload	Description of the kind of run. Must not contain
+ * 			tabs or line breaks.
+ * @param settings	The settings.
+ * @throws		std::runtime_error if the file can't be written.
+ */
+void storeTuning(const string& path, const string& host, const string& workload, const TuningSettings& settings){
+	string prefix = host + '\t' + workload + '\t';
+	vector<string> lines;
+	ifstream in(path.c_str());
+	string line;
+	while(getline(in, line)){
+		if(line.compare(0, prefix.size(), prefix) != 0){
+			lines.push_back(line);
+		}
+	}
+	in.close();
+
+	string temporary = path + "." + to_string(getpid());
+	ofstream out(temporary.c_str());
+	for(unsigned int i = 0; i < lines.size(); i++){
+		out << lines[i] << '\n';
+	}
+	out << prefix << settings.threads << '\t' << settings.stripsPerWorker << '\t' << settings.tileSize << '\n';
+	out.close();
+	if(!out || rename(temporary.c_str(), path.c_str()) != 0){
+		remove(temporary.c_str());
+		throw runtime_error("Unable to write to " + path);
+	}
+}
+
+/**
+ * Finds the fastest thread count and strips per worker for a flock.
+ *
+ * @param pop		The flock to time.
+ * @param edgeOfWorld	X and Y coordinates of the maximum extent of the
+ * 			simulated space.
+ * @param wrapped	true if the edges of the world wrap around.
+ * @param destination	Coordinates toward which the boids should head.
+ * @param quality	Perception cutoff and flockmate stride to use.
+ * @param maxThreads	Most threads to try.
+ * @param settings	Thread count and strips per worker set to the
+ * 			fastest.
+ */
+static void tuneSimulation(const vector<Boid>& pop, const Point& edgeOfWorld, bool wrapped, const Point& destination, const QualitySettings& quality, unsigned int maxThreads, TuningSettings& settings){
+	/* Powers of two, and all of the threads.
+	 */
+	vector<unsigned int> threadCounts;
+	for(unsigned int threads = 1; threads < maxThreads; threads *= 2){
+		threadCounts.push_back(threads);
+	}
+	threadCounts.push_back(maxThreads);
+
+	double fastest = -1.0;
+	for(unsigned int t = 0; t < threadCounts.size(); t++){
+		WorkerPool workers(threadCounts[t]);
+		for(unsigned int strips = 1; strips <= MAX_STRIPS_PER_WORKER && threadCounts[t]*strips <= edgeOfWorld.x; strips *= 2){
+			/* The first step allocates, and is not timed.
+			 */
+			Simulation sim(pop, edgeOfWorld, wrapped, workers, strips);
+			sim.step(destination, quality);
+			for(unsigned int i = 0; i < TIMED_STEPS; i++){
+				chrono::steady_clock::time_point start = chrono::steady_clock::now();
+				sim.step(destination, quality);
+				chrono::duration<double> stepTime = chrono::steady_clock::now() - start;
+				if(fastest < 0.0 || stepTime.count() < fastest){
+					fastest = stepTime.count();
+					settings.threads = threadCounts[t];
+					settings.stripsPerWorker = strips;
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Finds the fastest tile size to draw a flock with.
+ *
+ * Draws on a surface of its own, like the screen: SDL_Flip() leaves
+ * anything but the screen alone, so nothing shows.
+ *
+ * @param pop		The flock to draw.
+ * @param atlas		Frames to draw the Boids with.
+ * @param screen	The screen.
+ * @param workers	The threads to draw on.
+ * @param settings	Tile size set to the fastest.
+ * @throws		std::runtime_error if there is no memory to draw in.
+ */
+static void tuneTiles(const vector<Boid>& pop, const SpriteAtlas& atlas, SDL_Surface* screen, WorkerPool& workers, TuningSettings& settings){
+	const unsigned int tileSizes[] = {16, 32, 64, 128, 256};
+	SDL_PixelFormat* format = screen->format;
+	SDL_Surface* canvas = SDL_CreateRGBSurface(SDL_SWSURFACE, screen->w, screen->h, 32, format->Rmask, format->Gmask, format->Bmask, format->Amask);
+	if(!canvas){
+		throw runtime_error("Unable to make a surface to time drawing on");
+	}
+
+	vector<unsigned char> tints;
+	double fastest = -1.0;
+	for(unsigned int s = 0; s < sizeof(tileSizes)/sizeof(tileSizes[0]); s++){
+		/* The first frame lays out the tiles, and is not timed.
+		 */
+		TileRenderer renderer(atlas, workers, tileSizes[s]);
+		renderer.draw(canvas, pop, 0, tints);
+		for(unsigned int i = 0; i < TIMED_FRAMES; i++){
+			chrono::steady_clock::time_point start = chrono::steady_clock::now();
+			renderer.draw(canvas, pop, 0, tints);
+			chrono::duration<double> frameTime = chrono::steady_clock::now() - start;
+			if(fastest < 0.0 || frameTime.count() < fastest){
+				fastest = frameTime.count();
+				settings.tileSize = tileSizes[s];
+			}
+		}
+	}
+
+	SDL_FreeSurface(canvas);
+}
+
+/**
+ * Finds the settings that run a flock fastest on this host.
+ *
+ * @param pop		The flock about to be run.
+ * @param edgeOfWorld	X and Y coordinates of the maximum extent of the
+ * 			simulated space.
+ * @param wrapped	true if the edges of the world wrap around.
+ * @param destination	Coordinates toward which the boids should head.
+ * @param quality	Perception cutoff and flockmate stride to use.
+ * @param atlas		Frames to draw the Boids with.
+ * @param screen	The screen.
+ * @param maxThreads	Most threads to try.
+ * @param settings	Set to the fastest settings.
+ * @throws		std::runtime_error if there is no memory to draw in.
+ */
+void autotune(const vector<Boid>& pop, const Point& edgeOfWorld, bool wrapped, const Point& destination, const QualitySettings& quality, const SpriteAtlas& atlas, SDL_Surface* screen, unsigned int maxThreads, TuningSettings& settings){
+	maxThreads = maxThreads > 1 ? maxThreads : 1;
+
+	/* Let the flock pull together (or apart) first, with all threads.
+	 */
+	vector<Boid> settled;
+	{
+		WorkerPool workers(maxThreads);
+		Simulation sim(pop, edgeOfWorld, wrapped, workers, 1);
+		for(unsigned int i = 0; i < SETTLE_STEPS; i++){
+			sim.step(destination, quality);
+		}
+		sim.getBoids(settled);
+	}
+
+	tuneSimulation(settled, edgeOfWorld, wrapped, destination, quality, maxThreads, settings);
+
+	WorkerPool workers(settings.threads);
+	tuneTiles(settled, atlas, screen, workers, settings);
+}
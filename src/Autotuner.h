@@ -0,0 +1,47 @@
+/**
+ * \file Autotuner.h
+ *
+ * Finds the thread count, strips and drawing tiles that run a flock fastest
+ * on this host, and remembers them. See implementation for more details.
+ *
+ * @since	2026-10-18
+ * @see		Autotuner.cpp
+ */
+
+/* Idempotency.
+ */
+#ifndef AUTOTUNER_H
+#define AUTOTUNER_H
+
+/**
+ * Includes.
+ */
+#include <vector>
+#include <string>
+#include <SDL/SDL.h>
+#include "QualityController.h"
+#include "SpriteAtlas.h"
+#include "Boid.h"
+
+/**
+ * Definitions.
+ */
+using namespace std;
+
+/**
+ * Settings that only change how fast a flock runs, not how it flies.
+ */
+struct TuningSettings {
+	unsigned int threads;		// Worker threads.
+	unsigned int stripsPerWorker;	// Strips of the world per worker.
+	unsigned int tileSize;		// Pixels along the side of a drawing tile.
+};
+
+string hostName();
+bool findTuning(const string& path, const string& host, const string& workload, TuningSettings& settings);
+void storeTuning(const string& path, const string& host, const string& workload, const TuningSettings& settings);
+void autotune(const vector<Boid>& pop, const Point& edgeOfWorld, bool wrapped, const Point& destination, const QualitySettings& quality, const SpriteAtlas& atlas, SDL_Surface* screen, unsigned int maxThreads, TuningSettings& settings);
+
+/* End idempotency.
+ */
+#endif
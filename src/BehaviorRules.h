@@ -0,0 +1,282 @@
+/**
+ * \file BehaviorRules.h
+ *
+ * Rules of Boid behavior, and the kernel that combines them.
+ *
+ * Each rule is a small struct that says what it makes of every flockmate
+ * (pair()) and what acceleration that adds up to for the Boid (finish()),
+ * and which coefficient scales it (coefficient()). A rule that only depends
+ * on the Boid itself, like drag, leaves pair() empty and sets perPair to
+ * false.
+ *
+ * fusedAcceleration() runs any number of rules over the flockmates in a
+ * single loop, working out the distance to each flockmate once for all of
+ * them. Since the rules are template parameters, every instantiation is
+ * compiled into one loop with all of the rules inlined. ruledAcceleration()
+ * picks the instantiation that leaves out the rules whose coefficient is
+ * zero, so rules that are switched off cost nothing either.
+ *
+ * A new behavior is a new struct here, added to the list of rules in
+ * Boid::compositeAcceleration(), and costs no extra pass over the flock.
+ *
+ * @since	2026-10-18
+ * @see		Boid.cpp
+ */
+
+/* Idempotency.
+ */
+#ifndef BEHAVIOR_RULES_H
+#define BEHAVIOR_RULES_H
+
+/**
+ * Includes.
+ */
+#include <cmath>
+#include <vector>
+#include "Boid.h"
+
+/**
+ * Definitions.
+ */
+#define PERCEPTION_FALL_OFF 2.75	// Compromise between light/sound propagation for water (fish, r^3) and air (birds, r^2)
+#define COLLISION_DIST 100.0		// 10 pixels per boid, so r = 10.0 gives you r^2 = 100 and unit acceleration
+#define DESTINATION_DECAY 0.1		// Smaller -> Boids see the destination when it's further away
+#define DRAG_COEFFICIENT 0.005
+
+using namespace std;
+
+/**
+ * Coefficients of all the rules of a Boid.
+ */
+struct RuleCoefficients {
+	float cohesion;
+	float separation;
+	float alignment;
+	float attraction;
+	float drag;
+};
+
+/**
+ * Where a flockmate is, as seen from the Boid: shared by all rules.
+ */
+struct PairGeometry {
+	double dx, dy;		// From the flockmate to the Boid.
+	float dist;
+	float perception;	// How well the flockmate can be made out.
+};
+
+/**
+ * Steer toward the centroid of the flockmates, weighted by how well each
+ * of them can be made out.
+ */
+struct CohesionRule {
+	static const bool perPair = true;
+	double sumX, sumY, total;
+
+	static float coefficient(const RuleCoefficients& c){ return c.cohesion; }
+	void begin(){ sumX = sumY = total = 0.0; }
+	void pair(const Boid& other, const PairGeometry& g){
+		Point p = other.getCoordinates();
+		sumX += g.perception*p.x;
+		sumY += g.perception*p.y;
+		total += g.perception;
+	}
+	Vector finish(const Boid& self, const Point&, unsigned int numOthers) const{
+		if(numOthers == 0){
+			return Vector(0.0, 0.0);
+		}
+		Point p = self.getCoordinates();
+		return Vector(sumX/total - p.x, sumY/total - p.y);
+	}
+};
+
+/**
+ * Steer away from every flockmate, in proportion to the inverse square of
+ * the distance to it.
+ */
+struct SeparationRule {
+	static const bool perPair = true;
+	double x, y;
+
+	static float coefficient(const RuleCoefficients& c){ return c.separation; }
+	void begin(){ x = y = 0.0; }
+	void pair(const Boid&, const PairGeometry& g){
+		/* Flockmates right on top of the Boid give no direction to
+		 * steer in.
+		 */
+		if(g.dist > 0.0){
+			double push = COLLISION_DIST/((double) g.dist*g.dist*g.dist);
+			x += push*g.dx;
+			y += push*g.dy;
+		}
+	}
+	Vector finish(const Boid&, const Point&, unsigned int) const{
+		return Vector(x, y);
+	}
+};
+
+/**
+ * Match the velocity of the flockmates, weighted by how well each of them
+ * can be made out.
+ */
+struct AlignmentRule {
+	static const bool perPair = true;
+	double sumX, sumY, total;
+
+	static float coefficient(const RuleCoefficients& c){ return c.alignment; }
+	void begin(){ sumX = sumY = total = 0.0; }
+	void pair(const Boid& other, const PairGeometry& g){
+		Vector v = other.getVelocity();
+		sumX += g.perception*v.x;
+		sumY += g.perception*v.y;
+		total += g.perception;
+	}
+	Vector finish(const Boid& self, const Point&, unsigned int numOthers) const{
+		if(numOthers == 0){
+			return Vector(0.0, 0.0);
+		}
+		Vector v = self.getVelocity();
+		return Vector(sumX/total - v.x, sumY/total - v.y);
+	}
+};
+
+/**
+ * Steer toward the destination, harder the closer it is.
+ */
+struct AttractionRule {
+	static const bool perPair = false;
+
+	static float coefficient(const RuleCoefficients& c){ return c.attraction; }
+	void begin(){}
+	void pair(const Boid&, const PairGeometry&){}
+	Vector finish(const Boid& self, const Point& destination, unsigned int) const{
+		Point p = self.getCoordinates();
+		double dx = p.x - destination.x, dy = p.y - destination.y;
+		double dist = sqrt(dx*dx + dy*dy);
+		if(dist == 0.0){
+			return Vector(0.0, 0.0);
+		}
+		double pull = 1.0/(1.0 + DESTINATION_DECAY*dist);
+		return Vector(-pull*dx/dist, -pull*dy/dist);
+	}
+};
+
+/**
+ * Stokes drag of the surrounding medium, F_d = -C_d*v, assuming laminar
+ * flow with a fairly low coefficient of drag.
+ */
+struct DragRule {
+	static const bool perPair = false;
+
+	static float coefficient(const RuleCoefficients& c){ return c.drag; }
+	void begin(){}
+	void pair(const Boid&, const PairGeometry&){}
+	Vector finish(const Boid& self, const Point&, unsigned int) const{
+		Vector v = self.getVelocity();
+		return Vector(-v.x, -v.y);
+	}
+};
+
+/**
+ * Whether any of a list of rules looks at the flockmates.
+ */
+template<class... Rules> struct AnyPerPair;
+template<> struct AnyPerPair<> {
+	static const bool value = false;
+};
+template<class First, class... Rest> struct AnyPerPair<First, Rest...> {
+	static const bool value = First::perPair || AnyPerPair<Rest...>::value;
+};
+
+/**
+ * All of a list of rules in one object, so that each can be reached by its
+ * type.
+ */
+template<class... Rules> struct RuleSet : Rules... {
+};
+
+/**
+ * Acceleration of a Boid due to a list of rules, in one pass over its
+ * flockmates.
+ *
+ * @param self		The Boid.
+ * @param otherBoids	The other boids with which it can interact.
+ * @param destination	Coordinates toward which the boid should head.
+ * @param coefficients	Coefficients of the rules.
+ * @return		Sum of the accelerations due to the rules, each scaled
+ * 			by its coefficient.
+ */
+template<class... Rules> Vector fusedAcceleration(const Boid& self, const vector<Boid>& otherBoids, const Point& destination, const RuleCoefficients& coefficients){
+	RuleSet<Rules...> rules;
+	int expand[] = {0, (static_cast<Rules&>(rules).begin(), 0)...};
+
+	if(AnyPerPair<Rules...>::value){
+		Point position = self.getCoordinates();
+		for(auto it = otherBoids.begin(); it != otherBoids.end(); it++){
+			Point other = it->getCoordinates();
+			PairGeometry g;
+			g.dx = position.x - other.x;
+			g.dy = position.y - other.y;
+			g.dist = sqrt(g.dx*g.dx + g.dy*g.dy);
+			float seen = 1.0/pow(g.dist, PERCEPTION_FALL_OFF);
+			g.perception = seen < 1.0 ? seen : 1.0;
+
+			int expandPair[] = {0, (static_cast<Rules&>(rules).pair(*it, g), 0)...};
+			(void) expandPair;
+		}
+	}
+
+	Vector acc(0.0, 0.0);
+	int expandFinish[] = {0, (acc += Rules::coefficient(coefficients)*static_cast<Rules&>(rules).finish(self, destination, otherBoids.size()), 0)...};
+	(void) rules;
+	(void) expand;
+	(void) expandFinish;
+
+	return acc;
+}
+
+/**
+ * List of rules, carrying nothing but its type.
+ */
+template<class... Rules> struct RuleList {
+};
+
+/**
+ * Picks the instantiation of fusedAcceleration() that leaves out the rules
+ * whose coefficient is zero.
+ *
+ * Chosen are the rules kept so far; the rules still to consider are passed
+ * as a RuleList.
+ */
+template<class... Chosen> struct RuleSelection {
+	static Vector select(RuleList<>, const Boid& self, const vector<Boid>& otherBoids, const Point& destination, const RuleCoefficients& coefficients){
+		return fusedAcceleration<Chosen...>(self, otherBoids, destination, coefficients);
+	}
+
+	template<class Next, class... Rest> static Vector select(RuleList<Next, Rest...>, const Boid& self, const vector<Boid>& otherBoids, const Point& destination, const RuleCoefficients& coefficients){
+		if(Next::coefficient(coefficients) != 0.0){
+			return RuleSelection<Chosen..., Next>::select(RuleList<Rest...>(), self, otherBoids, destination, coefficients);
+		}
+		return RuleSelection<Chosen...>::select(RuleList<Rest...>(), self, otherBoids, destination, coefficients);
+	}
+};
+
+/**
+ * Acceleration of a Boid due to a list of rules, leaving out the ones that
+ * are switched off.
+ *
+ * @param self		The Boid.
+ * @param otherBoids	The other boids with which it can interact.
+ * @param destination	Coordinates toward which the boid should head.
+ * @param coefficients	Coefficients of the rules; rules with a coefficient
+ * 			of zero are not evaluated at all.
+ * @return		Sum of the accelerations due to the rules, each scaled
+ * 			by its coefficient.
+ */
+template<class... Rules> Vector ruledAcceleration(const Boid& self, const vector<Boid>& otherBoids, const Point& destination, const RuleCoefficients& coefficients){
+	return RuleSelection<>::select(RuleList<Rules...>(), self, otherBoids, destination, coefficients);
+}
+
+/* End idempotency.
+ */
+#endif
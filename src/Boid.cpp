@@ -18,12 +18,13 @@
 /**
  * Includes.
  */
-#include "Boid.h"
 #include <cmath>
 #include <numeric>
 #include <iostream>
 #include <stdexcept>
 #include <utility>
+#include "Boid.h"
+#include "BehaviorRules.h"
 
 /** 
  * Definitions.
@@ -45,9 +46,11 @@
  * 				acceleration component.
  * @param edgeOfWorld		X and Y coordinates of the maximum extent of
  * 				the simulated space.
+ * @param identity		Number that tells the boid apart from the
+ * 				rest of its population.
  * @return			A fully specified object.
  */
-Boid::Boid(Point currentCoords, Vector velocityComponents, float cohesionStrength, float separationStrength, float alignmentStrength, float attractionStrength, Point edgeOfWorld){
+Boid::Boid(Point currentCoords, Vector velocityComponents, float cohesionStrength, float separationStrength, float alignmentStrength, float attractionStrength, Point edgeOfWorld, unsigned int identity){
 	coords = currentCoords;
 	velocity = velocityComponents;
 	cohesion = cohesionStrength;
@@ -55,6 +58,7 @@ Boid::Boid(Point currentCoords, Vector velocityComponents, float cohesionStrengt
 	alignment = alignmentStrength;
 	attraction = attractionStrength;
 	edges = edgeOfWorld;
+	id = identity;
 }
 
 /**
@@ -79,22 +83,16 @@ Boid::~Boid(){
  * @return		A new boid with the next position and velocity.
  * @throws		std::domain_error
  * @see			Boid::compositeAcceleration()
- * @see			Boid::stokesDrag()
  */
 Boid Boid::step(const vector<Boid>& otherBoids, const Point& destination) const{
 	Vector novelVelocity(velocity);
 	Point novelCoords(coords);
 
-	/* Get the total acceleration due to external factors.
+	/* Get the total acceleration due to external factors, viscous
+	 * damping included, and update the velocity.
 	 */
 	Vector acceleration = compositeAcceleration(otherBoids, destination);
-
-	/* Update the velocity.
-	 *
-	 * Subject to viscous damping.
-	 */
-	Vector drag = stokesDrag(this->velocity);
-	novelVelocity += acceleration + drag;
+	novelVelocity += acceleration;
 
  	/* New position due to velocity. For convenience, we'll use a time step 
 	 * of 1 here.
@@ -134,7 +132,7 @@ Boid Boid::step(const vector<Boid>& otherBoids, const Point& destination) const{
 		throw domain_error("Attempting to put Boid outside of the world!");
 	}
 
-	return Boid(novelCoords, novelVelocity, this->cohesion, this->separation, this->alignment, this->attraction, this->edges);
+	return Boid(novelCoords, novelVelocity, this->cohesion, this->separation, this->alignment, this->attraction, this->edges, this->id);
 }
 
 /**
@@ -153,22 +151,16 @@ Boid Boid::step(const vector<Boid>& otherBoids, const Point& destination) const{
  * @param maxY		Edge of the world in the Y direction.
  * @return		A new boid with the next position and velocity.
  * @see			Boid::compositeAcceleration()
- * @see			Boid::stokesDrag()
  */
 Boid Boid::wrappedStep(const vector<Boid>& otherBoids, const Point& destination, const int maxX, const int maxY) const{
 	Vector novelVelocity(velocity);
 	Point novelCoords(coords);
 
-	/* Get the total acceleration due to external factors.
+	/* Get the total acceleration due to external factors, viscous
+	 * damping included, and update the velocity.
 	 */
 	Vector acceleration = compositeAcceleration(otherBoids, destination);
-
-	/* Update the velocity.
-	 *
-	 * Subject to viscous damping.
-	 */
-	Vector drag = stokesDrag(this->velocity);
-	novelVelocity += acceleration + drag;
+	novelVelocity += acceleration;
 
 	/* New position due to velocity. For convenience, we'll
 	 * use a time step of 1 here.
@@ -193,7 +185,21 @@ Boid Boid::wrappedStep(const vector<Boid>& otherBoids, const Point& destination,
 		novelCoords.y += maxY;
 	}
 
-	return Boid(novelCoords, novelVelocity, this->cohesion, this->separation, this->alignment, this->attraction, this->edges);
+	return Boid(novelCoords, novelVelocity, this->cohesion, this->separation, this->alignment, this->attraction, this->edges, this->id);
+}
+
+/**
+ * Copy of the boid that has been moved somewhere else.
+ *
+ * Keeps the behavior of the boid, but not its position, motion or identity.
+ *
+ * @param newCoords	Location of the copy.
+ * @param newVelocity	Velocity of the copy.
+ * @param identity	Identity of the copy.
+ * @return		A new boid at the given position.
+ */
+Boid Boid::placedAt(const Point& newCoords, const Vector& newVelocity, unsigned int identity) const{
+	return Boid(newCoords, newVelocity, this->cohesion, this->separation, this->alignment, this->attraction, this->edges, identity);
 }
 
 /**
@@ -215,277 +221,46 @@ Vector Boid::getVelocity() const{
 }
 
 /**
- * Calculates the overall acceleration vector acting on the boid.
- *
- * Sums up all the various accelerations the Boid is subject to due to
- * interaction with the world and other Boids.
- *
- * @param otherBoids	The other boids with which it can interact.
- * @param destination	Coordinates toward which the boid should head.
- * @return		Acceleration vector acting on the boid.
- * @see			Boid::accelCohesion()
- * @see			Boid::accelSeparation()
- * @see			Boid::accelAlignment()
- * @see			Boid::accelToward()
- */
-Vector Boid::compositeAcceleration(const vector<Boid>& otherBoids, const Point& destination) const{
-	Vector totAcc(0.0, 0.0);
-
-	/* Accelerate toward the other Boids.
-	 */
-	Vector dueToCohesion = accelCohesion(otherBoids);
-	totAcc += cohesion*dueToCohesion;
-
-	/* And away from other Boids, too.
-	 */
-	Vector dueToSep = accelSeparation(otherBoids);
-	totAcc += separation*dueToSep;
-
-	/* While trying to match speeds with them.
-	 */
-	Vector dueToAlign = accelAlignment(otherBoids);
-	totAcc += alignment*dueToAlign;
-
-	/* And heading toward some position.
-	 */
-	Vector dueToAttraction = accelToward(destination);
-	totAcc += attraction*dueToAttraction;
-
-	return totAcc;
-}
-	
-/**
- * Acceleration due to tendency to stick to other boids in the flock.
- *
- * Accelerates the Boid toward the geometric centroid of the others of its
- * kind. Rate of acceleration determined by a 'perception' parameter, and
- * direction by which Boids are close enough to "see".
+ * Getter for the identity.
  *
- * @param otherBoids	The other boids with which it can interact.
- * @return		Acceleration vector due to flock cohesion.
+ * @return	The number that tells the boid apart from the rest.
  */
-Vector Boid::accelCohesion(const vector<Boid>& otherBoids) const{
-	Vector acc(0.0, 0.0);
-	Vector xBasisVector(1.0, 0.0);
-	Vector yBasisVector(0.0, 1.0);
-	Point centroid(0.0, 0.0);
-
-	/* Check where all the other Boids are, and find
-	 * the centroid of their positions. However, weight the
-	 * calculation of the centroid by a rapidly decreasing
-	 * factor based on distance (can't perceive very far-away
-	 * flockmates that well).
-	 */
-	float dist, percepFactor;
-	float percepTotal = 0.0;
-	for(auto it = otherBoids.begin(); it != otherBoids.end(); it++){
-		dist = d(coords, it->getCoordinates());
-		double fallOff = 2.75; // Compromise between light/sound propagation for water (fish, r^3) and air (birds, r^2) 
-		percepFactor = min(1.0, 1.0/pow(dist,fallOff));
-
-		Point scaledOther = percepFactor * it->getCoordinates();
-		centroid = centroid + scaledOther;
-		percepTotal += percepFactor;
-	}
-	centroid = centroid / percepTotal;
-
-	/* Now head toward that centroid (biased toward nearby
-	 * flockmates).
-	 *
-	 * This math should probably be abstracted quite a bit...
-	 * a ProjectOnto() function or something?
-	 */
-	Point position(coords);
-        Point diff = position - centroid;
-	Vector sepVector(diff.x,diff.y);
-	float norm = sepVector.len();
-	sepVector.normalize();
-	xBasisVector.normalize();
-	yBasisVector.normalize();
-	float theta_x = acos(xBasisVector * sepVector);
-	float theta_y = acos(yBasisVector * sepVector);
-
-	acc.x -= norm*cos(theta_x);
-	acc.y -= norm*cos(theta_y);
-
-	return acc;
+unsigned int Boid::getId() const{
+	return id;
 }
 
 /**
- * Acceleration due to tendency to not collide with other boids in the flock.
+ * Calculates the overall acceleration vector acting on the boid.
  *
- * In practice, accelerate away from every other Boid in the flock that
- * can be perceived. Degree of perception scales inversely with distance.
+ * Sums up all the various accelerations the Boid is subject to due to
+ * interaction with the world and other Boids: accelerate toward the other
+ * Boids, and away from them too, while trying to match speeds with them and
+ * heading toward some position, all subject to viscous damping. The rules
+ * share a single pass over the other Boids, and rules whose coefficient is
+ * zero are left out.
  *
  * @param otherBoids	The other boids with which it can interact.
- * @return		Acceleration vector due to boid-boid separation.
+ * @param destination	Coordinates toward which the boid should head.
+ * @return		Acceleration vector acting on the boid.
+ * @see			BehaviorRules.h
  */
-Vector Boid::accelSeparation(const vector<Boid>& otherBoids) const{
-	Vector acc(0.0, 0.0);
-	Vector xBasisVector(1.0, 0.0);
-	Vector yBasisVector(0.0, 1.0);
-
-	/* Check where the other Boids are, and avoid them
-	 * proportional to the inverse square of their distance:
-	 * can't see distant Boids very well, but want to stay
-	 * the hell away from really close ones.
-	 *
-	 * Math here should be simplified with a projection
-	 * method, or something.
-	 */
-	float dist;
-	for(auto it = otherBoids.begin(); it != otherBoids.end(); it++){
-		Point position(coords);
-		Point diff = position - it->getCoordinates();
-		Vector sepVector(diff.x,diff.y);
-		dist = sepVector.len();
-		sepVector.normalize();
-		xBasisVector.normalize();
-		yBasisVector.normalize();
-		float theta_x = acos(xBasisVector * sepVector);
-		float theta_y = acos(yBasisVector * sepVector);
-		
-		double collision_dist = 100.0; // 10 pixels per boid, so r = 10.0 gives you r^2 = 100 and unit acceleration
-		acc.x += (collision_dist/pow(dist,2))*cos(theta_x);
-		acc.y += (collision_dist/pow(dist,2))*cos(theta_y);
-	}
+Vector Boid::compositeAcceleration(const vector<Boid>& otherBoids, const Point& destination) const{
+	RuleCoefficients coefficients = {cohesion, separation, alignment, attraction, DRAG_COEFFICIENT};
 
-	return acc;
+	return ruledAcceleration<CohesionRule, SeparationRule, AlignmentRule, AttractionRule, DragRule>(*this, otherBoids, destination, coefficients);
 }
 
 /**
- * Acceleration due to tendency to move in the same direction as other boids
- * in the flock.
- *
- * In practice, try to match the velocity vector of nearby "perceivable"
- * boids. Ability to perceive other boids scales inversely with distance
- * to them.
+ * Calculates the acceleration the boid steers itself with, i.e. everything
+ * but the viscous damping, which is left to whoever integrates the motion.
  *
  * @param otherBoids	The other boids with which it can interact.
- * @return		Acceleration vector due to flock velocity alignment.
- */
-Vector Boid::accelAlignment(const vector<Boid>& otherBoids) const{
-	Vector acc(0.0, 0.0);
-	Vector xBasisVector(1.0, 0.0);
-	Vector yBasisVector(0.0, 1.0);
-	Vector commonVeloc(0.0, 0.0);
-
-	/* Check where all the other Boids are, and find
-	 * their average velocity. However, weight the
-	 * calculation of the velocity by a rapidly decreasing
-	 * factor based on distance (can't perceive very far-away
-	 * flockmates that well).
-	 */
-	float dist, percepFactor;
-	float percepTotal = 0.0;
-	for(auto it = otherBoids.begin(); it != otherBoids.end(); it++){
-		dist = d(coords, it->getCoordinates());
-		double fallOff = 2.75; // Compromise between light/sound propagation for water (fish, r^3) and air (birds, r^2) 
-		percepFactor = min(1.0, 1.0/pow(dist,fallOff));
-
-		commonVeloc += percepFactor * it->getVelocity();
-		percepTotal += percepFactor;
-	}
-	commonVeloc /= percepTotal;
-
-	/* Now head in the direction of that velocity vector (biased toward 
-	 * nearby flockmates), attempting to match speeds as well.
-	 */
-	Vector temp(velocity);
-	Vector velocDiff = temp - commonVeloc;
-	acc -= velocDiff;
-
-	return acc;
-}
-
-/**
- * Acceleration due to tendency to move toward a particular goal.
- *
- * In practice, accelerate toward these particular coordinates, but with
- * a magnitude inversely proportional to the distance from them.
- *
- * @param coordinates	The point toward which boids should move.
- * @return		Acceleration vector due to goal seeking.
- */
-Vector Boid::accelToward(const Point& coordinates) const{
-	Vector acc(0.0, 0.0);
-	Vector xBasisVector(1.0, 0.0);
-	Vector yBasisVector(0.0, 1.0);
-	Point destination(coordinates);
-
-	/* Now head toward that point, acceleration inversely
-	 * proportional to distance.
-	 *
-	 * This math should probably be abstracted quite a bit...
-	 * a ProjectOnto() function or something?
-	 */
-	Point position(coords);
-        Point diff = position - destination;
-	Vector sepVector(diff.x,diff.y);
-	double percepDecay = 0.1; // Smaller -> Boids see the destination when it's further away
-	float norm = 1.0 / (1.0 + percepDecay*sepVector.len());
-	sepVector.normalize();
-	xBasisVector.normalize();
-	yBasisVector.normalize();
-	float theta_x = acos(xBasisVector * sepVector);
-	float theta_y = acos(yBasisVector * sepVector);
-
-	acc.x -= norm*cos(theta_x);
-	acc.y -= norm*cos(theta_y);
-
-	return acc;
-}
-
-/**
- * Function to calculate the force vector of the Stokes drag due to
- * the surrounding medium.
- *
- * Drag force is
- *
- * F_d = -C_d*v
- *
- * where C_d is a coefficient of drag incorporating medium density and
- * object characterstic length scale (usually cross-sectional area
- * in the direction of travel), and v is the velocity vector.
- *
- * Note that the force is opposite to the direction of travel, and
- * that we assume laminar flow (turbulent flow would result in
- * Newton drag) with fairly low coefficient of drag.
- *
- * @param currentVelocity	The current velocity of a boid.
- * @return			The force vector of drag.
+ * @param destination	Coordinates toward which the boid should head.
+ * @return		Acceleration vector the boid steers itself with.
+ * @see			Integrator.cpp
  */
-Vector Boid::stokesDrag(Vector currentVelocity) const{
-	Vector force(0.0, 0.0);
-	Vector zero(0.0,0.0);
-
-	/* If there's no movement, there should be no drag.
-	 */
-	if(currentVelocity == zero){
-		return force;
-	}
-
-	/* Drag is directly proportional to the norm of the
-	 * vector.
-	 */
-	float dragCoefficient = 0.005;
-	float norm = currentVelocity.len();
-	float drag = -1.0*dragCoefficient*norm;
-
-	/* Project the total drag onto the X and Y axis.
-	 */
-	Vector xBasisVector(1.0, 0.0);
-	Vector yBasisVector(0.0, 1.0);
-	Vector velocVector = currentVelocity;
-	velocVector.normalize();
-	xBasisVector.normalize();
-	yBasisVector.normalize();
-
-	float theta_x = acos(xBasisVector * velocVector);
-	float theta_y = acos(yBasisVector * velocVector);
-
-	force.x = drag*cos(theta_x);
-	force.y = drag*cos(theta_y);
+Vector Boid::steeringAcceleration(const vector<Boid>& otherBoids, const Point& destination) const{
+	RuleCoefficients coefficients = {cohesion, separation, alignment, attraction, 0.0};
 
-	return force;
+	return ruledAcceleration<CohesionRule, SeparationRule, AlignmentRule, AttractionRule>(*this, otherBoids, destination, coefficients);
 }
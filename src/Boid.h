@@ -25,23 +25,19 @@ using namespace std;
 
 class Boid {
 	public:
-		Boid(Point currentCoords, Vector velocity, float cohesionStrength, float separationStrength, float alignmentStrength, float attractionStrength, Point edgeOfWorld);
+		Boid(Point currentCoords, Vector velocity, float cohesionStrength, float separationStrength, float alignmentStrength, float attractionStrength, Point edgeOfWorld, unsigned int identity);
 		~Boid();
 
 		Boid step(const vector<Boid>& otherBoids, const Point& destination) const;
 		Boid wrappedStep(const vector<Boid>& otherBoids, const Point& destination, const int maxX, const int maxY) const;
+		Boid placedAt(const Point& newCoords, const Vector& newVelocity, unsigned int identity) const;
+		Vector steeringAcceleration(const vector<Boid>& otherBoids, const Point& destination) const;
 		Point getCoordinates() const;
 		Vector getVelocity() const;
+		unsigned int getId() const;
 
 	protected:
 		Vector compositeAcceleration(const vector<Boid>& otherBoids, const Point& destination) const;
-
-		Vector accelCohesion(const vector<Boid>& otherBoids) const;
-		Vector accelSeparation(const vector<Boid>& otherBoids) const;
-		Vector accelAlignment(const vector<Boid>& otherBoids) const;
-		Vector accelToward(const Point& coordinates) const;
-
-		Vector stokesDrag(Vector currentVelocity) const;
 		Vector dampenMotion(Vector currentChangeVector, float maxChangeRate) const;
 
 		/* Properties.
@@ -53,6 +49,7 @@ class Boid {
 		float alignment;
 		float attraction;
 		Point edges;
+		unsigned int id;
 };
 
 /* End idempotency.
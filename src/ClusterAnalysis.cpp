@@ -0,0 +1,222 @@
+/**
+ * \file	ClusterAnalysis.cpp
+ *
+ * Finds the sub-flocks (clusters) a population has broken up into.
+ *
+ * Two Boids belong to the same cluster if they are linked by a chain of
+ * Boids, each within the link radius of the next. The pairs within the link
+ * radius are found with a spatial grid, and merged into clusters with a
+ * lock-free union-find: every Boid points at a parent, the root of a tree is
+ * its cluster, and two trees are merged by swinging the larger root over to
+ * the smaller one with a compare-and-swap. Workers process disjoint ranges
+ * of grid cells at the same time, so the whole analysis costs O(N a(N)) work
+ * spread over the pool.
+ *
+ * @since	2026-10-18
+ */
+
+/**
+ * Includes.
+ */
+#include <algorithm>
+#include <functional>
+#include "ClusterAnalysis.h"
+
+/**
+ * Constructor from values.
+ *
+ * @param edgeOfWorld	X and Y coordinates of the maximum extent of the
+ * 			simulated space.
+ * @param linkRadius	Boids closer than this belong to the same cluster.
+ * @param workers	The threads to run the analysis on. Must outlive
+ * 			the analysis.
+ * @return		A fully specified object.
+ */
+ClusterAnalysis::ClusterAnalysis(Point edgeOfWorld, float linkRadius, WorkerPool& workers) : pool(workers), grid(edgeOfWorld, linkRadius){
+	radius = linkRadius;
+	parents = NULL;
+	capacity = 0;
+}
+
+/**
+ * Destructor.
+ */
+ClusterAnalysis::~ClusterAnalysis(){
+	delete[] parents;
+}
+
+/**
+ * Finds the clusters of a population.
+ *
+ * @param pop	The population.
+ */
+void ClusterAnalysis::analyze(const vector<Boid>& pop){
+	unsigned int numBoids = pop.size();
+	if(numBoids > capacity){
+		delete[] parents;
+		capacity = numBoids;
+		parents = new atomic<unsigned int>[capacity];
+	}
+
+	grid.build(pop);
+	roots.resize(numBoids);
+
+	/* Everybody starts out as a cluster of their own, then gets linked
+	 * to everyone within reach. Workers take interleaved blocks of rows,
+	 * which spreads out dense areas of the world.
+	 */
+	unsigned int numWorkers = pool.size();
+	unsigned int numCells = grid.numCells();
+	unsigned int blockSize = grid.getColumns();
+	pool.run([&](unsigned int w){
+		for(unsigned int i = w; i < numBoids; i += numWorkers){
+			parents[i].store(i, memory_order_relaxed);
+		}
+	});
+	pool.run([&](unsigned int w){
+		auto link = [this](unsigned int i, unsigned int j, float){ unite(i, j); };
+		for(unsigned int first = w*blockSize; first < numCells; first += numWorkers*blockSize){
+			unsigned int last = first + blockSize < numCells ? first + blockSize : numCells;
+			grid.forEachPair(first, last, radius, link);
+		}
+	});
+	pool.run([&](unsigned int w){
+		for(unsigned int i = w; i < numBoids; i += numWorkers){
+			roots[i] = find(i);
+		}
+	});
+
+	/* Tally up the cluster sizes.
+	 */
+	vector<unsigned int> counts(numBoids, 0);
+	for(unsigned int i = 0; i < numBoids; i++){
+		counts[roots[i]]++;
+	}
+	sizes.clear();
+	for(unsigned int i = 0; i < numBoids; i++){
+		if(counts[i] > 0){
+			sizes.push_back(counts[i]);
+		}
+	}
+	sort(sizes.begin(), sizes.end(), greater<unsigned int>());
+}
+
+/**
+ * Getter for the number of clusters found by the last analysis.
+ *
+ * @return	The number of clusters.
+ */
+unsigned int ClusterAnalysis::getNumClusters() const{
+	return sizes.size();
+}
+
+/**
+ * Getter for the sizes of the clusters found by the last analysis.
+ *
+ * @return	Number of Boids in each cluster, largest cluster first.
+ */
+const vector<unsigned int>& ClusterAnalysis::getClusterSizes() const{
+	return sizes;
+}
+
+/**
+ * Getter for the clusters of the Boids in the last analysis.
+ *
+ * @return	For every Boid, the index of the first Boid of its cluster in
+ * 		the population that was analyzed.
+ */
+const vector<unsigned int>& ClusterAnalysis::getRoots() const{
+	return roots;
+}
+
+/**
+ * Writes a one-line summary of the last analysis.
+ *
+ * The size distribution is given in bins of doubling width, as
+ * "smallest-largest:number of clusters".
+ *
+ * @param out	Stream to write to.
+ * @param frame	Frame the analysis was made on.
+ */
+void ClusterAnalysis::report(ostream& out, unsigned long frame) const{
+	out << "clusters: frame " << frame << ", " << sizes.size() << " clusters";
+	if(sizes.empty()){
+		out << endl;
+		return;
+	}
+
+	out << ", largest " << sizes.front() << ", sizes";
+	unsigned int binStart = 1;
+	unsigned int i = sizes.size();
+	while(i > 0){
+		unsigned int binEnd = 2*binStart - 1;
+		unsigned int count = 0;
+		while(i > 0 && sizes[i-1] <= binEnd){
+			count++;
+			i--;
+		}
+		out << " " << binStart;
+		if(binEnd > binStart){
+			out << "-" << binEnd;
+		}
+		out << ":" << count;
+		binStart *= 2;
+	}
+	out << endl;
+}
+
+/**
+ * Finds the cluster of a Boid, halving the path to it along the way.
+ *
+ * Safe to call while other threads are merging clusters.
+ *
+ * @param boid	Index of the Boid.
+ * @return	Index of the root Boid of its cluster.
+ */
+unsigned int ClusterAnalysis::find(unsigned int boid){
+	unsigned int parent = parents[boid].load(memory_order_relaxed);
+	while(parent != boid){
+		/* Point at the grandparent instead. If somebody else got
+		 * there first, that's fine: the tree only ever gets
+		 * flatter.
+		 */
+		unsigned int grandparent = parents[parent].load(memory_order_relaxed);
+		parents[boid].compare_exchange_weak(parent, grandparent, memory_order_relaxed);
+		boid = parent;
+		parent = parents[boid].load(memory_order_relaxed);
+	}
+
+	return boid;
+}
+
+/**
+ * Merges the clusters of two Boids.
+ *
+ * The root with the larger index is made to point at the other one, so
+ * that no cycles can form even when several threads merge at once.
+ *
+ * @param first		Index of one Boid.
+ * @param second	Index of the other.
+ */
+void ClusterAnalysis::unite(unsigned int first, unsigned int second){
+	while(true){
+		unsigned int a = find(first);
+		unsigned int b = find(second);
+		if(a == b){
+			return;
+		}
+		if(a < b){
+			unsigned int swapped = a;
+			a = b;
+			b = swapped;
+		}
+
+		/* Fails if a stopped being a root in the meantime; then just
+		 * try again from the top.
+		 */
+		unsigned int expected = a;
+		if(parents[a].compare_exchange_strong(expected, b, memory_order_relaxed)){
+			return;
+		}
+	}
+}
@@ -0,0 +1,62 @@
+/**
+ * \file ClusterAnalysis.h
+ *
+ * Finds the sub-flocks a population has broken up into. See implementation
+ * for more details.
+ *
+ * @since	2026-10-18
+ * @see		ClusterAnalysis.cpp
+ */
+
+/* Idempotency.
+ */
+#ifndef CLUSTER_ANALYSIS_H
+#define CLUSTER_ANALYSIS_H
+
+/**
+ * Includes.
+ */
+#include <vector>
+#include <atomic>
+#include <ostream>
+#include "WorkerPool.h"
+#include "SpatialGrid.h"
+
+/**
+ * Definitions.
+ */
+using namespace std;
+
+class ClusterAnalysis {
+	public:
+		ClusterAnalysis(Point edgeOfWorld, float linkRadius, WorkerPool& workers);
+		~ClusterAnalysis();
+
+		void analyze(const vector<Boid>& pop);
+		unsigned int getNumClusters() const;
+		const vector<unsigned int>& getClusterSizes() const;
+		const vector<unsigned int>& getRoots() const;
+		void report(ostream& out, unsigned long frame) const;
+
+	protected:
+		unsigned int find(unsigned int boid);
+		void unite(unsigned int first, unsigned int second);
+
+		/* Properties.
+		 */
+		WorkerPool& pool;
+		SpatialGrid grid;
+		float radius;
+		atomic<unsigned int>* parents;	// Union-find forest over the population.
+		unsigned int capacity;
+		vector<unsigned int> roots;
+		vector<unsigned int> sizes;	// Cluster sizes, largest first.
+
+	private:
+		ClusterAnalysis(const ClusterAnalysis&);
+		ClusterAnalysis& operator=(const ClusterAnalysis&);
+};
+
+/* End idempotency.
+ */
+#endif
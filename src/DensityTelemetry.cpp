@@ -0,0 +1,164 @@
+/**
+ * \file	DensityTelemetry.cpp
+ *
+ * Explains slow frames. The time a step takes comes down to how many pairs
+ * of Boids are looked at and how many of them interact, which the
+ * simulation counts while advancing the Boids (see Observables.cpp), and
+ * those depend on how crowded the flock is. This sorts the population into
+ * a grid of square cells and reports, every so often, the work of the step
+ * next to how full the cells are: a histogram of the number of Boids per
+ * cell, the fullest cell and where the fullest cells (the hotspots) are.
+ * The cell counts can also be drawn under the Boids as a heatmap.
+ *
+ * A cell about the size of the perception cutoff shows how many flockmates
+ * a Boid in a hotspot has to deal with.
+ *
+ * @since	2026-10-18
+ */
+
+/**
+ * Includes.
+ */
+#include <algorithm>
+#include "DensityTelemetry.h"
+
+/**
+ * Constructor from values.
+ *
+ * @param edgeOfWorld	X and Y coordinates of the maximum extent of the
+ * 			simulated space.
+ * @param cellSize	Width and height of a cell.
+ * @param numHotspots	Number of the fullest cells to report.
+ * @return		A fully specified object.
+ */
+DensityTelemetry::DensityTelemetry(Point edgeOfWorld, float cellSize, unsigned int numHotspots) : grid(edgeOfWorld, cellSize){
+	hotspotCount = numHotspots;
+}
+
+/**
+ * Default destructor.
+ */
+DensityTelemetry::~DensityTelemetry(){
+}
+
+/**
+ * Counts the Boids in every cell.
+ *
+ * @param pop	The population.
+ */
+void DensityTelemetry::analyze(const vector<Boid>& pop){
+	grid.build(pop);
+
+	/* Bin the cells by how many Boids they hold: 0, 1, 2-3, 4-7 and so
+	 * on.
+	 */
+	histogram.assign(1, 0);
+	for(unsigned int cell = 0; cell < grid.numCells(); cell++){
+		unsigned int bin = 0;
+		for(unsigned int occupants = grid.cellSize(cell); occupants > 0; occupants /= 2){
+			bin++;
+		}
+		if(bin >= histogram.size()){
+			histogram.resize(bin + 1, 0);
+		}
+		histogram[bin]++;
+	}
+
+	/* The fullest cells come first; ties go to the first cell.
+	 */
+	unsigned int numHotspots = hotspotCount < grid.numCells() ? hotspotCount : grid.numCells();
+	vector<unsigned int> cells(grid.numCells());
+	for(unsigned int cell = 0; cell < cells.size(); cell++){
+		cells[cell] = cell;
+	}
+	partial_sort(cells.begin(), cells.begin() + numHotspots, cells.end(), [&](unsigned int a, unsigned int b){
+		return grid.cellSize(a) > grid.cellSize(b) || (grid.cellSize(a) == grid.cellSize(b) && a < b);
+	});
+	hotspots.assign(cells.begin(), cells.begin() + numHotspots);
+}
+
+/**
+ * Getter for the occupancy of the fullest cell.
+ *
+ * @return	Number of Boids in it, as of the last analysis.
+ */
+unsigned int DensityTelemetry::getMaxOccupancy() const{
+	return hotspots.empty() ? 0 : grid.cellSize(hotspots.front());
+}
+
+/**
+ * Getter for the fullest cells.
+ *
+ * @return	Indices of the fullest cells, as of the last analysis, the
+ * 		fullest first. Cells go row by row.
+ */
+const vector<unsigned int>& DensityTelemetry::getHotspots() const{
+	return hotspots;
+}
+
+/**
+ * How crowded every cell is, for drawing.
+ *
+ * @param saturation	Number of Boids at which a cell counts as full.
+ * @param heat		Filled with a value from 0 (empty) to 1 (full) per
+ * 			cell, row by row.
+ */
+void DensityTelemetry::getHeat(unsigned int saturation, vector<float>& heat) const{
+	float full = saturation > 0 ? saturation : 1;
+	heat.resize(grid.numCells());
+	for(unsigned int cell = 0; cell < grid.numCells(); cell++){
+		float occupants = grid.cellSize(cell);
+		heat[cell] = occupants < full ? occupants/full : 1.0;
+	}
+}
+
+/**
+ * Getter for the number of columns of cells.
+ *
+ * @return	Number of cells along the X axis.
+ */
+unsigned int DensityTelemetry::getColumns() const{
+	return grid.getColumns();
+}
+
+/**
+ * Getter for the size of a cell.
+ *
+ * @return	Width and height of a cell.
+ */
+float DensityTelemetry::getCellSize() const{
+	return grid.getCellSize();
+}
+
+/**
+ * Writes a one-line summary of the work of a step and the last analysis.
+ *
+ * @param out	Stream to write to.
+ * @param frame	Frame number to label the summary with.
+ * @param work	Order parameters of the step, which count the pairs it
+ * 		looked at and that interacted.
+ */
+void DensityTelemetry::report(ostream& out, unsigned long frame, const Observables& work) const{
+	out << "density: frame " << frame << ", " << work.pairTests << " pair tests, " << work.interactions << " interactions";
+	out << ", largest cell " << getMaxOccupancy() << ", cells";
+	for(unsigned int bin = 0; bin < histogram.size(); bin++){
+		unsigned int binStart = bin > 0 ? 1 << (bin - 1) : 0;
+		unsigned int binEnd = bin > 0 ? 2*binStart - 1 : 0;
+		out << " " << binStart;
+		if(binEnd > binStart){
+			out << "-" << binEnd;
+		}
+		out << ":" << histogram[bin];
+	}
+
+	/* Hotspots by the middle of their cell.
+	 */
+	out << ", hotspots";
+	float size = grid.getCellSize();
+	for(unsigned int h = 0; h < hotspots.size(); h++){
+		unsigned int column = hotspots[h] % grid.getColumns();
+		unsigned int row = hotspots[h] / grid.getColumns();
+		out << " " << (column + 0.5)*size << "," << (row + 0.5)*size << ":" << grid.cellSize(hotspots[h]);
+	}
+	out << endl;
+}
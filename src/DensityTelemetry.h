@@ -0,0 +1,57 @@
+/**
+ * \file DensityTelemetry.h
+ *
+ * Where the Boids crowd together, and how much work that makes. See
+ * implementation for more details.
+ *
+ * @since	2026-10-18
+ * @see		DensityTelemetry.cpp
+ */
+
+/* Idempotency.
+ */
+#ifndef DENSITY_TELEMETRY_H
+#define DENSITY_TELEMETRY_H
+
+/**
+ * Includes.
+ */
+#include <vector>
+#include <ostream>
+#include "SpatialGrid.h"
+#include "Observables.h"
+
+/**
+ * Definitions.
+ */
+using namespace std;
+
+class DensityTelemetry {
+	public:
+		DensityTelemetry(Point edgeOfWorld, float cellSize, unsigned int numHotspots);
+		~DensityTelemetry();
+
+		void analyze(const vector<Boid>& pop);
+		unsigned int getMaxOccupancy() const;
+		const vector<unsigned int>& getHotspots() const;
+		void getHeat(unsigned int saturation, vector<float>& heat) const;
+		unsigned int getColumns() const;
+		float getCellSize() const;
+		void report(ostream& out, unsigned long frame, const Observables& work) const;
+
+	protected:
+		/* Properties.
+		 */
+		SpatialGrid grid;
+		unsigned int hotspotCount;
+		vector<unsigned int> hotspots;	// Most crowded cells, most crowded first.
+		vector<unsigned int> histogram;	// Cells with 0, 1, 2-3, 4-7, ... Boids.
+
+	private:
+		DensityTelemetry(const DensityTelemetry&);
+		DensityTelemetry& operator=(const DensityTelemetry&);
+};
+
+/* End idempotency.
+ */
+#endif
@@ -0,0 +1,560 @@
+/**
+ * \file	DeterministicFlock.cpp
+ *
+ * Flock in fixed-point arithmetic, for runs that come out the same to the bit
+ * on any machine, e.g. to compare runs between clusters or to replay one on a
+ * laptop. The floating-point engines can't promise that: the compiler may
+ * fuse multiplies and adds on one target and not on another, libm differs
+ * from one system to the next, and sums over threads come out in whatever
+ * order the work was split.
+ *
+ * Positions and velocities are 32-bit integers, in 1/65536 of a pixel, and
+ * every step is integer arithmetic only:
+ *
+ * - Offsets between Boids are taken in 1/16 of a pixel, so that their
+ *   squares add up within 32 bits. Working them out is a loop of plain
+ *   32-bit integer arithmetic over the flockmates in reach, with no branches,
+ *   which the compiler vectorizes (this file is built with VFLAGS, see the
+ *   Makefile).
+ * - The perception 1/r^2.75 and the separation push COLLISION_DIST/r^3 are
+ *   read off tables by the squared distance, 64 steps per octave, so no
+ *   pow() or sqrt() is needed per pair. The tables are made once, from
+ *   multiplies, divides and square roots alone, which IEEE 754 rounds the
+ *   same everywhere (the file is built without contraction into fused
+ *   multiply-adds for this).
+ * - The rules of BehaviorRules.h then sum up integers in 64 bits, which
+ *   gives the same sums in any order. So the flock is stepped on all of the
+ *   workers, and the results depend on neither their number nor the order
+ *   they finish in.
+ * - Coefficients and the drag are in 1/2^24, and the few divisions per Boid
+ *   are done in 128 bits. Right shifts of negative numbers are arithmetic,
+ *   as with GCC and Clang on every target.
+ * - Escaped Boids are respawned from a random generator of this file's own,
+ *   not the C library's.
+ *
+ * The state is kept sorted by X coordinate, so that the flockmates in reach
+ * of a Boid are a run of neighboring slots, found with two moving bounds.
+ * Nothing farther than SIGHT_MAX is in sight, whatever the cutoff. The world
+ * is walled, and at most DETERMINISTIC_WORLD_MAX pixels on a side.
+ *
+ * The tables and the rounding make it a slightly different flock from the
+ * floating-point one: it takes the same course at first and drifts apart as
+ * flocks do. Order parameters are summed up in floating point from the
+ * fixed-point state, and are only meant for watching.
+ *
+ * @since	2026-10-18
+ */
+
+/**
+ * Includes.
+ */
+#include <algorithm>
+#include <stdexcept>
+#include <math.h>
+#include "DeterministicFlock.h"
+
+/**
+ * Definitions.
+ */
+#define FIXED_SHIFT 16		// Fraction bits of positions and velocities
+#define COEFFICIENT_SHIFT 24	// Fraction bits of coefficients and the drag
+#define OFFSET_SHIFT 12		// Offsets between Boids are in 1/16 of a pixel
+#define OFFSET_LIMIT 32767	// and clamped to 16 bits
+#define VELOCITY_SHIFT 4	// Velocities of flockmates are compared in 1/4096 of a pixel per step
+#define PERCEPTION_SHIFT 32	// Fraction bits of the perception table
+#define SEPARATION_SHIFT 30	// Fraction bits of the separation table
+#define TABLE_BITS 6		// Table steps per octave of the squared distance: 2^TABLE_BITS
+#define TABLE_STEPS (1 << TABLE_BITS)
+#define SIGHT_MAX 2047		// Farthest a flockmate can be seen from, in pixels
+#define SPEED_MAX (1 << 30)	// Fastest a Boid flies, in 1/65536 of a pixel per step
+
+static_assert(PERCEPTION_FALL_OFF == 2.75, "The perception table is worked out for a fall-off of 2.75");
+
+/**
+ * The perception and the separation push by squared distance (in 1/256 of a
+ * square pixel), 64 steps per octave, each step worked out at its middle.
+ */
+struct PairTables {
+	int64_t perception[32*TABLE_STEPS];	// min(1, 1/r^2.75), in 1/2^32.
+	int64_t separation[32*TABLE_STEPS];	// COLLISION_DIST/r^3, in 1/2^30.
+
+	PairTables(){
+		for(unsigned int octave = 0; octave < 32; octave++){
+			for(unsigned int step = 0; step < TABLE_STEPS; step++){
+				double distSquared = (TABLE_STEPS + step + 0.5)*(double) (1ULL << octave)/TABLE_STEPS/256.0;
+				double dist = sqrt(distSquared);
+				double rootDist = sqrt(dist);
+				double seen = 1.0/(distSquared*rootDist*sqrt(rootDist));
+				double push = COLLISION_DIST/(distSquared*dist);
+				perception[octave*TABLE_STEPS + step] = (int64_t) ((seen < 1.0 ? seen : 1.0)*(double) (1ULL << PERCEPTION_SHIFT) + 0.5);
+				separation[octave*TABLE_STEPS + step] = (int64_t) (push*(double) (1ULL << SEPARATION_SHIFT) + 0.5);
+			}
+		}
+	}
+};
+
+static const PairTables tables;
+
+/**
+ * Finds the table entry for a squared distance: its octave, and the next
+ * TABLE_BITS bits below the leading one.
+ *
+ * @param distSquared	Squared distance, in 1/256 of a square pixel.
+ * @return		Index into the tables.
+ */
+static inline unsigned int tableIndex(uint32_t distSquared){
+	unsigned int octave = 31 - __builtin_clz(distSquared | 1);
+	uint32_t step = octave >= TABLE_BITS ? distSquared >> (octave - TABLE_BITS) : distSquared << (TABLE_BITS - octave);
+
+	return octave*TABLE_STEPS + (step & (TABLE_STEPS - 1));
+}
+
+/**
+ * Divides, scaling up the quotient, without overflowing on the way.
+ *
+ * @param numerator	What to divide.
+ * @param denominator	What to divide by; not 0.
+ * @param shift		Power of two to scale the quotient up by.
+ * @return		numerator*2^shift/denominator, rounded toward zero.
+ */
+static inline int64_t scaledQuotient(int64_t numerator, int64_t denominator, unsigned int shift){
+	return (int64_t) ((__int128) numerator*((__int128) 1 << shift)/denominator);
+}
+
+/**
+ * Scales down, rounding to nearest.
+ *
+ * @param value		What to scale.
+ * @param shift		Power of two to scale down by.
+ * @return		value/2^shift, rounded half up.
+ */
+static inline int64_t roundedShift(int64_t value, unsigned int shift){
+	return (value + ((int64_t) 1 << (shift - 1))) >> shift;
+}
+
+/**
+ * Square root of an integer.
+ *
+ * @param value	The integer.
+ * @return	The largest integer whose square is at most value.
+ */
+static uint64_t integerRoot(uint64_t value){
+	/* The double is a good first guess, which is then made exact.
+	 */
+	uint64_t root = (uint64_t) sqrt((double) value);
+	while(root > 0 && root*root > value){
+		root--;
+	}
+	while((root + 1)*(root + 1) <= value){
+		root++;
+	}
+
+	return root;
+}
+
+/**
+ * Converts to fixed point.
+ *
+ * @param value		The number.
+ * @param shift		Fraction bits.
+ * @return		The number in 1/2^shift, rounded to nearest.
+ */
+static int64_t toFixed(double value, unsigned int shift){
+	return (int64_t) floor(value*(double) (1ULL << shift) + 0.5);
+}
+
+/**
+ * Next number off the random generator for respawning, a 64-bit linear
+ * congruential generator (Knuth's MMIX constants).
+ *
+ * @param state	Random state, updated.
+ * @return	31 random bits.
+ */
+static unsigned int nextRandom(uint64_t& state){
+	state = state*6364136223846793005ULL + 1442695040888963407ULL;
+
+	return (unsigned int) (state >> 33);
+}
+
+/**
+ * Constructor from values.
+ *
+ * @param pop			The population, which is rounded to fixed
+ * 				point.
+ * @param ruleCoefficients	Coefficients every Boid flies by.
+ * @param edgeOfWorld		X and Y coordinates of the maximum extent of
+ * 				the simulated space, which has walls.
+ * @param seed			Random state for respawning.
+ * @param workers		Threads to step on. Must outlive the object.
+ * @return			A fully specified object.
+ * @throws			std::runtime_error if the world is too large.
+ */
+DeterministicFlock::DeterministicFlock(const vector<Boid>& pop, const RuleCoefficients& ruleCoefficients, const Point& edgeOfWorld, unsigned int seed, WorkerPool& workers) : pool(workers){
+	if(edgeOfWorld.x > DETERMINISTIC_WORLD_MAX || edgeOfWorld.y > DETERMINISTIC_WORLD_MAX){
+		throw runtime_error("World too large for fixed point!");
+	}
+
+	numBoids = pop.size();
+	coefficients = ruleCoefficients;
+	edges = edgeOfWorld;
+	maxX = toFixed(edges.x, FIXED_SHIFT);
+	maxY = toFixed(edges.y, FIXED_SHIFT);
+	cohesion = toFixed(coefficients.cohesion, COEFFICIENT_SHIFT);
+	separation = toFixed(coefficients.separation, COEFFICIENT_SHIFT);
+	alignment = toFixed(coefficients.alignment, COEFFICIENT_SHIFT);
+	attraction = toFixed(coefficients.attraction, COEFFICIENT_SHIFT);
+	keep = ((int64_t) 1 << COEFFICIENT_SHIFT) - toFixed(coefficients.drag, COEFFICIENT_SHIFT);
+	random = seed;
+
+	x.resize(numBoids);
+	y.resize(numBoids);
+	vx.resize(numBoids);
+	vy.resize(numBoids);
+	ax.resize(numBoids);
+	ay.resize(numBoids);
+	ids.resize(numBoids);
+	nearest.resize(numBoids);
+	escaped.resize(numBoids);
+	ObservableSums sums;
+	clearSums(sums);
+	for(unsigned int i = 0; i < numBoids; i++){
+		Point coords = pop[i].getCoordinates();
+		Vector velocity = pop[i].getVelocity();
+		int64_t fixedX = toFixed(coords.x, FIXED_SHIFT), fixedY = toFixed(coords.y, FIXED_SHIFT);
+		int64_t fixedVx = toFixed(velocity.x, FIXED_SHIFT), fixedVy = toFixed(velocity.y, FIXED_SHIFT);
+		x[i] = (int32_t) (fixedX > 0 ? (fixedX < maxX ? fixedX : maxX) : 0);
+		y[i] = (int32_t) (fixedY > 0 ? (fixedY < maxY ? fixedY : maxY) : 0);
+		vx[i] = (int32_t) (fixedVx > -SPEED_MAX ? (fixedVx < SPEED_MAX ? fixedVx : SPEED_MAX) : -SPEED_MAX);
+		vy[i] = (int32_t) (fixedVy > -SPEED_MAX ? (fixedVy < SPEED_MAX ? fixedVy : SPEED_MAX) : -SPEED_MAX);
+		ids[i] = pop[i].getId();
+		addBoid(sums, pop[i], Point(0.0, 0.0), -1.0);
+	}
+	latest = summarizeSums(sums);
+
+	/* The Boids keep their ranks, and are given back in that order.
+	 */
+	ranks.resize(numBoids);
+	for(unsigned int i = 0; i < numBoids; i++){
+		ranks[i] = i;
+	}
+	scratch.resize(pool.size());
+	for(unsigned int w = 0; w < scratch.size(); w++){
+		scratch[w].offsetX.resize(numBoids);
+		scratch[w].offsetY.resize(numBoids);
+		scratch[w].distSquared.resize(numBoids);
+	}
+	sortByX();
+}
+
+/**
+ * Advances every Boid one tic, on all of the workers.
+ *
+ * Boids that fail to stay inside the world are put back at some random
+ * valid position near the center, at rest, one after the other in the order
+ * of the slots.
+ *
+ * @param destination	Coordinates toward which the boids should head.
+ * @param cutoff	Perception cutoff; at most SIGHT_MAX.
+ * @param observe	true to sum up the order parameters of the flock
+ * 			before the step, for getObservables().
+ */
+void DeterministicFlock::step(const Point& destination, float cutoff, bool observe){
+	if(numBoids == 0){
+		return;
+	}
+
+	double sight = cutoff < SIGHT_MAX ? (cutoff > 0.0 ? cutoff : 0.0) : SIGHT_MAX;
+	int32_t cutoffSquared = (int32_t) floor(sight*sight*256.0);
+	int32_t reach = (int32_t) toFixed(floor(sight) + 1.0, FIXED_SHIFT);
+	int64_t destinationX = toFixed(destination.x, FIXED_SHIFT), destinationY = toFixed(destination.y, FIXED_SHIFT);
+
+	unsigned int numWorkers = pool.size();
+	pool.run([&](unsigned int w){
+		unsigned int first = (unsigned long) numBoids*w/numWorkers;
+		unsigned int last = (unsigned long) numBoids*(w + 1)/numWorkers;
+		accelerate(first, last, destinationX, destinationY, cutoffSquared, reach, w, observe);
+	});
+
+	if(observe){
+		ObservableSums sums;
+		clearSums(sums);
+		double centroidX = 0.0, centroidY = 0.0;
+		for(unsigned int i = 0; i < numBoids; i++){
+			centroidX += x[i];
+			centroidY += y[i];
+		}
+		Point centroid(centroidX/numBoids/65536.0, centroidY/numBoids/65536.0);
+		for(unsigned int i = 0; i < numBoids; i++){
+			addBoid(sums, boidAt(i), centroid, nearest[i] >= 0 ? nearest[i]/256.0 : -1.0);
+		}
+		for(unsigned int w = 0; w < numWorkers; w++){
+			sums.pairTests += scratch[w].pairTests;
+			sums.interactions += scratch[w].interactions;
+		}
+		latest = summarizeSums(sums);
+	}
+
+	pool.run([&](unsigned int w){
+		move((unsigned long) numBoids*w/numWorkers, (unsigned long) numBoids*(w + 1)/numWorkers);
+	});
+	for(unsigned int i = 0; i < numBoids; i++){
+		if(escaped[i]){
+			x[i] = ((int) (edges.x/2) - 100 + (int) (nextRandom(random) % 200))*(1 << FIXED_SHIFT);
+			y[i] = ((int) (edges.y/2) - 100 + (int) (nextRandom(random) % 200))*(1 << FIXED_SHIFT);
+			vx[i] = vy[i] = 0;
+		}
+	}
+	sortByX();
+}
+
+/**
+ * Works out the accelerations of a run of slots, as the rules of
+ * BehaviorRules.h do.
+ *
+ * @param first			First slot of the run.
+ * @param last			One past its last slot.
+ * @param destinationX		Coordinates toward which the boids should
+ * @param destinationY		head, in fixed point.
+ * @param cutoffSquared		Square of the perception cutoff, in 1/256 of
+ * 				a square pixel.
+ * @param reach			Farthest in X a flockmate in sight can be, in
+ * 				fixed point.
+ * @param worker		Worker running it.
+ * @param observe		true to find every Boid's nearest flockmate,
+ * 				and count the work.
+ */
+void DeterministicFlock::accelerate(unsigned int first, unsigned int last, int64_t destinationX, int64_t destinationY, int32_t cutoffSquared, int32_t reach, unsigned int worker, bool observe){
+	Scratch& work = scratch[worker];
+	work.pairTests = 0;
+	work.interactions = 0;
+	if(first >= last){
+		return;
+	}
+
+	unsigned int low = lower_bound(x.begin(), x.begin() + numBoids, x[first] - reach) - x.begin();
+	unsigned int high = low;
+	for(unsigned int i = first; i < last; i++){
+		int32_t selfX = x[i], selfY = y[i];
+		while(x[low] < selfX - reach){
+			low++;
+		}
+		while(high < numBoids && x[high] <= selfX + reach){
+			high++;
+		}
+
+		/* Offsets and squared distances of everything in reach, the
+		 * Boid itself included.
+		 */
+		unsigned int count = high - low;
+		const int32_t* __restrict__ otherX = &x[low];
+		const int32_t* __restrict__ otherY = &y[low];
+		int32_t* __restrict__ offsetX = &work.offsetX[0];
+		int32_t* __restrict__ offsetY = &work.offsetY[0];
+		int32_t* __restrict__ distSquared = &work.distSquared[0];
+		for(unsigned int k = 0; k < count; k++){
+			int32_t dx = (selfX - otherX[k]) >> OFFSET_SHIFT;
+			int32_t dy = (selfY - otherY[k]) >> OFFSET_SHIFT;
+			dx = dx > -OFFSET_LIMIT ? (dx < OFFSET_LIMIT ? dx : OFFSET_LIMIT) : -OFFSET_LIMIT;
+			dy = dy > -OFFSET_LIMIT ? (dy < OFFSET_LIMIT ? dy : OFFSET_LIMIT) : -OFFSET_LIMIT;
+			offsetX[k] = dx;
+			offsetY[k] = dy;
+			distSquared[k] = dx*dx + dy*dy;
+		}
+
+		/* Flockmates right on top of the Boid have no offset, so they
+		 * give no direction to steer in.
+		 */
+		int64_t perception = 0, positionX = 0, positionY = 0, velocityX = 0, velocityY = 0, pushX = 0, pushY = 0;
+		int32_t selfVx = vx[i] >> VELOCITY_SHIFT, selfVy = vy[i] >> VELOCITY_SHIFT;
+		int32_t closest = -1;
+		unsigned int flockmates = 0;
+		for(unsigned int k = 0; k < count; k++){
+			if(distSquared[k] > cutoffSquared || low + k == i){
+				continue;
+			}
+			unsigned int entry = tableIndex(distSquared[k]);
+			int64_t weight = tables.perception[entry];
+			int64_t push = tables.separation[entry];
+			perception += weight;
+			positionX += weight*offsetX[k];
+			positionY += weight*offsetY[k];
+			velocityX += weight*((vx[low + k] >> VELOCITY_SHIFT) - selfVx);
+			velocityY += weight*((vy[low + k] >> VELOCITY_SHIFT) - selfVy);
+			pushX += push*offsetX[k];
+			pushY += push*offsetY[k];
+			closest = closest < 0 || distSquared[k] < closest ? distSquared[k] : closest;
+			flockmates++;
+		}
+
+		/* The means are taken relative to the Boid, so the cohesion is
+		 * minus the mean offset. Offsets have FIXED_SHIFT -
+		 * OFFSET_SHIFT fraction bits.
+		 */
+		int64_t cohesionX = 0, cohesionY = 0, alignmentX = 0, alignmentY = 0;
+		if(flockmates > 0){
+			cohesionX = -scaledQuotient(positionX, perception, OFFSET_SHIFT);
+			cohesionY = -scaledQuotient(positionY, perception, OFFSET_SHIFT);
+			alignmentX = scaledQuotient(velocityX, perception, VELOCITY_SHIFT);
+			alignmentY = scaledQuotient(velocityY, perception, VELOCITY_SHIFT);
+		}
+		int64_t separationX = roundedShift(pushX, SEPARATION_SHIFT - OFFSET_SHIFT);
+		int64_t separationY = roundedShift(pushY, SEPARATION_SHIFT - OFFSET_SHIFT);
+
+		/* The pull toward the destination, 1/(1 + DESTINATION_DECAY*r)
+		 * along the unit vector, is one division by r*(1 +
+		 * DESTINATION_DECAY*r).
+		 */
+		int64_t attractionX = 0, attractionY = 0;
+		int64_t dx = selfX - destinationX, dy = selfY - destinationY;
+		int64_t dist = integerRoot(dx*dx + dy*dy);
+		if(dist > 0){
+			int64_t decayed = dist*(((int64_t) 1 << FIXED_SHIFT) + roundedShift(dist*toFixed(DESTINATION_DECAY, FIXED_SHIFT), FIXED_SHIFT));
+			attractionX = -scaledQuotient(dx, decayed, 2*FIXED_SHIFT);
+			attractionY = -scaledQuotient(dy, decayed, 2*FIXED_SHIFT);
+		}
+
+		ax[i] = roundedShift(cohesion*cohesionX + separation*separationX + alignment*alignmentX + attraction*attractionX, COEFFICIENT_SHIFT);
+		ay[i] = roundedShift(cohesion*cohesionY + separation*separationY + alignment*alignmentY + attraction*attractionY, COEFFICIENT_SHIFT);
+		if(observe){
+			nearest[i] = closest;
+			work.pairTests += count - 1;
+			work.interactions += flockmates;
+		}
+	}
+}
+
+/**
+ * Moves a run of slots once their accelerations are known, as Integrator.cpp
+ * does in a walled world: drag, then Euler, then reflection about any edge
+ * crossed. Boids still outside after that are marked as escaped.
+ *
+ * @param first		First slot of the run.
+ * @param last		One past its last slot.
+ */
+void DeterministicFlock::move(unsigned int first, unsigned int last){
+	for(unsigned int i = first; i < last; i++){
+		int64_t novelVx = roundedShift(keep*vx[i], COEFFICIENT_SHIFT) + ax[i];
+		int64_t novelVy = roundedShift(keep*vy[i], COEFFICIENT_SHIFT) + ay[i];
+		novelVx = novelVx > -SPEED_MAX ? (novelVx < SPEED_MAX ? novelVx : SPEED_MAX) : -SPEED_MAX;
+		novelVy = novelVy > -SPEED_MAX ? (novelVy < SPEED_MAX ? novelVy : SPEED_MAX) : -SPEED_MAX;
+		int64_t novelX = x[i] + novelVx;
+		int64_t novelY = y[i] + novelVy;
+
+		bool crossedX = novelX < 0 || novelX > maxX;
+		bool crossedY = novelY < 0 || novelY > maxY;
+		novelX = crossedX ? 2*(novelX > maxX ? maxX : 0) - novelX : novelX;
+		novelY = crossedY ? 2*(novelY > maxY ? maxY : 0) - novelY : novelY;
+		novelVx = crossedX ? -novelVx : novelVx;
+		novelVy = crossedY ? -novelVy : novelVy;
+
+		escaped[i] = novelX < 0 || novelX > maxX || novelY < 0 || novelY > maxY ? 1 : 0;
+		x[i] = (int32_t) (escaped[i] ? 0 : novelX);
+		y[i] = (int32_t) (escaped[i] ? 0 : novelY);
+		vx[i] = (int32_t) novelVx;
+		vy[i] = (int32_t) novelVy;
+	}
+}
+
+/**
+ * Sorts the slots by X coordinate, ties broken by rank, so that the order
+ * only depends on the state.
+ */
+void DeterministicFlock::sortByX(){
+	order.resize(numBoids);
+	for(unsigned int i = 0; i < numBoids; i++){
+		order[i] = (uint64_t) ((uint32_t) x[i] ^ 0x80000000u) << 32 | ranks[i];
+	}
+	sort(order.begin(), order.end());
+
+	/* The ranks are the slots the Boids held before, for the while.
+	 */
+	vector<unsigned int> previous(ranks);
+	vector<int32_t> oldX(x), oldY(y), oldVx(vx), oldVy(vy);
+	vector<unsigned int> slots(numBoids);
+	for(unsigned int i = 0; i < numBoids; i++){
+		slots[previous[i]] = i;
+	}
+	for(unsigned int i = 0; i < numBoids; i++){
+		unsigned int from = slots[(uint32_t) order[i]];
+		x[i] = oldX[from];
+		y[i] = oldY[from];
+		vx[i] = oldVx[from];
+		vy[i] = oldVy[from];
+		ranks[i] = previous[from];
+	}
+}
+
+/**
+ * Makes a Boid out of a slot.
+ *
+ * @param slot	Index of the slot.
+ * @return	The Boid in it, rounded to floating point.
+ */
+Boid DeterministicFlock::boidAt(unsigned int slot) const{
+	double scale = 1.0/(1 << FIXED_SHIFT);
+
+	return Boid(Point(x[slot]*scale, y[slot]*scale), Vector(vx[slot]*scale, vy[slot]*scale), coefficients.cohesion, coefficients.separation, coefficients.alignment, coefficients.attraction, edges, ids[ranks[slot]]);
+}
+
+/**
+ * Collects the whole population.
+ *
+ * @param pop	Cleared and filled with every Boid, in the order they
+ * 		were given in.
+ */
+void DeterministicFlock::getBoids(vector<Boid>& pop) const{
+	vector<unsigned int> slots(numBoids);
+	for(unsigned int i = 0; i < numBoids; i++){
+		slots[ranks[i]] = i;
+	}
+
+	pop.clear();
+	for(unsigned int r = 0; r < numBoids; r++){
+		pop.push_back(boidAt(slots[r]));
+	}
+}
+
+/**
+ * Getter for the size of the population.
+ *
+ * @return	The number of Boids.
+ */
+unsigned int DeterministicFlock::size() const{
+	return numBoids;
+}
+
+/**
+ * Getter for the order parameters of the population.
+ *
+ * @return	Order parameters of the population as it was at the start of
+ * 		the last step that observed it.
+ */
+Observables DeterministicFlock::getObservables() const{
+	return latest;
+}
+
+/**
+ * Fingerprint of the state, for telling at a glance whether two runs came
+ * out the same: 64-bit FNV-1a over the positions and velocities, in the
+ * order the Boids were given in.
+ *
+ * @return	The fingerprint.
+ */
+uint64_t DeterministicFlock::checksum() const{
+	vector<unsigned int> slots(numBoids);
+	for(unsigned int i = 0; i < numBoids; i++){
+		slots[ranks[i]] = i;
+	}
+
+	uint64_t hash = 14695981039346656037ULL;
+	for(unsigned int r = 0; r < numBoids; r++){
+		uint32_t words[4] = {(uint32_t) x[slots[r]], (uint32_t) y[slots[r]], (uint32_t) vx[slots[r]], (uint32_t) vy[slots[r]]};
+		for(unsigned int w = 0; w < 4; w++){
+			for(unsigned int b = 0; b < 32; b += 8){
+				hash = (hash ^ ((words[w] >> b) & 0xff))*1099511628211ULL;
+			}
+		}
+	}
+
+	return hash;
+}
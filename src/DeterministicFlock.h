@@ -0,0 +1,93 @@
+/**
+ * \file DeterministicFlock.h
+ *
+ * Flock in fixed-point arithmetic, for runs that come out the same to the bit
+ * on any machine. See implementation for more details.
+ *
+ * @since	2026-10-18
+ * @see		DeterministicFlock.cpp
+ */
+
+/* Idempotency.
+ */
+#ifndef DETERMINISTIC_FLOCK_H
+#define DETERMINISTIC_FLOCK_H
+
+/**
+ * Includes.
+ */
+#include <vector>
+#include <stdint.h>
+#include "WorkerPool.h"
+#include "BehaviorRules.h"
+#include "Observables.h"
+#include "Boid.h"
+
+/**
+ * Definitions.
+ */
+#define DETERMINISTIC_WORLD_MAX 32767 // Widest and tallest world, in pixels
+
+using namespace std;
+
+/**
+ * A flock that all flies by the same coefficients, with positions and
+ * velocities in fixed point, stepped on worker threads.
+ */
+class DeterministicFlock {
+	public:
+		DeterministicFlock(const vector<Boid>& pop, const RuleCoefficients& ruleCoefficients, const Point& edgeOfWorld, unsigned int seed, WorkerPool& workers);
+
+		void step(const Point& destination, float cutoff, bool observe);
+		void getBoids(vector<Boid>& pop) const;
+		unsigned int size() const;
+		Observables getObservables() const;
+		uint64_t checksum() const;
+
+	protected:
+		void accelerate(unsigned int first, unsigned int last, int64_t destinationX, int64_t destinationY, int32_t cutoffSquared, int32_t reach, unsigned int worker, bool observe);
+		void move(unsigned int first, unsigned int last);
+		void sortByX();
+		Boid boidAt(unsigned int slot) const;
+
+		/**
+		 * Scratch space of a worker.
+		 */
+		struct Scratch {
+			vector<int32_t> offsetX;	// From every flockmate in reach to the Boid.
+			vector<int32_t> offsetY;
+			vector<int32_t> distSquared;
+			unsigned long pairTests;
+			unsigned long interactions;
+		};
+
+		/* Properties. The state is kept sorted by X coordinate, slot by
+		 * slot.
+		 */
+		WorkerPool& pool;
+		unsigned int numBoids;
+		vector<int32_t> x, y;		// In 1/65536 of a pixel.
+		vector<int32_t> vx, vy;		// In 1/65536 of a pixel per step.
+		vector<int64_t> ax, ay;		// Likewise, per step squared.
+		vector<unsigned int> ranks;	// Place of every slot's Boid in the population given.
+		vector<unsigned int> ids;	// By rank.
+		vector<int32_t> nearest;	// Squared distance to the nearest flockmate, if observed.
+		vector<unsigned char> escaped;	// 1 for slots that left the world in the step.
+		vector<uint64_t> order;		// Scratch space for sorting.
+		vector<Scratch> scratch;	// One per worker.
+		int64_t cohesion, separation, alignment, attraction;	// In 1/2^24.
+		int64_t keep;			// Part of the velocity that survives the drag, likewise.
+		RuleCoefficients coefficients;
+		Point edges;
+		int64_t maxX, maxY;		// Edges of the world, in fixed point.
+		uint64_t random;		// Random state for respawning.
+		Observables latest;
+
+	private:
+		DeterministicFlock(const DeterministicFlock&);
+		DeterministicFlock& operator=(const DeterministicFlock&);
+};
+
+/* End idempotency.
+ */
+#endif
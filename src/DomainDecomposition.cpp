@@ -0,0 +1,551 @@
+/**
+ * \file	DomainDecomposition.cpp
+ *
+ * Runs a population of Boids as spatial domains in separate local
+ * processes.
+ *
+ * The world is cut into vertical strips (domains), each simulated by its own
+ * forked process, which keeps its residents in its own address space. The
+ * processes talk to each other, MPI-style, through shared-memory rings (see
+ * SharedRing.cpp): one ring for every ordered pair of domains, plus one in
+ * each direction between every domain and this (controlling) process.
+ *
+ * Each step, the controlling process sends every domain the destination,
+ * the accuracy settings and the current domain boundaries. The domains then
+ *
+ * 1. send every other domain their halo (residents within the perception
+ *    cutoff of that domain) and their migrants (residents that now belong
+ *    to that domain),
+ * 2. receive the same from everyone else and advance their residents, and
+ * 3. report their residents back for drawing, along with their partial
+ *    sums for the order parameters (see Observables.cpp).
+ *
+ * As flocks move, the domains drift out of balance. Whenever the busiest
+ * domain has too many residents compared to the average, the boundaries are
+ * moved to the quantiles of the X coordinates of the population, and the
+ * migrants sort themselves out in the next step. Domain sizes, halo sizes
+ * and imbalance are logged to STDERR at every rebalance, and periodically.
+ *
+ * @since	2026-10-18
+ */
+
+/**
+ * Includes.
+ *
+ * The standard headers (including those pulled in by Simulation.h) go first,
+ * since geometry/common.h defines min() and max() macros that break them.
+ */
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+#include <string.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/prctl.h>
+#include "Simulation.h"
+#include "DomainDecomposition.h"
+
+/**
+ * Definitions.
+ */
+#define RING_BYTES (1 << 20)		// Capacity of every channel
+#define REBALANCE_THRESHOLD 1.25	// Busiest domain vs. average that triggers a rebalance
+#define REPORT_INTERVAL 500		// Steps between reports on the decomposition
+
+/**
+ * A Boid on the wire. All Boids in a simulation share their behavior, so
+ * position, velocity and identity are all that need to travel. In full
+ * precision, so that Boids crossing between domains fly on as they would
+ * on the threads.
+ */
+struct BoidRecord {
+	double x;
+	double y;
+	double vx;
+	double vy;
+	unsigned int id;
+};
+
+/**
+ * Start of every message between processes, followed by numRecords Boids.
+ * Reports to the controlling process have the order parameter sums of the
+ * domain in between.
+ */
+struct MessageHeader {
+	unsigned int numRecords;
+	unsigned int info;	// Number of migrants (between domains) or of halo Boids (to the controller).
+};
+
+/**
+ * Instructions from the controlling process for one step.
+ */
+struct DomainControl {
+	float destinationX;
+	float destinationY;
+	float cutoff;
+	unsigned int stride;
+	float centroidX;
+	float centroidY;
+	unsigned int quit;
+	float bounds[MAX_DOMAINS+1];
+};
+
+/**
+ * Appends a Boid to an outgoing message.
+ *
+ * @param boid		The Boid.
+ * @param message	The message.
+ */
+static void appendRecord(const Boid& boid, vector<char>& message){
+	Point coords = boid.getCoordinates();
+	Vector velocity = boid.getVelocity();
+	BoidRecord record = {coords.x, coords.y, velocity.x, velocity.y, boid.getId()};
+	message.insert(message.end(), (const char*) &record, (const char*) &record + sizeof(BoidRecord));
+}
+
+/**
+ * Unpacks the Boids of a received message.
+ *
+ * @param message	The message, header included.
+ * @param skipBytes	Bytes between the header and the first record.
+ * @param first		Index of the first record to unpack.
+ * @param last		One past the index of the last record to unpack.
+ * @param prototype	Boid whose behavior the unpacked Boids share.
+ * @param boids		The Boids are appended here.
+ */
+static void unpackRecords(const vector<char>& message, size_t skipBytes, unsigned int first, unsigned int last, const Boid& prototype, vector<Boid>& boids){
+	const BoidRecord* records = (const BoidRecord*) (&message[0] + sizeof(MessageHeader) + skipBytes);
+	for(unsigned int i = first; i < last; i++){
+		boids.push_back(prototype.placedAt(Point(records[i].x, records[i].y), Vector(records[i].vx, records[i].vy), records[i].id));
+	}
+}
+
+/**
+ * Sends and receives one message on each of a set of channels at once.
+ *
+ * Moves data on whichever channel has room or data, so that two processes
+ * sending each other messages larger than a ring can't deadlock.
+ *
+ * @param outRings	Channels to send on.
+ * @param out		Messages to send, one per outgoing channel.
+ * @param inRings	Channels to receive on.
+ * @param in		Filled with the received messages, headers included.
+ * @param skipBytes	Bytes between the header and the first record of
+ * 			the received messages.
+ * @param watchChildren	true if a dead child process should be detected
+ * 			rather than waited for forever.
+ * @throws		std::runtime_error if a child process died.
+ */
+static void exchange(const vector<SharedRing*>& outRings, const vector<vector<char> >& out, const vector<SharedRing*>& inRings, vector<vector<char> >& in, size_t skipBytes, bool watchChildren){
+	vector<size_t> sent(outRings.size(), 0);
+	vector<size_t> received(inRings.size(), 0);
+	in.resize(inRings.size());
+	for(unsigned int i = 0; i < inRings.size(); i++){
+		in[i].resize(sizeof(MessageHeader));
+	}
+
+	bool finished = false;
+	while(!finished){
+		finished = true;
+		bool progress = false;
+
+		for(unsigned int i = 0; i < outRings.size(); i++){
+			if(sent[i] < out[i].size()){
+				size_t count = outRings[i]->write(&out[i][sent[i]], out[i].size() - sent[i]);
+				sent[i] += count;
+				progress = progress || count > 0;
+				finished = finished && sent[i] == out[i].size();
+			}
+		}
+
+		for(unsigned int i = 0; i < inRings.size(); i++){
+			if(received[i] < in[i].size()){
+				size_t count = inRings[i]->read(&in[i][received[i]], in[i].size() - received[i]);
+				received[i] += count;
+				progress = progress || count > 0;
+
+				/* Once the header is in, we know how much
+				 * more to expect.
+				 */
+				if(count > 0 && received[i] == sizeof(MessageHeader)){
+					const MessageHeader* header = (const MessageHeader*) &in[i][0];
+					in[i].resize(sizeof(MessageHeader) + skipBytes + header->numRecords*sizeof(BoidRecord));
+				}
+				finished = finished && received[i] == in[i].size();
+			}
+		}
+
+		if(!progress && !finished){
+			int status;
+			if(watchChildren && waitpid(-1, &status, WNOHANG) > 0){
+				throw runtime_error("A domain process died!");
+			}
+			sched_yield();
+		}
+	}
+}
+
+/**
+ * Constructor from values.
+ *
+ * Sets up the channels and forks off one process per domain. The domains
+ * start out as strips of equal width.
+ *
+ * @param initialPop	The population to start from.
+ * @param edgeOfWorld	X and Y coordinates of the maximum extent of the
+ * 			simulated space.
+ * @param wrapped	true if the edges of the world wrap around, false
+ * 			if they are solid walls.
+ * @param domains	Number of domains (and processes), 1 to MAX_DOMAINS.
+ * @return		A fully specified object.
+ * @throws		std::runtime_error if the processes can't be started.
+ */
+DomainDecomposition::DomainDecomposition(const vector<Boid>& initialPop, Point edgeOfWorld, bool wrapped, unsigned int domains){
+	numDomains = domains < 1 ? 1 : (domains > MAX_DOMAINS ? MAX_DOMAINS : domains);
+	edges = edgeOfWorld;
+	wrap = wrapped;
+	steps = 0;
+	pop = initialPop;
+
+	/* Only the centroid is needed before the first step.
+	 */
+	ObservableSums sums;
+	clearSums(sums);
+	for(unsigned int i = 0; i < pop.size(); i++){
+		addBoid(sums, pop[i], Point(0.0, 0.0), -1.0);
+	}
+	latest = summarizeSums(sums);
+	centroid = latest.centroid;
+	residents.resize(numDomains, 0);
+	halos.resize(numDomains, 0);
+
+	for(unsigned int d = 0; d <= numDomains; d++){
+		bounds.push_back(d*edges.x/numDomains);
+	}
+
+	for(unsigned int from = 0; from <= numDomains; from++){
+		for(unsigned int to = 0; to <= numDomains; to++){
+			rings.push_back(from == to ? NULL : new SharedRing(RING_BYTES));
+		}
+	}
+
+	for(unsigned int d = 0; d < numDomains; d++){
+		pid_t pid = fork();
+		if(pid < 0){
+			throw runtime_error("Unable to start domain process!");
+		}
+		if(pid == 0){
+			/* Don't outlive the controlling process.
+			 */
+			prctl(PR_SET_PDEATHSIG, SIGTERM);
+			runDomain(d);
+			_exit(0);
+		}
+		children.push_back(pid);
+	}
+}
+
+/**
+ * Destructor. Tells the domain processes to quit and waits for them.
+ */
+DomainDecomposition::~DomainDecomposition(){
+	DomainControl control;
+	memset(&control, 0, sizeof(DomainControl));
+	control.quit = 1;
+	for(unsigned int d = 0; d < children.size(); d++){
+		channel(numDomains, d).send(&control, sizeof(DomainControl));
+	}
+	for(unsigned int d = 0; d < children.size(); d++){
+		waitpid(children[d], NULL, 0);
+	}
+
+	for(unsigned int i = 0; i < rings.size(); i++){
+		delete rings[i];
+	}
+}
+
+/**
+ * Advances every Boid in the population one tic, and collects the result.
+ *
+ * @param destination	Coordinates toward which the boids should head.
+ * @param quality	Perception cutoff and flockmate stride to use.
+ * @throws		std::runtime_error if a domain process died.
+ */
+void DomainDecomposition::step(const Point& destination, const QualitySettings& quality){
+	DomainControl control;
+	memset(&control, 0, sizeof(DomainControl));
+	control.destinationX = destination.x;
+	control.destinationY = destination.y;
+	control.cutoff = quality.cutoff;
+	control.stride = quality.stride;
+	control.centroidX = centroid.x;
+	control.centroidY = centroid.y;
+	for(unsigned int d = 0; d <= numDomains; d++){
+		control.bounds[d] = bounds[d];
+	}
+
+	for(unsigned int d = 0; d < numDomains; d++){
+		channel(numDomains, d).send(&control, sizeof(DomainControl));
+	}
+
+	/* Collect the reports.
+	 */
+	vector<SharedRing*> noRings, fromDomains;
+	vector<vector<char> > noMessages, reports;
+	for(unsigned int d = 0; d < numDomains; d++){
+		fromDomains.push_back(&channel(d, numDomains));
+	}
+	exchange(noRings, noMessages, fromDomains, reports, sizeof(ObservableSums), true);
+
+	vector<Boid> prototype(pop.begin(), pop.begin() + (pop.empty() ? 0 : 1));
+	pop.clear();
+	ObservableSums sums;
+	clearSums(sums);
+	for(unsigned int d = 0; d < numDomains; d++){
+		const MessageHeader* header = (const MessageHeader*) &reports[d][0];
+		residents[d] = header->numRecords;
+		halos[d] = header->info;
+		mergeSums(sums, *(const ObservableSums*) (&reports[d][0] + sizeof(MessageHeader)));
+		if(!prototype.empty()){
+			unpackRecords(reports[d], sizeof(ObservableSums), 0, header->numRecords, prototype[0], pop);
+		}
+	}
+	latest = summarizeSums(sums);
+
+	/* The domains sum up the Boids they report now at the start of the
+	 * next step, so milling is measured around the centroid of these.
+	 */
+	double sumX = 0.0, sumY = 0.0;
+	for(unsigned int i = 0; i < pop.size(); i++){
+		sumX += pop[i].getCoordinates().x;
+		sumY += pop[i].getCoordinates().y;
+	}
+	centroid = pop.empty() ? Point(0.0, 0.0) : Point(sumX/pop.size(), sumY/pop.size());
+
+	if(++steps % REPORT_INTERVAL == 0){
+		report("periodic");
+	}
+	rebalance();
+}
+
+/**
+ * Collects the whole population, e.g. for drawing.
+ *
+ * @param boids	Cleared and filled with every Boid, domain by domain.
+ */
+void DomainDecomposition::getBoids(vector<Boid>& boids) const{
+	boids = pop;
+}
+
+/**
+ * Getter for the size of the population.
+ *
+ * @return	The number of Boids.
+ */
+unsigned int DomainDecomposition::size() const{
+	return pop.size();
+}
+
+/**
+ * Getter for the order parameters of the population.
+ *
+ * @return	Order parameters of the population as it was at the start of
+ * 		the last step.
+ */
+Observables DomainDecomposition::getObservables() const{
+	return latest;
+}
+
+/**
+ * Main loop of a domain process. Never returns.
+ *
+ * @param domain	Index of the domain this process simulates.
+ */
+void DomainDecomposition::runDomain(unsigned int domain){
+	vector<Boid> boids, halo, flockmates, moved;
+	Kinematics motion;
+	for(unsigned int i = 0; i < pop.size(); i++){
+		if(domainOf(pop[i]) == domain){
+			boids.push_back(pop[i]);
+		}
+	}
+	vector<Boid> prototype(pop.begin(), pop.begin() + (pop.empty() ? 0 : 1));
+	pop.clear();
+	unsigned int seed = domain + 1;
+
+	vector<SharedRing*> toPeers, fromPeers, toController;
+	vector<unsigned int> peers;
+	for(unsigned int d = 0; d < numDomains; d++){
+		if(d != domain){
+			peers.push_back(d);
+			toPeers.push_back(&channel(domain, d));
+			fromPeers.push_back(&channel(d, domain));
+		}
+	}
+	toController.push_back(&channel(domain, numDomains));
+
+	while(true){
+		DomainControl control;
+		channel(numDomains, domain).receive(&control, sizeof(DomainControl));
+		if(control.quit){
+			_exit(0);
+		}
+		bounds.assign(control.bounds, control.bounds + numDomains + 1);
+		QualitySettings quality = {control.cutoff, control.stride, 1};
+		Point destination(control.destinationX, control.destinationY);
+		Point centroid(control.centroidX, control.centroidY);
+
+		/* Tell every peer about the residents it can perceive, and
+		 * hand over the residents that belong to it now. A migrant
+		 * is not also sent as halo to its new domain.
+		 */
+		vector<vector<char> > out(peers.size());
+		for(unsigned int p = 0; p < peers.size(); p++){
+			float reachLeft = bounds[peers[p]] - quality.cutoff;
+			float reachRight = bounds[peers[p]+1] + quality.cutoff;
+			vector<char> haloPart, migrantPart;
+			unsigned int numHalo = 0, numMigrants = 0;
+			for(unsigned int i = 0; i < boids.size(); i++){
+				float x = boids[i].getCoordinates().x;
+				if(domainOf(boids[i]) == peers[p]){
+					appendRecord(boids[i], migrantPart);
+					numMigrants++;
+				}
+				else if(x >= reachLeft && x < reachRight){
+					appendRecord(boids[i], haloPart);
+					numHalo++;
+				}
+			}
+			MessageHeader header = {numHalo + numMigrants, numMigrants};
+			out[p].insert(out[p].end(), (const char*) &header, (const char*) &header + sizeof(MessageHeader));
+			out[p].insert(out[p].end(), haloPart.begin(), haloPart.end());
+			out[p].insert(out[p].end(), migrantPart.begin(), migrantPart.end());
+		}
+
+		/* The Boids leaving are still right at the boundary, where
+		 * the residents can see them, so they stay on as halo for
+		 * this step: their new domain hasn't told anybody about them.
+		 */
+		vector<Boid> staying;
+		halo.clear();
+		for(unsigned int i = 0; i < boids.size(); i++){
+			if(domainOf(boids[i]) == domain){
+				staying.push_back(boids[i]);
+			}
+			else{
+				halo.push_back(boids[i]);
+			}
+		}
+		boids.swap(staying);
+
+		vector<vector<char> > in;
+		exchange(toPeers, out, fromPeers, in, 0, false);
+
+		if(!prototype.empty()){
+			for(unsigned int p = 0; p < in.size(); p++){
+				const MessageHeader* header = (const MessageHeader*) &in[p][0];
+				unsigned int numHalo = header->numRecords - header->info;
+				unpackRecords(in[p], 0, 0, numHalo, prototype[0], halo);
+				unpackRecords(in[p], 0, numHalo, header->numRecords, prototype[0], boids);
+			}
+		}
+
+		ObservableSums sums;
+		clearSums(sums);
+		advanceResidents(boids, halo, destination, quality, 1.0, edges, wrap, seed, flockmates, motion, moved, centroid, sums, NULL);
+		boids.swap(moved);
+
+		/* Report back for drawing.
+		 */
+		vector<vector<char> > reportOut(1), noMessages;
+		vector<SharedRing*> noRings;
+		MessageHeader header = {(unsigned int) boids.size(), (unsigned int) halo.size()};
+		reportOut[0].insert(reportOut[0].end(), (const char*) &header, (const char*) &header + sizeof(MessageHeader));
+		reportOut[0].insert(reportOut[0].end(), (const char*) &sums, (const char*) &sums + sizeof(ObservableSums));
+		for(unsigned int i = 0; i < boids.size(); i++){
+			appendRecord(boids[i], reportOut[0]);
+		}
+		exchange(toController, reportOut, noRings, noMessages, 0, false);
+	}
+}
+
+/**
+ * Moves the domain boundaries to even out the number of residents, if the
+ * domains are too far out of balance.
+ */
+void DomainDecomposition::rebalance(){
+	if(pop.size() < numDomains){
+		return;
+	}
+
+	/* Judge the balance by where the Boids are now, which is what the
+	 * domains will have to work with after the next round of migration.
+	 */
+	vector<unsigned int> upcoming(numDomains, 0);
+	for(unsigned int i = 0; i < pop.size(); i++){
+		upcoming[domainOf(pop[i])]++;
+	}
+	unsigned int busiest = *max_element(upcoming.begin(), upcoming.end());
+	float average = (float) pop.size() / numDomains;
+	if(busiest <= REBALANCE_THRESHOLD*average){
+		return;
+	}
+
+	/* Put the boundaries halfway between the Boids at the quantiles.
+	 */
+	vector<float> xs;
+	for(unsigned int i = 0; i < pop.size(); i++){
+		xs.push_back(pop[i].getCoordinates().x);
+	}
+	sort(xs.begin(), xs.end());
+	for(unsigned int d = 1; d < numDomains; d++){
+		unsigned int k = d*xs.size()/numDomains;
+		bounds[d] = 0.5*(xs[k-1] + xs[k]);
+	}
+
+	report("rebalancing");
+}
+
+/**
+ * Logs the state of the decomposition to STDERR.
+ *
+ * @param reason	Why the report is made.
+ */
+void DomainDecomposition::report(const char* reason) const{
+	unsigned int busiest = 0, totalHalo = 0;
+	cerr << "domains (" << reason << ", step " << steps << "): residents";
+	for(unsigned int d = 0; d < numDomains; d++){
+		cerr << " " << residents[d];
+		busiest = residents[d] > busiest ? residents[d] : busiest;
+		totalHalo += halos[d];
+	}
+	cerr << ", halo " << totalHalo
+		<< ", imbalance " << (pop.empty() ? 1.0 : busiest*numDomains / (float) pop.size()) << endl;
+}
+
+/**
+ * Finds the domain a Boid belongs in.
+ *
+ * @param boid	The Boid.
+ * @return	Index of the domain containing it.
+ */
+unsigned int DomainDecomposition::domainOf(const Boid& boid) const{
+	float x = boid.getCoordinates().x;
+	unsigned int d = upper_bound(bounds.begin() + 1, bounds.end() - 1, x) - (bounds.begin() + 1);
+
+	return d;
+}
+
+/**
+ * Getter for a channel between two processes.
+ *
+ * @param from	Index of the sending domain (numDomains for this process).
+ * @param to	Index of the receiving domain (numDomains for this process).
+ * @return	The ring connecting them.
+ */
+SharedRing& DomainDecomposition::channel(unsigned int from, unsigned int to){
+	return *rings[from*(numDomains+1) + to];
+}
@@ -0,0 +1,68 @@
+/**
+ * \file DomainDecomposition.h
+ *
+ * Runs a population of Boids as spatial domains in separate processes. See
+ * implementation for more details.
+ *
+ * @since	2026-10-18
+ * @see		DomainDecomposition.cpp
+ */
+
+/* Idempotency.
+ */
+#ifndef DOMAIN_DECOMPOSITION_H
+#define DOMAIN_DECOMPOSITION_H
+
+/**
+ * Includes.
+ */
+#include <vector>
+#include <sys/types.h>
+#include "SharedRing.h"
+#include "Boid.h"
+#include "QualityController.h"
+#include "Observables.h"
+
+/**
+ * Definitions.
+ */
+#define MAX_DOMAINS 64
+
+using namespace std;
+
+class DomainDecomposition {
+	public:
+		DomainDecomposition(const vector<Boid>& initialPop, Point edgeOfWorld, bool wrapped, unsigned int numDomains);
+		~DomainDecomposition();
+
+		void step(const Point& destination, const QualitySettings& quality);
+		void getBoids(vector<Boid>& pop) const;
+		unsigned int size() const;
+		Observables getObservables() const;
+
+	protected:
+		void runDomain(unsigned int domain);
+		void rebalance();
+		void report(const char* reason) const;
+		unsigned int domainOf(const Boid& boid) const;
+		SharedRing& channel(unsigned int from, unsigned int to);
+
+		/* Properties.
+		 */
+		unsigned int numDomains;
+		vector<SharedRing*> rings;	// (numDomains+1)^2 channels; index numDomains is this process.
+		vector<pid_t> children;
+		vector<float> bounds;		// Domain d covers bounds[d] <= x < bounds[d+1].
+		vector<Boid> pop;
+		vector<unsigned int> residents;
+		vector<unsigned int> halos;
+		Point edges;
+		bool wrap;
+		unsigned long steps;
+		Observables latest;
+		Point centroid;			// Of the population as it is now, to measure milling around.
+};
+
+/* End idempotency.
+ */
+#endif
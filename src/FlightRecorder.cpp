@@ -0,0 +1,316 @@
+/**
+ * \file	FlightRecorder.cpp
+ *
+ * Flight recorder for the occasional frame that takes far longer than the
+ * others (a dense cluster forming, many Boids respawning at once), which is
+ * gone long before anyone can look at it.
+ *
+ * Every frame, the recorder keeps when each phase of the main loop started
+ * and ended, the timings of the step phase by phase and strip by strip (see
+ * Simulation.cpp), and a few counters, in a ring of the latest frames. It
+ * also keeps the population each of the latest few frames started from, in
+ * a smaller ring, as trajectory records. All of the storage, down to the
+ * timings of every strip, is allocated up front and reused, so keeping it
+ * costs a copy of the population and a few clock readings per frame, and
+ * nothing is allocated in the frames being watched.
+ *
+ * When a frame takes longer than the budget, both rings are written out
+ * next to each other, named after the slow frame:
+ *
+ * - prefix-frame.json: the frames in the Trace Event Format, to load into
+ *   chrome://tracing or Perfetto. The main loop is one track, every strip
+ *   another, and the counters are counter tracks.
+ * - prefix-frame.trj: the populations, oldest first, as a trajectory file,
+ *   to look at with --replay or flock-analyze. The last one is the state the
+ *   slow frame started from, so the step can be run again from it, e.g. with
+ *   the from key of flock-daemon, under a profiler.
+ *
+ * Writing takes a while, so it happens after the frame has been timed, and
+ * no other frame is written out until the ring has filled up with new ones:
+ * a burst of slow frames makes a single dump.
+ *
+ * @since	2026-10-18
+ */
+
+/**
+ * Includes.
+ */
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+#include <string.h>
+#include "FlightRecorder.h"
+#include "TrajectoryRecorder.h"
+
+/**
+ * Constructor from values.
+ *
+ * @param pathPrefix	Where to write dumps to: the path and name of the
+ * 			files, up to the number of the frame.
+ * @param slowFrameMs	Longest a frame may take, in milliseconds, before
+ * 			it is dumped.
+ * @param framesKept	Number of frames to keep the timings of.
+ * @param snapshotsKept	Number of frames to keep the population of, at
+ * 			most framesKept.
+ * @param popSize	Size of the population.
+ * @param edgeOfWorld	X and Y coordinates of the maximum extent of the
+ * 			simulated space.
+ * @param numStrips	Number of strips in the profiles of the steps; strips
+ * 			past it are left out.
+ * @return		A recorder that has seen no frames.
+ */
+FlightRecorder::FlightRecorder(const string& pathPrefix, float slowFrameMs, unsigned int framesKept, unsigned int snapshotsKept, unsigned int popSize, const Point& edgeOfWorld, unsigned int numStrips){
+	prefix = pathPrefix;
+	slowFrame = slowFrameMs;
+	frames.resize(framesKept > 0 ? framesKept : 1);
+	for(unsigned int f = 0; f < frames.size(); f++){
+		StepProfile& profile = frames[f].profile;
+		profile.stripStart.resize(numStrips);
+		profile.stripEnd.resize(numStrips);
+		profile.residents.resize(numStrips);
+		profile.haloSizes.resize(numStrips);
+		frames[f].numStrips = 0;
+	}
+	framesSeen = 0;
+	snapshots.resize(snapshotsKept < frames.size() ? snapshotsKept : frames.size());
+	for(unsigned int s = 0; s < snapshots.size(); s++){
+		snapshots[s].resize(popSize);
+	}
+	snapshotFrames.resize(snapshots.size());
+	snapshotsTaken = 0;
+	numBoids = popSize;
+	edges = edgeOfWorld;
+	origin = chrono::steady_clock::now();
+	phaseStart = origin;
+	nextDump = 0;
+}
+
+/**
+ * Starts a frame, and takes a snapshot of the population it starts from.
+ * The snapshot is the first phase of the frame.
+ *
+ * @param frame	Number of the frame.
+ * @param pop	The population, in any order.
+ */
+void FlightRecorder::beginFrame(unsigned long frame, const vector<Boid>& pop){
+	Frame& current = frames[framesSeen % frames.size()];
+	current.number = frame;
+	current.start = chrono::steady_clock::now();
+	current.duration = 0.0;
+	current.numPhases = 0;
+	current.numCounters = 0;
+	current.profiled = false;
+	phaseStart = current.start;
+
+	if(!snapshots.empty()){
+		vector<TrajectoryRecord>& snapshot = snapshots[snapshotsTaken % snapshots.size()];
+		if(numBoids > 0){
+			memset(&snapshot[0], 0, numBoids*sizeof(TrajectoryRecord));
+		}
+		for(unsigned int i = 0; i < pop.size(); i++){
+			unsigned int id = pop[i].getId();
+			if(id < numBoids){
+				Point coords = pop[i].getCoordinates();
+				Vector velocity = pop[i].getVelocity();
+				TrajectoryRecord record = {(float) coords.x, (float) coords.y, (float) velocity.x, (float) velocity.y};
+				snapshot[id] = record;
+			}
+		}
+		snapshotFrames[snapshotsTaken % snapshots.size()] = frame;
+		snapshotsTaken++;
+		endPhase("snapshot");
+	}
+}
+
+/**
+ * Ends a phase of the frame, which started where the last one ended.
+ *
+ * @param name	Name of the phase; a string literal. Phases past
+ * 		FLIGHT_PHASES per frame are left out.
+ */
+void FlightRecorder::endPhase(const char* name){
+	Frame& current = frames[framesSeen % frames.size()];
+	chrono::steady_clock::time_point now = chrono::steady_clock::now();
+	if(current.numPhases < FLIGHT_PHASES){
+		Phase phase = {name, chrono::duration<float, milli>(phaseStart - current.start).count(), chrono::duration<float, milli>(now - current.start).count()};
+		current.phases[current.numPhases++] = phase;
+	}
+	phaseStart = now;
+}
+
+/**
+ * Keeps a counter of the frame.
+ *
+ * @param name	Name of the counter; a string literal. Counters past
+ * 		FLIGHT_COUNTERS per frame are left out.
+ * @param value	Its value.
+ */
+void FlightRecorder::count(const char* name, double value){
+	Frame& current = frames[framesSeen % frames.size()];
+	if(current.numCounters < FLIGHT_COUNTERS){
+		Counter counter = {name, value};
+		current.counters[current.numCounters++] = counter;
+	}
+}
+
+/**
+ * Keeps the timings of the step of the frame.
+ *
+ * @param profile	Where the time of the step went.
+ */
+void FlightRecorder::addProfile(const StepProfile& profile){
+	/* Copied field by field into the storage of the slot, since
+	 * assigning the vectors could allocate.
+	 */
+	Frame& current = frames[framesSeen % frames.size()];
+	StepProfile& kept = current.profile;
+	kept.start = profile.start;
+	kept.exported = profile.exported;
+	kept.advanced = profile.advanced;
+	kept.immigrated = profile.immigrated;
+	current.numStrips = profile.stripStart.size() < kept.stripStart.size() ? profile.stripStart.size() : kept.stripStart.size();
+	copy(profile.stripStart.begin(), profile.stripStart.begin() + current.numStrips, kept.stripStart.begin());
+	copy(profile.stripEnd.begin(), profile.stripEnd.begin() + current.numStrips, kept.stripEnd.begin());
+	copy(profile.residents.begin(), profile.residents.begin() + current.numStrips, kept.residents.begin());
+	copy(profile.haloSizes.begin(), profile.haloSizes.begin() + current.numStrips, kept.haloSizes.begin());
+	current.profiled = true;
+}
+
+/**
+ * Ends the frame, and dumps the rings if it took too long.
+ *
+ * @return		true if the rings were dumped.
+ * @throws		std::runtime_error if they couldn't be written.
+ */
+bool FlightRecorder::endFrame(){
+	Frame& current = frames[framesSeen % frames.size()];
+	current.duration = millisecondsSince(current.start);
+	framesSeen++;
+	if(current.duration <= slowFrame || current.number < nextDump){
+		return false;
+	}
+
+	nextDump = current.number + frames.size();
+	dump(current);
+
+	return true;
+}
+
+/**
+ * Getter for the last dump.
+ *
+ * @return	Path of the files of the last dump, but for the extensions;
+ * 		empty if there was none.
+ */
+string FlightRecorder::getLastDump() const{
+	return lastDump;
+}
+
+/**
+ * Writes out both rings.
+ *
+ * @param slow	The frame that took too long, the last one kept.
+ * @throws	std::runtime_error if the files couldn't be written.
+ */
+void FlightRecorder::dump(const Frame& slow){
+	ostringstream base;
+	base << prefix << '-' << slow.number;
+	lastDump = base.str();
+
+	unsigned long kept = snapshotsTaken < snapshots.size() ? snapshotsTaken : snapshots.size();
+	unsigned long firstSnapshot = 0;
+	if(kept > 0){
+		TrajectoryRecorder recorder(lastDump + ".trj", numBoids, edges);
+		for(unsigned long s = snapshotsTaken - kept; s < snapshotsTaken && numBoids > 0; s++){
+			recorder.recordFrame(&snapshots[s % snapshots.size()][0]);
+		}
+		firstSnapshot = snapshotFrames[(snapshotsTaken - kept) % snapshots.size()];
+	}
+	writeTrace(lastDump + ".json", slow, firstSnapshot);
+}
+
+/**
+ * Writes out the ring of frames as a trace, oldest frame first.
+ *
+ * @param path		Path of the trace; overwritten.
+ * @param slow		The frame that took too long.
+ * @param firstSnapshot	Number of the first frame whose population is
+ * 			dumped along with it.
+ * @throws		std::runtime_error if the trace couldn't be written.
+ */
+void FlightRecorder::writeTrace(const string& path, const Frame& slow, unsigned long firstSnapshot) const{
+	ofstream out(path.c_str(), ios::trunc);
+	if(!out){
+		throw runtime_error("Unable to write trace " + path + "!");
+	}
+
+	/* Timestamps are in microseconds since the recorder started.
+	 */
+	out << fixed << setprecision(3);
+	out << "{\"traceEvents\":[" << endl;
+	out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"main loop\"}}";
+	unsigned long kept = framesSeen < frames.size() ? framesSeen : frames.size();
+	unsigned int numStrips = 0;
+	for(unsigned long f = framesSeen - kept; f < framesSeen; f++){
+		const Frame& frame = frames[f % frames.size()];
+		numStrips = frame.profiled && frame.numStrips > numStrips ? frame.numStrips : numStrips;
+	}
+	for(unsigned int p = 0; p < numStrips; p++){
+		out << "," << endl << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << p + 1 << ",\"args\":{\"name\":\"strip " << p << "\"}}";
+	}
+
+	for(unsigned long f = framesSeen - kept; f < framesSeen; f++){
+		const Frame& frame = frames[f % frames.size()];
+		double start = chrono::duration<double, micro>(frame.start - origin).count();
+		out << "," << endl << "{\"name\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":0,\"ts\":" << start << ",\"dur\":" << frame.duration*1000.0
+			<< ",\"args\":{\"frame\":" << frame.number << "}}";
+		for(unsigned int p = 0; p < frame.numPhases; p++){
+			const Phase& phase = frame.phases[p];
+			out << "," << endl << "{\"name\":\"" << phase.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":0,\"ts\":" << start + phase.start*1000.0
+				<< ",\"dur\":" << (phase.end - phase.start)*1000.0 << "}";
+		}
+
+		/* The phases of the step nest inside whichever phase of the
+		 * frame ran it, and the strips run on tracks of their own.
+		 */
+		if(frame.profiled){
+			const StepProfile& profile = frame.profile;
+			double stepStart = chrono::duration<double, micro>(profile.start - origin).count();
+			const char* names[] = {"export edges", "advance", "immigrate"};
+			float ends[] = {0.0, profile.exported, profile.advanced, profile.immigrated};
+			for(unsigned int p = 0; p < 3; p++){
+				out << "," << endl << "{\"name\":\"" << names[p] << "\",\"ph\":\"X\",\"pid\":1,\"tid\":0,\"ts\":" << stepStart + ends[p]*1000.0
+					<< ",\"dur\":" << (ends[p + 1] - ends[p])*1000.0 << "}";
+			}
+			for(unsigned int p = 0; p < frame.numStrips; p++){
+				out << "," << endl << "{\"name\":\"advance\",\"ph\":\"X\",\"pid\":1,\"tid\":" << p + 1 << ",\"ts\":" << stepStart + profile.stripStart[p]*1000.0
+					<< ",\"dur\":" << (profile.stripEnd[p] - profile.stripStart[p])*1000.0
+					<< ",\"args\":{\"residents\":" << profile.residents[p] << ",\"halo\":" << profile.haloSizes[p] << "}}";
+			}
+		}
+
+		for(unsigned int c = 0; c < frame.numCounters; c++){
+			out << "," << endl << "{\"name\":\"" << frame.counters[c].name << "\",\"ph\":\"C\",\"pid\":1,\"ts\":" << start
+				<< ",\"args\":{\"value\":" << frame.counters[c].value << "}}";
+		}
+	}
+
+	out << endl << "]," << endl << "\"displayTimeUnit\":\"ms\"," << endl;
+	out << "\"otherData\":{\"slow frame\":" << slow.number << ",\"milliseconds\":" << slow.duration << ",\"budget\":" << slowFrame
+		<< ",\"snapshots\":\"" << lastDump << ".trj\",\"first snapshot frame\":" << firstSnapshot << "}}" << endl;
+	if(!out){
+		throw runtime_error("Unable to write trace " + path + "!");
+	}
+}
+
+/**
+ * Time taken so far.
+ *
+ * @param start	When it started.
+ * @return	Milliseconds since then.
+ */
+float FlightRecorder::millisecondsSince(const chrono::steady_clock::time_point& start) const{
+	return chrono::duration<float, milli>(chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,106 @@
+/**
+ * \file FlightRecorder.h
+ *
+ * Keeps the recent history of a run, and writes it out when a frame takes too
+ * long. See implementation for more details.
+ *
+ * @since	2026-10-18
+ * @see		FlightRecorder.cpp
+ */
+
+/* Idempotency.
+ */
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+/**
+ * Includes.
+ */
+#include <vector>
+#include <string>
+#include <chrono>
+#include "Simulation.h"
+#include "TrajectoryFile.h"
+#include "Boid.h"
+
+/**
+ * Definitions.
+ */
+#define FLIGHT_PHASES 16	// Most phases timed per frame
+#define FLIGHT_COUNTERS 16	// Most counters kept per frame
+
+using namespace std;
+
+class FlightRecorder {
+	public:
+		FlightRecorder(const string& pathPrefix, float slowFrameMs, unsigned int framesKept, unsigned int snapshotsKept, unsigned int popSize, const Point& edgeOfWorld, unsigned int numStrips);
+
+		void beginFrame(unsigned long frame, const vector<Boid>& pop);
+		void endPhase(const char* name);
+		void count(const char* name, double value);
+		void addProfile(const StepProfile& profile);
+		bool endFrame();
+		string getLastDump() const;
+
+	protected:
+		/**
+		 * A phase of a frame, in milliseconds from its start.
+		 */
+		struct Phase {
+			const char* name;	// Not copied: must be a literal.
+			float start;
+			float end;
+		};
+
+		/**
+		 * A counter of a frame.
+		 */
+		struct Counter {
+			const char* name;	// Not copied: must be a literal.
+			double value;
+		};
+
+		/**
+		 * Everything kept about a frame.
+		 */
+		struct Frame {
+			unsigned long number;
+			chrono::steady_clock::time_point start;
+			float duration;		// Milliseconds.
+			unsigned int numPhases;
+			Phase phases[FLIGHT_PHASES];
+			unsigned int numCounters;
+			Counter counters[FLIGHT_COUNTERS];
+			bool profiled;		// Whether profile holds the step of the frame.
+			StepProfile profile;	// Sized up front; see addProfile().
+			unsigned int numStrips;	// Of the profile that are in use.
+		};
+
+		void dump(const Frame& slow);
+		void writeTrace(const string& path, const Frame& slow, unsigned long firstSnapshot) const;
+		float millisecondsSince(const chrono::steady_clock::time_point& start) const;
+
+		/* Properties.
+		 */
+		string prefix;
+		float slowFrame;		// Milliseconds a frame may take before it is dumped.
+		vector<Frame> frames;		// Ring of the latest frames.
+		unsigned long framesSeen;
+		vector<vector<TrajectoryRecord> > snapshots;	// Ring of the populations the latest frames started from.
+		vector<unsigned long> snapshotFrames;
+		unsigned long snapshotsTaken;
+		unsigned int numBoids;
+		Point edges;
+		chrono::steady_clock::time_point origin;	// Of the trace.
+		chrono::steady_clock::time_point phaseStart;
+		unsigned long nextDump;		// First frame that may be dumped.
+		string lastDump;
+
+	private:
+		FlightRecorder(const FlightRecorder&);
+		FlightRecorder& operator=(const FlightRecorder&);
+};
+
+/* End idempotency.
+ */
+#endif
@@ -0,0 +1,165 @@
+/**
+ * \file	Integrator.cpp
+ *
+ * Moves a whole group of Boids once their accelerations are known: updates
+ * the velocity, subject to Stokes drag, moves them, and keeps them inside
+ * the world, all in one sweep over the Kinematics arrays.
+ *
+ * The sweep has no branches, and its arrays never overlap, so that the
+ * compiler can vectorize it (this file is built with VFLAGS, see the
+ * Makefile, which lets it turn the selects into masks). It does a handful of
+ * operations per number it loads, so it runs about as fast as memory can
+ * deliver the arrays. Boids that escape a walled world anyway are only
+ * counted, and left to the caller to deal with.
+ *
+ * The arithmetic is that of Boid::step() and Boid::wrappedStep(), with the
+ * drag folded in: F_d = -C_d*v. Time steps other than 1 (explicit Euler,
+ * like the rest) are for cheap approximations of several steps at once, see
+ * Parareal.cpp; a time step of 1 gives exactly the same numbers as before
+ * there were any.
+ *
+ * @since	2026-10-18
+ */
+
+/**
+ * Includes.
+ */
+#include "Integrator.h"
+
+/**
+ * Makes room for a group of Boids.
+ *
+ * @param motion	The arrays.
+ * @param numBoids	Number of Boids in the group.
+ */
+void resizeKinematics(Kinematics& motion, unsigned int numBoids){
+	motion.x.resize(numBoids);
+	motion.y.resize(numBoids);
+	motion.vx.resize(numBoids);
+	motion.vy.resize(numBoids);
+	motion.ax.resize(numBoids);
+	motion.ay.resize(numBoids);
+}
+
+/**
+ * Sweep of integrate() for a world that wraps around.
+ *
+ * Wrap-around happens at whole pixels, like in Boid::wrappedStep().
+ *
+ * @param x, y		Positions, updated.
+ * @param vx, vy	Velocities, updated.
+ * @param ax, ay	Accelerations.
+ * @param numBoids	Number of Boids.
+ * @param keep		Part of the velocity that survives the drag.
+ * @param dt		Time step.
+ * @param wrapX		Where the world wraps around in the X direction.
+ * @param wrapY		Where the world wraps around in the Y direction.
+ */
+static void wrappedSweep(double* __restrict__ x, double* __restrict__ y, double* __restrict__ vx, double* __restrict__ vy, const double* __restrict__ ax, const double* __restrict__ ay, unsigned int numBoids, double keep, double dt, double wrapX, double wrapY){
+	for(unsigned int i = 0; i < numBoids; i++){
+		double novelVx = keep*vx[i] + dt*ax[i];
+		double novelVy = keep*vy[i] + dt*ay[i];
+		double novelX = x[i] + dt*novelVx;
+		double novelY = y[i] + dt*novelVy;
+		novelX += (novelX < 0.0 ? wrapX : 0.0) - (novelX > wrapX ? wrapX : 0.0);
+		novelY += (novelY < 0.0 ? wrapY : 0.0) - (novelY > wrapY ? wrapY : 0.0);
+		vx[i] = novelVx;
+		vy[i] = novelVy;
+		x[i] = novelX;
+		y[i] = novelY;
+	}
+}
+
+/**
+ * Sweep of integrate() for a walled world.
+ *
+ * @param x, y		Positions, updated.
+ * @param vx, vy	Velocities, updated.
+ * @param ax, ay	Accelerations.
+ * @param numBoids	Number of Boids.
+ * @param keep		Part of the velocity that survives the drag.
+ * @param dt		Time step.
+ * @param maxX		Edge of the world in the X direction.
+ * @param maxY		Edge of the world in the Y direction.
+ * @return		Number of Boids outside the world afterwards.
+ */
+static double walledSweep(double* __restrict__ x, double* __restrict__ y, double* __restrict__ vx, double* __restrict__ vy, const double* __restrict__ ax, const double* __restrict__ ay, unsigned int numBoids, double keep, double dt, double maxX, double maxY){
+	/* Counted in a double, as the comparisons are doubles wide, too.
+	 */
+	double numEscaped = 0.0;
+	for(unsigned int i = 0; i < numBoids; i++){
+		double novelVx = keep*vx[i] + dt*ax[i];
+		double novelVy = keep*vy[i] + dt*ay[i];
+		double novelX = x[i] + dt*novelVx;
+		double novelY = y[i] + dt*novelVy;
+
+		/* Reflect about the edge that was crossed, if any: a crossing
+		 * maps x to 2*edge - x, and flips the velocity. Selects
+		 * rather than branches.
+		 */
+		double crossedX = novelX < 0.0 || novelX > maxX ? 1.0 : 0.0;
+		double crossedY = novelY < 0.0 || novelY > maxY ? 1.0 : 0.0;
+		double edgeX = novelX > maxX ? maxX : 0.0;
+		double edgeY = novelY > maxY ? maxY : 0.0;
+		novelX += crossedX*(2.0*(edgeX - novelX));
+		novelY += crossedY*(2.0*(edgeY - novelY));
+		novelVx -= crossedX*(2.0*novelVx);
+		novelVy -= crossedY*(2.0*novelVy);
+
+		vx[i] = novelVx;
+		vy[i] = novelVy;
+		x[i] = novelX;
+		y[i] = novelY;
+		numEscaped += novelX >= 0.0 && novelX <= maxX && novelY >= 0.0 && novelY <= maxY ? 0.0 : 1.0;
+	}
+
+	return numEscaped;
+}
+
+/**
+ * Advances a group of Boids one tic.
+ *
+ * In a walled world, Boids that fly past an edge are reflected about it,
+ * elastically. Those that are still outside after that (e.g. at very high
+ * velocities, or when the numbers have gone bad) have escaped, and are
+ * counted; hasEscaped() tells which. In a wrapped world, they come back in
+ * on the other side.
+ *
+ * @param motion	Positions, velocities and accelerations; the
+ * 			positions and velocities are updated.
+ * @param numBoids	Number of Boids in the group.
+ * @param edges		X and Y coordinates of the maximum extent of the
+ * 			simulated space.
+ * @param wrapped	true if the edges of the world wrap around.
+ * @param drag		Coefficient of drag.
+ * @param timeStep	Length of the tic; 1 for a regular step.
+ * @return		Number of Boids that escaped.
+ */
+unsigned int integrate(Kinematics& motion, unsigned int numBoids, const Point& edges, bool wrapped, double drag, double timeStep){
+	if(numBoids == 0){
+		return 0;
+	}
+
+	if(wrapped){
+		wrappedSweep(&motion.x[0], &motion.y[0], &motion.vx[0], &motion.vy[0], &motion.ax[0], &motion.ay[0], numBoids, 1.0 - drag*timeStep, timeStep, (int) edges.x, (int) edges.y);
+		return 0;
+	}
+
+	return (unsigned int) walledSweep(&motion.x[0], &motion.y[0], &motion.vx[0], &motion.vy[0], &motion.ax[0], &motion.ay[0], numBoids, 1.0 - drag*timeStep, timeStep, edges.x, edges.y);
+}
+
+/**
+ * Checks whether a Boid is outside a walled world, e.g. after integrate().
+ *
+ * @param motion	Positions of the group.
+ * @param boid		Index of the Boid in the group.
+ * @param edges		X and Y coordinates of the maximum extent of the
+ * 			simulated space.
+ * @return		true if it is outside, or its position is not a
+ * 			number.
+ */
+bool hasEscaped(const Kinematics& motion, unsigned int boid, const Point& edges){
+	double x = motion.x[boid], y = motion.y[boid];
+
+	return !(x >= 0.0 && x <= edges.x && y >= 0.0 && y <= edges.y);
+}
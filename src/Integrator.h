@@ -0,0 +1,46 @@
+/**
+ * \file Integrator.h
+ *
+ * Moves a whole group of Boids once their accelerations are known. See
+ * implementation for more details.
+ *
+ * @since	2026-10-18
+ * @see		Integrator.cpp
+ */
+
+/* Idempotency.
+ */
+#ifndef INTEGRATOR_H
+#define INTEGRATOR_H
+
+/**
+ * Includes.
+ */
+#include <vector>
+#include "Boid.h"
+
+/**
+ * Definitions.
+ */
+using namespace std;
+
+/**
+ * Motion of a group of Boids, one array per component, so that the group can
+ * be moved in one sweep.
+ */
+struct Kinematics {
+	vector<double> x;
+	vector<double> y;
+	vector<double> vx;
+	vector<double> vy;
+	vector<double> ax;	// Acceleration, drag not included.
+	vector<double> ay;
+};
+
+void resizeKinematics(Kinematics& motion, unsigned int numBoids);
+unsigned int integrate(Kinematics& motion, unsigned int numBoids, const Point& edges, bool wrapped, double drag, double timeStep);
+bool hasEscaped(const Kinematics& motion, unsigned int boid, const Point& edges);
+
+/* End idempotency.
+ */
+#endif
@@ -0,0 +1,180 @@
+/**
+ * \file	LZCodec.cpp
+ *
+ * Small, fast LZ77 byte compressor, in the spirit of LZ4.
+ *
+ * The compressed stream is a series of sequences, each a run of literal
+ * bytes followed by a match: a copy of earlier output at some offset. A
+ * sequence starts with a token byte holding both lengths in a nibble each
+ * (15 meaning that more length bytes follow, 255 at a time), then the
+ * literals, then the offset in two bytes. The last sequence has literals
+ * only. Matches are found through a hash table of the positions of recent
+ * four-byte strings, so compression takes a single pass with no searching.
+ *
+ * @since	2026-10-18
+ */
+
+/**
+ * Includes.
+ */
+#include "LZCodec.h"
+#include <string.h>
+
+/**
+ * Definitions.
+ */
+#define MIN_MATCH 4
+#define MAX_OFFSET 65535
+#define HASH_BITS 14
+
+/**
+ * Appends a length that didn't fit in its nibble.
+ *
+ * @param length	What is left of the length after the nibble.
+ * @param out		Stream to append to.
+ */
+static void appendLength(size_t length, vector<unsigned char>& out){
+	while(length >= 255){
+		out.push_back(255);
+		length -= 255;
+	}
+	out.push_back(length);
+}
+
+/**
+ * Appends a sequence.
+ *
+ * @param literals	Literal bytes.
+ * @param numLiterals	Number of literal bytes.
+ * @param offset	Distance back to the match, or 0 for the last
+ * 			sequence (which has no match).
+ * @param matchLength	Length of the match.
+ * @param out		Stream to append to.
+ */
+static void appendSequence(const unsigned char* literals, size_t numLiterals, size_t offset, size_t matchLength, vector<unsigned char>& out){
+	size_t extraMatch = offset > 0 ? matchLength - MIN_MATCH : 0;
+	out.push_back((numLiterals < 15 ? numLiterals : 15) << 4 | (extraMatch < 15 ? extraMatch : 15));
+	if(numLiterals >= 15){
+		appendLength(numLiterals - 15, out);
+	}
+	out.insert(out.end(), literals, literals + numLiterals);
+	if(offset > 0){
+		out.push_back(offset & 0xff);
+		out.push_back(offset >> 8);
+		if(extraMatch >= 15){
+			appendLength(extraMatch - 15, out);
+		}
+	}
+}
+
+/**
+ * Compresses a block of bytes.
+ *
+ * @param in		The bytes.
+ * @param numBytes	Number of bytes.
+ * @param out		Cleared and filled with the compressed stream.
+ */
+void lzCompress(const unsigned char* in, size_t numBytes, vector<unsigned char>& out){
+	vector<long> recent(1 << HASH_BITS, -1);
+	size_t anchor = 0;
+	size_t i = 0;
+
+	out.clear();
+	while(i + MIN_MATCH <= numBytes){
+		unsigned int word;
+		memcpy(&word, in + i, sizeof(word));
+		unsigned int hash = (word * 2654435761u) >> (32 - HASH_BITS);
+		long candidate = recent[hash];
+		recent[hash] = i;
+
+		if(candidate >= 0 && i - candidate <= MAX_OFFSET && memcmp(in + candidate, in + i, MIN_MATCH) == 0){
+			size_t length = MIN_MATCH;
+			while(i + length < numBytes && in[candidate + length] == in[i + length]){
+				length++;
+			}
+			appendSequence(in + anchor, i - anchor, i - candidate, length, out);
+			i += length;
+			anchor = i;
+		}
+		else{
+			i++;
+		}
+	}
+	appendSequence(in + anchor, numBytes - anchor, 0, 0, out);
+}
+
+/**
+ * Reads a length that didn't fit in its nibble.
+ *
+ * @param in		The compressed stream.
+ * @param numBytes	Size of the stream.
+ * @param i		Position in the stream; moved past the length.
+ * @param length	The length, added to.
+ * @return		false if the stream ends in the middle.
+ */
+static bool readLength(const unsigned char* in, size_t numBytes, size_t& i, size_t& length){
+	unsigned char next;
+	do{
+		if(i >= numBytes){
+			return false;
+		}
+		next = in[i++];
+		length += next;
+	}while(next == 255);
+
+	return true;
+}
+
+/**
+ * Decompresses a block of bytes.
+ *
+ * @param in		The compressed stream.
+ * @param numBytes	Size of the stream.
+ * @param rawBytes	Size of the block before compression.
+ * @param out		Cleared and filled with the block.
+ * @return		false if the stream is corrupt.
+ */
+bool lzDecompress(const unsigned char* in, size_t numBytes, size_t rawBytes, vector<unsigned char>& out){
+	size_t i = 0;
+
+	out.clear();
+	out.reserve(rawBytes);
+	while(i < numBytes){
+		unsigned char token = in[i++];
+		size_t numLiterals = token >> 4;
+		if(numLiterals == 15 && !readLength(in, numBytes, i, numLiterals)){
+			return false;
+		}
+		if(i + numLiterals > numBytes || out.size() + numLiterals > rawBytes){
+			return false;
+		}
+		out.insert(out.end(), in + i, in + i + numLiterals);
+		i += numLiterals;
+		if(i == numBytes){
+			break;
+		}
+
+		/* The match may overlap what it is copying, so byte by
+		 * byte.
+		 */
+		if(i + 2 > numBytes){
+			return false;
+		}
+		size_t offset = in[i] | in[i+1] << 8;
+		i += 2;
+		size_t length = token & 15;
+		if(length == 15 && !readLength(in, numBytes, i, length)){
+			return false;
+		}
+		length += MIN_MATCH;
+		if(offset == 0 || offset > out.size() || out.size() + length > rawBytes){
+			return false;
+		}
+		size_t from = out.size() - offset;
+		for(size_t k = 0; k < length; k++){
+			out.push_back(out[from + k]);
+		}
+	}
+
+	return out.size() == rawBytes;
+}
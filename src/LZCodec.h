@@ -0,0 +1,31 @@
+/**
+ * \file LZCodec.h
+ *
+ * Small, fast LZ77 byte compressor. See implementation for more details.
+ *
+ * @since	2026-10-18
+ * @see		LZCodec.cpp
+ */
+
+/* Idempotency.
+ */
+#ifndef LZ_CODEC_H
+#define LZ_CODEC_H
+
+/**
+ * Includes.
+ */
+#include <vector>
+#include <stddef.h>
+
+/**
+ * Definitions.
+ */
+using namespace std;
+
+void lzCompress(const unsigned char* in, size_t numBytes, vector<unsigned char>& out);
+bool lzDecompress(const unsigned char* in, size_t numBytes, size_t rawBytes, vector<unsigned char>& out);
+
+/* End idempotency.
+ */
+#endif
@@ -0,0 +1,345 @@
+/**
+ * \file	LaneEnsemble.cpp
+ *
+ * Parameter sweeps run many small flocks that differ only in their
+ * coefficients, seeds or destinations. Stepping them one after another
+ * leaves most of each SIMD register idle, since a few dozen Boids seldom
+ * fill it. Here ENSEMBLE_LANES such flocks are interleaved instead, Boid i
+ * of every flock next to each other in memory, and stepped in lockstep:
+ * the innermost loop of every rule runs across the flocks, always the same
+ * length and with no branches, so that the compiler unrolls and vectorizes
+ * it (this file is built with VFLAGS, see the Makefile) and one core
+ * advances the whole batch at about the cost of one flock.
+ *
+ * The flocks must have the same number of Boids and share a world with
+ * walls and a perception cutoff. Each flies by coefficients of its own and
+ * respawns its escaped Boids from a random sequence of its own. The rules
+ * are those of SmallFlock.cpp, in double precision throughout, and the
+ * motion is that of Integrator.cpp, which runs on the interleaved arrays as
+ * they are.
+ *
+ * @since	2026-10-18
+ */
+
+/**
+ * Includes.
+ */
+#include <stdexcept>
+#include <stdlib.h>
+#include <math.h>
+#include "LaneEnsemble.h"
+
+/**
+ * Definitions.
+ */
+static_assert(PERCEPTION_FALL_OFF == 2.75, "laneSums() works out the perception for a fall-off of 2.75");
+
+/**
+ * What every lane's Boid makes of its flockmates, summed up, one entry per
+ * lane.
+ */
+struct LaneSums {
+	double positionX[ENSEMBLE_LANES];	// Weighted by perception.
+	double positionY[ENSEMBLE_LANES];	// Weighted by perception.
+	double velocityX[ENSEMBLE_LANES];	// Weighted by perception.
+	double velocityY[ENSEMBLE_LANES];	// Weighted by perception.
+	double perception[ENSEMBLE_LANES];
+	double separationX[ENSEMBLE_LANES];
+	double separationY[ENSEMBLE_LANES];
+	double flockmates[ENSEMBLE_LANES];
+};
+
+/**
+ * Sums up the flockmates of Boid self in every lane.
+ *
+ * Flockmates beyond the cutoff are masked out by a factor of 0, as in
+ * SmallFlock.cpp, so every lane goes through the same arithmetic.
+ *
+ * @param self		Index of the Boid.
+ * @param numBoids	Number of Boids per lane.
+ * @param x, y		Interleaved positions.
+ * @param vx, vy	Interleaved velocities.
+ * @param cutoffSquared	Square of the perception cutoff.
+ * @param sums		Filled with the sums.
+ */
+static void laneSums(unsigned int self, unsigned int numBoids, const double* __restrict__ x, const double* __restrict__ y, const double* __restrict__ vx, const double* __restrict__ vy, double cutoffSquared, LaneSums& sums){
+	double selfX[ENSEMBLE_LANES], selfY[ENSEMBLE_LANES];
+	double positionX[ENSEMBLE_LANES], positionY[ENSEMBLE_LANES], velocityX[ENSEMBLE_LANES], velocityY[ENSEMBLE_LANES];
+	double perception[ENSEMBLE_LANES], separationX[ENSEMBLE_LANES], separationY[ENSEMBLE_LANES], flockmates[ENSEMBLE_LANES];
+	for(unsigned int l = 0; l < ENSEMBLE_LANES; l++){
+		selfX[l] = x[self*ENSEMBLE_LANES + l];
+		selfY[l] = y[self*ENSEMBLE_LANES + l];
+		positionX[l] = positionY[l] = velocityX[l] = velocityY[l] = 0.0;
+		perception[l] = separationX[l] = separationY[l] = flockmates[l] = 0.0;
+	}
+
+	for(unsigned int j = 0; j < numBoids; j++){
+		if(j == self){
+			continue;
+		}
+		const double* flockmateX = x + j*ENSEMBLE_LANES;
+		const double* flockmateY = y + j*ENSEMBLE_LANES;
+		const double* flockmateVX = vx + j*ENSEMBLE_LANES;
+		const double* flockmateVY = vy + j*ENSEMBLE_LANES;
+		for(unsigned int l = 0; l < ENSEMBLE_LANES; l++){
+			double dx = selfX[l] - flockmateX[l];
+			double dy = selfY[l] - flockmateY[l];
+			double distSquared = dx*dx + dy*dy;
+			double dist = sqrt(distSquared);
+			double rootDist = sqrt(dist);
+			double seen = 1.0/(distSquared*rootDist*sqrt(rootDist));
+			double flockmate = distSquared <= cutoffSquared ? 1.0 : 0.0;
+
+			double weight = flockmate*(seen < 1.0 ? seen : 1.0);
+			positionX[l] += weight*flockmateX[l];
+			positionY[l] += weight*flockmateY[l];
+			velocityX[l] += weight*flockmateVX[l];
+			velocityY[l] += weight*flockmateVY[l];
+			perception[l] += weight;
+
+			double push = flockmate*(dist > 0.0 ? COLLISION_DIST/(distSquared*dist) : 0.0);
+			separationX[l] += push*dx;
+			separationY[l] += push*dy;
+
+			flockmates[l] += flockmate;
+		}
+	}
+
+	for(unsigned int l = 0; l < ENSEMBLE_LANES; l++){
+		sums.positionX[l] = positionX[l];
+		sums.positionY[l] = positionY[l];
+		sums.velocityX[l] = velocityX[l];
+		sums.velocityY[l] = velocityY[l];
+		sums.perception[l] = perception[l];
+		sums.separationX[l] = separationX[l];
+		sums.separationY[l] = separationY[l];
+		sums.flockmates[l] = flockmates[l];
+	}
+}
+
+/**
+ * Works out the acceleration Boid self steers itself with in every lane,
+ * as the rules of BehaviorRules.h do.
+ *
+ * @param self		Index of the Boid.
+ * @param motion	Interleaved state; the acceleration of the Boid,
+ * 			drag not included, is set.
+ * @param destX, destY	Destination of every lane.
+ * @param cohesion, separation, alignment, attraction	Coefficients of
+ * 			every lane.
+ * @param sums		Sums over the Boid's flockmates.
+ */
+static void laneAccelerations(unsigned int self, Kinematics& motion, const double* __restrict__ destX, const double* __restrict__ destY, const double* __restrict__ cohesion, const double* __restrict__ separation, const double* __restrict__ alignment, const double* __restrict__ attraction, const LaneSums& sums){
+	const double* __restrict__ x = &motion.x[self*ENSEMBLE_LANES];
+	const double* __restrict__ y = &motion.y[self*ENSEMBLE_LANES];
+	const double* __restrict__ vx = &motion.vx[self*ENSEMBLE_LANES];
+	const double* __restrict__ vy = &motion.vy[self*ENSEMBLE_LANES];
+	double* __restrict__ ax = &motion.ax[self*ENSEMBLE_LANES];
+	double* __restrict__ ay = &motion.ay[self*ENSEMBLE_LANES];
+	for(unsigned int l = 0; l < ENSEMBLE_LANES; l++){
+		/* Boids with no flockmates in sight have nothing to cohere or
+		 * align with.
+		 */
+		double seen = sums.flockmates[l] > 0.0 ? 1.0 : 0.0;
+		double perception = sums.perception[l] + 1.0 - seen;
+		double cohesionX = seen*(sums.positionX[l]/perception - x[l]);
+		double cohesionY = seen*(sums.positionY[l]/perception - y[l]);
+		double alignmentX = seen*(sums.velocityX[l]/perception - vx[l]);
+		double alignmentY = seen*(sums.velocityY[l]/perception - vy[l]);
+
+		double dx = x[l] - destX[l], dy = y[l] - destY[l];
+		double dist = sqrt(dx*dx + dy*dy);
+		double away = dist > 0.0 ? 1.0 : 0.0;
+		double pull = away/((1.0 + DESTINATION_DECAY*dist)*(dist + 1.0 - away));
+		double attractionX = -pull*dx;
+		double attractionY = -pull*dy;
+
+		ax[l] = cohesion[l]*cohesionX + separation[l]*sums.separationX[l] + alignment[l]*alignmentX + attraction[l]*attractionX;
+		ay[l] = cohesion[l]*cohesionY + separation[l]*sums.separationY[l] + alignment[l]*alignmentY + attraction[l]*attractionY;
+	}
+}
+
+/**
+ * Constructor from values.
+ *
+ * Lanes past the given flocks are filled with copies of the first, so that
+ * the arithmetic in them stays tame; they are stepped but never reported.
+ *
+ * @param populations		Population of every lane, at most
+ * 				ENSEMBLE_LANES of them, all of the same size.
+ * @param laneCoefficients	Coefficients of every lane.
+ * @param laneSeeds		Seed of every lane, for respawning.
+ * @param edgeOfWorld		X and Y coordinates of the maximum extent of
+ * 				the simulated space, which has walls.
+ * @return			A fully specified object.
+ * @throws			std::runtime_error if the lanes don't fit.
+ */
+LaneEnsemble::LaneEnsemble(const vector<vector<Boid> >& populations, const vector<RuleCoefficients>& laneCoefficients, const vector<unsigned int>& laneSeeds, const Point& edgeOfWorld){
+	numLanes = populations.size();
+	if(numLanes == 0 || numLanes > ENSEMBLE_LANES || laneCoefficients.size() != numLanes || laneSeeds.size() != numLanes){
+		throw runtime_error("An ensemble takes 1 to " + to_string(ENSEMBLE_LANES) + " lanes");
+	}
+	numBoids = populations[0].size();
+	edges = edgeOfWorld;
+
+	resizeKinematics(motion, numBoids*ENSEMBLE_LANES);
+	ids.resize(numBoids*ENSEMBLE_LANES);
+	for(unsigned int l = 0; l < ENSEMBLE_LANES; l++){
+		unsigned int source = l < numLanes ? l : 0;
+		const vector<Boid>& pop = populations[source];
+		if(pop.size() != numBoids){
+			throw runtime_error("The lanes of an ensemble must have the same number of Boids");
+		}
+		cohesion[l] = laneCoefficients[source].cohesion;
+		separation[l] = laneCoefficients[source].separation;
+		alignment[l] = laneCoefficients[source].alignment;
+		attraction[l] = laneCoefficients[source].attraction;
+		seeds[l] = laneSeeds[source];
+
+		ObservableSums sums;
+		clearSums(sums);
+		for(unsigned int i = 0; i < numBoids; i++){
+			unsigned int slot = i*ENSEMBLE_LANES + l;
+			motion.x[slot] = pop[i].getCoordinates().x;
+			motion.y[slot] = pop[i].getCoordinates().y;
+			motion.vx[slot] = pop[i].getVelocity().x;
+			motion.vy[slot] = pop[i].getVelocity().y;
+			motion.ax[slot] = motion.ay[slot] = 0.0;
+			ids[slot] = pop[i].getId();
+			addBoid(sums, pop[i], Point(0.0, 0.0), -1.0);
+		}
+		latest[l] = summarizeSums(sums);
+	}
+}
+
+/**
+ * Advances every Boid of every lane one tic.
+ *
+ * Boids that fail to stay inside the world are put back at some random
+ * valid position near the center, at rest.
+ *
+ * @param destinations	Coordinates toward which the boids of each lane
+ * 			should head, one per lane.
+ * @param cutoff	Perception cutoff.
+ * @param observe	true to sum up the order parameters of every lane
+ * 			before the step, for getObservables().
+ */
+void LaneEnsemble::step(const vector<Point>& destinations, float cutoff, bool observe){
+	double cutoffSquared = (double) cutoff*cutoff;
+	if(observe){
+		observeLanes(cutoffSquared);
+	}
+
+	double destX[ENSEMBLE_LANES], destY[ENSEMBLE_LANES];
+	for(unsigned int l = 0; l < ENSEMBLE_LANES; l++){
+		const Point& destination = destinations[l < numLanes ? l : 0];
+		destX[l] = destination.x;
+		destY[l] = destination.y;
+	}
+
+	LaneSums sums;
+	for(unsigned int i = 0; i < numBoids; i++){
+		laneSums(i, numBoids, &motion.x[0], &motion.y[0], &motion.vx[0], &motion.vy[0], cutoffSquared, sums);
+		laneAccelerations(i, motion, destX, destY, cohesion, separation, alignment, attraction, sums);
+	}
+
+	if(integrate(motion, numBoids*ENSEMBLE_LANES, edges, false, DRAG_COEFFICIENT, 1.0) > 0){
+		for(unsigned int i = 0; i < numBoids; i++){
+			for(unsigned int l = 0; l < ENSEMBLE_LANES; l++){
+				unsigned int slot = i*ENSEMBLE_LANES + l;
+				if(hasEscaped(motion, slot, edges)){
+					motion.x[slot] = (float) ((int) (edges.x/2) - 100 + rand_r(&seeds[l]) % 200);
+					motion.y[slot] = (float) ((int) (edges.y/2) - 100 + rand_r(&seeds[l]) % 200);
+					motion.vx[slot] = motion.vy[slot] = 0.0;
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Sums up the order parameters of every lane. Only done every so often, so
+ * plainly, lane by lane.
+ *
+ * @param cutoffSquared	Square of the perception cutoff.
+ */
+void LaneEnsemble::observeLanes(double cutoffSquared){
+	for(unsigned int l = 0; l < numLanes; l++){
+		Point centroid(0.0, 0.0);
+		for(unsigned int i = 0; i < numBoids; i++){
+			centroid.x += motion.x[i*ENSEMBLE_LANES + l]/numBoids;
+			centroid.y += motion.y[i*ENSEMBLE_LANES + l]/numBoids;
+		}
+
+		ObservableSums sums;
+		clearSums(sums);
+		for(unsigned int i = 0; i < numBoids; i++){
+			double nearest = -1.0;
+			for(unsigned int j = 0; j < numBoids; j++){
+				double dx = motion.x[i*ENSEMBLE_LANES + l] - motion.x[j*ENSEMBLE_LANES + l];
+				double dy = motion.y[i*ENSEMBLE_LANES + l] - motion.y[j*ENSEMBLE_LANES + l];
+				double distSquared = dx*dx + dy*dy;
+				if(j != i && distSquared <= cutoffSquared && (nearest < 0.0 || distSquared < nearest)){
+					nearest = distSquared;
+				}
+			}
+			addBoid(sums, boidAt(i, l), centroid, nearest);
+		}
+		latest[l] = summarizeSums(sums);
+	}
+}
+
+/**
+ * Makes a Boid out of a slot.
+ *
+ * @param boid	Index of the Boid.
+ * @param lane	Its lane.
+ * @return	The Boid.
+ */
+Boid LaneEnsemble::boidAt(unsigned int boid, unsigned int lane) const{
+	unsigned int slot = boid*ENSEMBLE_LANES + lane;
+	return Boid(Point(motion.x[slot], motion.y[slot]), Vector(motion.vx[slot], motion.vy[slot]), cohesion[lane], separation[lane], alignment[lane], attraction[lane], edges, ids[slot]);
+}
+
+/**
+ * Collects the population of a lane.
+ *
+ * @param lane	The lane.
+ * @param pop	Cleared and filled with every Boid of the lane, in the order
+ * 		they were given in.
+ */
+void LaneEnsemble::getBoids(unsigned int lane, vector<Boid>& pop) const{
+	pop.clear();
+	for(unsigned int i = 0; i < numBoids; i++){
+		pop.push_back(boidAt(i, lane));
+	}
+}
+
+/**
+ * Getter for the order parameters of a lane.
+ *
+ * @param lane	The lane.
+ * @return	Order parameters of the lane as it was at the start of the
+ * 		last step that observed it.
+ */
+Observables LaneEnsemble::getObservables(unsigned int lane) const{
+	return latest[lane];
+}
+
+/**
+ * Getter for the number of lanes.
+ *
+ * @return	The number of flocks given to the constructor.
+ */
+unsigned int LaneEnsemble::lanes() const{
+	return numLanes;
+}
+
+/**
+ * Getter for the size of the population of each lane.
+ *
+ * @return	The number of Boids per lane.
+ */
+unsigned int LaneEnsemble::size() const{
+	return numBoids;
+}
@@ -0,0 +1,72 @@
+/**
+ * \file LaneEnsemble.h
+ *
+ * Several small flocks stepped side by side, one per SIMD lane. See
+ * implementation for more details.
+ *
+ * @since	2026-10-18
+ * @see		LaneEnsemble.cpp
+ */
+
+/* Idempotency.
+ */
+#ifndef LANE_ENSEMBLE_H
+#define LANE_ENSEMBLE_H
+
+/**
+ * Includes.
+ */
+#include <vector>
+#include "BehaviorRules.h"
+#include "Integrator.h"
+#include "Observables.h"
+#include "Boid.h"
+
+/**
+ * Definitions.
+ */
+#define ENSEMBLE_LANES 8 // Flocks stepped side by side
+
+using namespace std;
+
+/**
+ * Up to ENSEMBLE_LANES flocks of the same size in the same world, each with
+ * coefficients, respawn seed and destination of its own, stepped in
+ * lockstep on a single thread.
+ */
+class LaneEnsemble {
+	public:
+		LaneEnsemble(const vector<vector<Boid> >& populations, const vector<RuleCoefficients>& laneCoefficients, const vector<unsigned int>& laneSeeds, const Point& edgeOfWorld);
+
+		void step(const vector<Point>& destinations, float cutoff, bool observe);
+		void getBoids(unsigned int lane, vector<Boid>& pop) const;
+		Observables getObservables(unsigned int lane) const;
+		unsigned int lanes() const;
+		unsigned int size() const;
+
+	protected:
+		void observeLanes(double cutoffSquared);
+		Boid boidAt(unsigned int boid, unsigned int lane) const;
+
+		/* Properties.
+		 */
+		Kinematics motion;	// Boid i of lane l in slot i*ENSEMBLE_LANES + l.
+		vector<unsigned int> ids;	// Same slots.
+		double cohesion[ENSEMBLE_LANES];
+		double separation[ENSEMBLE_LANES];
+		double alignment[ENSEMBLE_LANES];
+		double attraction[ENSEMBLE_LANES];
+		unsigned int seeds[ENSEMBLE_LANES];	// Random state for respawning.
+		Observables latest[ENSEMBLE_LANES];
+		unsigned int numLanes;
+		unsigned int numBoids;
+		Point edges;
+
+	private:
+		LaneEnsemble(const LaneEnsemble&);
+		LaneEnsemble& operator=(const LaneEnsemble&);
+};
+
+/* End idempotency.
+ */
+#endif
@@ -0,0 +1,77 @@
+/**
+ * \file NeighborGraph.h
+ *
+ * Who perceives whom, frame by frame: the neighbor graph of a population in
+ * compressed sparse row (CSR) form, and the layout of the files it is
+ * written to by NeighborGraphWriter.
+ *
+ * A graph file starts with a NeighborGraphHeader, followed by one frame
+ * after the other. Each frame is a NeighborFrameHeader, then numBoids + 1
+ * offsets (unsigned 64-bit), then numEdges flockmate identities (unsigned
+ * 32-bit) and numEdges weights (32-bit floats). The flockmates of the Boid
+ * with identity i are indices[offsets[i]] up to indices[offsets[i+1]], and
+ * the weights are how well it perceives them (1 up close, falling off with
+ * distance), which is what cohesion and alignment weigh them by.
+ *
+ * @since	2026-10-18
+ * @see		NeighborGraphWriter.cpp
+ */
+
+/* Idempotency.
+ */
+#ifndef NEIGHBOR_GRAPH_H
+#define NEIGHBOR_GRAPH_H
+
+/**
+ * Includes.
+ */
+#include <vector>
+
+/**
+ * Definitions.
+ */
+#define NEIGHBOR_GRAPH_MAGIC "FLOCKCSR"
+#define NEIGHBOR_GRAPH_VERSION 1
+
+using namespace std;
+
+/**
+ * Start of a graph file.
+ */
+struct NeighborGraphHeader {
+	char magic[8];
+	unsigned int version;
+	unsigned int numBoids;	// Rows per frame.
+};
+
+/**
+ * Start of a frame in a graph file.
+ */
+struct NeighborFrameHeader {
+	unsigned long long frame;
+	unsigned long long numEdges;
+};
+
+/**
+ * The flockmates of a group of Boids, as they were found while advancing
+ * them, Boid by Boid in the order of the group.
+ */
+struct NeighborLists {
+	vector<unsigned int> boids;	// Identity of each Boid.
+	vector<unsigned int> counts;	// Number of flockmates of each Boid.
+	vector<unsigned int> flockmates;	// Their identities, all lists one after the other.
+	vector<float> weights;		// Their perception weights, likewise.
+};
+
+/**
+ * The neighbor graph of a whole population, in CSR form, by identity.
+ */
+struct NeighborGraph {
+	vector<unsigned long long> offsets;	// numBoids + 1 of them.
+	vector<unsigned int> indices;
+	vector<float> weights;
+};
+
+/* End idempotency.
+ */
+#endif
@@ -0,0 +1,155 @@
+/**
+ * \file	NeighborGraphWriter.cpp
+ *
+ * Writes the neighbor graph of every frame (see NeighborGraph.h) to a file
+ * while the run is being simulated.
+ *
+ * A graph handed to record() is not copied: its storage is swapped into a
+ * frame waiting in line, and the caller gets the storage of a frame that
+ * was written earlier in exchange, so once the run has warmed up nothing is
+ * allocated either. A single thread writes the frames in order. The number
+ * of frames in line is bounded, so if the disk can't keep up the simulation
+ * is held back rather than memory running out.
+ *
+ * @since	2026-10-18
+ */
+
+/**
+ * Includes.
+ */
+#include "NeighborGraphWriter.h"
+#include <stdexcept>
+#include <string.h>
+
+/**
+ * Definitions.
+ */
+#define MAX_PENDING_FRAMES 4
+
+/**
+ * Constructor from values. Creates the file and starts the writer thread.
+ *
+ * @param path		Path of the graph file; overwritten.
+ * @param numBoids	Size of the population.
+ * @return		A writer that has written no frames.
+ * @throws		std::runtime_error if the file can't be written.
+ */
+NeighborGraphWriter::NeighborGraphWriter(const string& path, unsigned int numBoids) : out(path.c_str(), ios::binary | ios::trunc){
+	if(!out){
+		throw runtime_error("Unable to write neighbor graph file " + path + "!");
+	}
+
+	NeighborGraphHeader header;
+	memset(&header, 0, sizeof(NeighborGraphHeader));
+	memcpy(header.magic, NEIGHBOR_GRAPH_MAGIC, sizeof(header.magic));
+	header.version = NEIGHBOR_GRAPH_VERSION;
+	header.numBoids = numBoids;
+	out.write((const char*) &header, sizeof(NeighborGraphHeader));
+
+	boids = numBoids;
+	frames = 0;
+	stopping = false;
+	writer = thread(&NeighborGraphWriter::write, this);
+}
+
+/**
+ * Destructor. Writes out the frames still in line and closes the file.
+ */
+NeighborGraphWriter::~NeighborGraphWriter(){
+	{
+		unique_lock<mutex> guard(lock);
+		stopping = true;
+	}
+	work.notify_all();
+	writer.join();
+
+	for(unsigned int i = 0; i < spare.size(); i++){
+		delete spare[i];
+	}
+}
+
+/**
+ * Appends a frame.
+ *
+ * @param frame	Number of the frame.
+ * @param graph	Its neighbor graph, over the whole population. Left with
+ * 		storage to fill with the next frame, and no particular
+ * 		contents.
+ */
+void NeighborGraphWriter::record(unsigned long frame, NeighborGraph& graph){
+	unique_lock<mutex> guard(lock);
+	while(queue.size() >= MAX_PENDING_FRAMES){
+		room.wait(guard);
+	}
+
+	PendingFrame* pending = NULL;
+	if(spare.empty()){
+		pending = new PendingFrame;
+	}
+	else{
+		pending = spare.back();
+		spare.pop_back();
+	}
+	pending->frame = frame;
+	pending->graph.offsets.swap(graph.offsets);
+	pending->graph.indices.swap(graph.indices);
+	pending->graph.weights.swap(graph.weights);
+	queue.push_back(pending);
+	frames++;
+	work.notify_one();
+}
+
+/**
+ * Getter for the number of frames.
+ *
+ * @return	Number of frames recorded so far.
+ */
+unsigned long NeighborGraphWriter::getNumFrames() const{
+	unique_lock<mutex> guard(lock);
+	return frames;
+}
+
+/**
+ * Main loop of the writer thread.
+ */
+void NeighborGraphWriter::write(){
+	unique_lock<mutex> guard(lock);
+	while(true){
+		while(queue.empty() && !stopping){
+			work.wait(guard);
+		}
+		if(queue.empty()){
+			return;
+		}
+
+		PendingFrame* pending = queue.front();
+		queue.pop_front();
+		guard.unlock();
+
+		/* A graph that doesn't cover the population is written as one
+		 * without edges, so the file stays readable.
+		 */
+		const NeighborGraph& graph = pending->graph;
+		bool complete = graph.offsets.size() == boids + 1 && graph.indices.size() == graph.offsets.back() && graph.weights.size() == graph.indices.size();
+		NeighborFrameHeader header;
+		memset(&header, 0, sizeof(NeighborFrameHeader));
+		header.frame = pending->frame;
+		header.numEdges = complete ? graph.indices.size() : 0;
+		out.write((const char*) &header, sizeof(NeighborFrameHeader));
+		if(complete){
+			out.write((const char*) &graph.offsets[0], graph.offsets.size()*sizeof(unsigned long long));
+			if(header.numEdges > 0){
+				out.write((const char*) &graph.indices[0], graph.indices.size()*sizeof(unsigned int));
+				out.write((const char*) &graph.weights[0], graph.weights.size()*sizeof(float));
+			}
+		}
+		else{
+			vector<unsigned long long> none(boids + 1, 0);
+			out.write((const char*) &none[0], none.size()*sizeof(unsigned long long));
+		}
+
+		guard.lock();
+		spare.push_back(pending);
+		room.notify_one();
+	}
+}
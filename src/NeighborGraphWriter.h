@@ -0,0 +1,72 @@
+/**
+ * \file NeighborGraphWriter.h
+ *
+ * Writes the neighbor graphs of a run to a file, in the background. See
+ * implementation for more details.
+ *
+ * @since	2026-10-18
+ * @see		NeighborGraphWriter.cpp
+ */
+
+/* Idempotency.
+ */
+#ifndef NEIGHBOR_GRAPH_WRITER_H
+#define NEIGHBOR_GRAPH_WRITER_H
+
+/**
+ * Includes.
+ */
+#include <vector>
+#include <string>
+#include <deque>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "NeighborGraph.h"
+
+/**
+ * Definitions.
+ */
+using namespace std;
+
+class NeighborGraphWriter {
+	public:
+		NeighborGraphWriter(const string& path, unsigned int numBoids);
+		~NeighborGraphWriter();
+
+		void record(unsigned long frame, NeighborGraph& graph);
+		unsigned long getNumFrames() const;
+
+	protected:
+		/**
+		 * A frame on its way to the file.
+		 */
+		struct PendingFrame {
+			unsigned long frame;
+			NeighborGraph graph;
+		};
+
+		void write();
+
+		/* Properties.
+		 */
+		ofstream out;
+		unsigned int boids;
+		unsigned long frames;
+		deque<PendingFrame*> queue;	// Frames waiting to be written, in order.
+		vector<PendingFrame*> spare;	// Written frames, for their storage.
+		thread writer;
+		mutable mutex lock;
+		condition_variable work;	// Something to write, or time to stop.
+		condition_variable room;	// Space in the queue.
+		bool stopping;
+
+	private:
+		NeighborGraphWriter(const NeighborGraphWriter&);
+		NeighborGraphWriter& operator=(const NeighborGraphWriter&);
+};
+
+/* End idempotency.
+ */
+#endif
@@ -0,0 +1,158 @@
+/**
+ * \file	Observables.cpp
+ *
+ * Order parameters that summarize the state of a flock: polarization,
+ * milling, nearest neighbor distance and group speed.
+ *
+ * All of them are built from sums over the Boids, which are accumulated
+ * while the Boids are being advanced anyway (see advanceResidents() in
+ * Simulation.cpp), so they cost no extra pass over the population. Each
+ * thread or process keeps its own partial sums, which are merged at the end
+ * of the step.
+ *
+ * The sums also count the pairs of Boids looked at and the pairs that
+ * interact, which is what the time a step takes mostly comes down to.
+ *
+ * Milling is measured around the centroid of the population, which the sums
+ * only give once they are complete. So the engines work out the centroid of
+ * the positions about to be summed beforehand, from the per-strip (or
+ * per-domain) sums of the positions they have at hand anyway.
+ *
+ * @since	2026-10-18
+ */
+
+/**
+ * Includes.
+ */
+#include "Observables.h"
+#include <math.h>
+
+/**
+ * Resets a set of sums to zero.
+ *
+ * @param sums	The sums.
+ */
+void clearSums(ObservableSums& sums){
+	sums.headingX = sums.headingY = 0.0;
+	sums.velocityX = sums.velocityY = 0.0;
+	sums.positionX = sums.positionY = 0.0;
+	sums.rotation = 0.0;
+	sums.nearestDistance = 0.0;
+	sums.count = 0;
+	sums.withNeighbors = 0;
+	sums.pairTests = 0;
+	sums.interactions = 0;
+}
+
+/**
+ * Adds a Boid to a set of sums.
+ *
+ * @param sums			The sums.
+ * @param boid			The Boid.
+ * @param centroid		Centroid of the population the Boid is part of.
+ * @param nearestDistSquared	Squared distance to its nearest flockmate, or
+ * 				a negative value if it can't see any.
+ */
+void addBoid(ObservableSums& sums, const Boid& boid, const Point& centroid, double nearestDistSquared){
+	Point coords = boid.getCoordinates();
+	Vector velocity = boid.getVelocity();
+	double speed = sqrt(velocity.x*velocity.x + velocity.y*velocity.y);
+	double offsetX = coords.x - centroid.x;
+	double offsetY = coords.y - centroid.y;
+	double offset = sqrt(offsetX*offsetX + offsetY*offsetY);
+
+	sums.velocityX += velocity.x;
+	sums.velocityY += velocity.y;
+	sums.positionX += coords.x;
+	sums.positionY += coords.y;
+	sums.count++;
+
+	/* A Boid at rest has no heading, and one sitting on the centroid
+	 * isn't circling it.
+	 */
+	if(speed > 0.0){
+		sums.headingX += velocity.x/speed;
+		sums.headingY += velocity.y/speed;
+		if(offset > 0.0){
+			sums.rotation += (offsetX*velocity.y - offsetY*velocity.x)/(offset*speed);
+		}
+	}
+
+	if(nearestDistSquared >= 0.0){
+		sums.nearestDistance += sqrt(nearestDistSquared);
+		sums.withNeighbors++;
+	}
+}
+
+/**
+ * Adds one set of sums to another.
+ *
+ * @param total		The sums to add to.
+ * @param partial	The sums to add.
+ */
+void mergeSums(ObservableSums& total, const ObservableSums& partial){
+	total.headingX += partial.headingX;
+	total.headingY += partial.headingY;
+	total.velocityX += partial.velocityX;
+	total.velocityY += partial.velocityY;
+	total.positionX += partial.positionX;
+	total.positionY += partial.positionY;
+	total.rotation += partial.rotation;
+	total.nearestDistance += partial.nearestDistance;
+	total.count += partial.count;
+	total.withNeighbors += partial.withNeighbors;
+	total.pairTests += partial.pairTests;
+	total.interactions += partial.interactions;
+}
+
+/**
+ * Computes the order parameters from a complete set of sums.
+ *
+ * @param sums	Sums over the whole population.
+ * @return	The order parameters (all zero for an empty population).
+ */
+Observables summarizeSums(const ObservableSums& sums){
+	Observables result;
+	result.polarization = result.milling = result.nearestNeighbor = result.groupSpeed = 0.0;
+	result.centroid = Point(0.0, 0.0);
+	result.pairTests = sums.pairTests;
+	result.interactions = sums.interactions;
+	if(sums.count == 0){
+		return result;
+	}
+
+	double n = sums.count;
+	result.polarization = sqrt(sums.headingX*sums.headingX + sums.headingY*sums.headingY)/n;
+	result.milling = fabs(sums.rotation)/n;
+	result.groupSpeed = sqrt(sums.velocityX*sums.velocityX + sums.velocityY*sums.velocityY)/n;
+	result.nearestNeighbor = sums.withNeighbors > 0 ? sums.nearestDistance/sums.withNeighbors : 0.0;
+	result.centroid = Point(sums.positionX/n, sums.positionY/n);
+
+	return result;
+}
+
+/**
+ * Writes the column names of the time series.
+ *
+ * @param out	Stream to write to.
+ */
+void writeObservablesHeader(ostream& out){
+	out << "frame\tpolarization\tmilling\tnearest_neighbor\tgroup_speed\tcentroid_x\tcentroid_y\n";
+}
+
+/**
+ * Writes one line of the time series, tab separated.
+ *
+ * @param out		Stream to write to.
+ * @param frame		Frame the order parameters describe.
+ * @param observables	The order parameters.
+ */
+void writeObservables(ostream& out, unsigned long frame, const Observables& observables){
+	out << frame
+		<< "\t" << observables.polarization
+		<< "\t" << observables.milling
+		<< "\t" << observables.nearestNeighbor
+		<< "\t" << observables.groupSpeed
+		<< "\t" << observables.centroid.x
+		<< "\t" << observables.centroid.y << "\n";
+}
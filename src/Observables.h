@@ -0,0 +1,63 @@
+/**
+ * \file Observables.h
+ *
+ * Order parameters that summarize the state of a flock. See implementation
+ * for more details.
+ *
+ * @since	2026-10-18
+ * @see		Observables.cpp
+ */
+
+/* Idempotency.
+ */
+#ifndef OBSERVABLES_H
+#define OBSERVABLES_H
+
+/**
+ * Includes.
+ */
+#include <ostream>
+#include "Boid.h"
+
+/**
+ * Running sums from which the order parameters are computed. Plain data, so
+ * that partial sums can be merged across threads and sent between processes.
+ */
+struct ObservableSums {
+	double headingX;	// Sum of unit velocity vectors.
+	double headingY;
+	double velocityX;	// Sum of velocity vectors.
+	double velocityY;
+	double positionX;	// Sum of positions.
+	double positionY;
+	double rotation;	// Sum of (unit offset from centroid) x (unit velocity).
+	double nearestDistance;	// Sum of distances to the nearest flockmate.
+	unsigned int count;	// Boids summed over.
+	unsigned int withNeighbors;	// Boids with a flockmate in sight.
+	unsigned long pairTests;	// Distances worked out looking for flockmates.
+	unsigned long interactions;	// Flockmates in sight, over all Boids.
+};
+
+/**
+ * Order parameters of a population at one point in time.
+ */
+struct Observables {
+	double polarization;	// Length of the mean heading: 1 if all Boids swim the same way.
+	double milling;		// Mean rotation about the centroid: 1 if all Boids circle it the same way.
+	double nearestNeighbor;	// Mean distance to the nearest flockmate in sight.
+	double groupSpeed;	// Speed of the centroid.
+	Point centroid;
+	unsigned long pairTests;	// Work the step took: distances worked out,
+	unsigned long interactions;	// and flockmates that were in sight.
+};
+
+void clearSums(ObservableSums& sums);
+void addBoid(ObservableSums& sums, const Boid& boid, const Point& centroid, double nearestDistSquared);
+void mergeSums(ObservableSums& total, const ObservableSums& partial);
+Observables summarizeSums(const ObservableSums& sums);
+void writeObservablesHeader(ostream& out);
+void writeObservables(ostream& out, unsigned long frame, const Observables& observables);
+
+/* End idempotency.
+ */
+#endif
@@ -0,0 +1,167 @@
+/**
+ * \file	PairCorrelation.cpp
+ *
+ * Accumulates the structure of a population over many frames: the pair
+ * correlation function g(r) and the distribution of nearest neighbor
+ * distances, both up to a maximum radius.
+ *
+ * The pairs within that radius are found with a spatial grid whose cells are
+ * as wide as the radius, so a frame costs O(N) rather than O(N^2). Workers
+ * visit disjoint ranges of cells and count into histograms of their own,
+ * which are only merged when the results are written. The nearest neighbor
+ * of each Boid is kept as an atomic minimum, since both Boids of a pair may
+ * be updated from different workers.
+ *
+ * g(r) is normalized against an ideal gas of the same density spread over
+ * the whole world, ignoring the edges; it is exact for r much smaller than
+ * the world. Distances do not wrap around the edges.
+ *
+ * @since	2026-10-18
+ */
+
+/**
+ * Includes.
+ */
+#include "PairCorrelation.h"
+#include <math.h>
+
+/**
+ * Constructor from values.
+ *
+ * @param edgeOfWorld	X and Y coordinates of the maximum extent of the
+ * 			simulated space.
+ * @param maxRadius	Largest distance to bin.
+ * @param numBins	Number of bins between 0 and the maximum radius.
+ * @param workers	The threads to accumulate on. Must outlive the
+ * 			accumulator.
+ * @return		An accumulator that has seen no frames.
+ */
+PairCorrelation::PairCorrelation(Point edgeOfWorld, float maxRadius, unsigned int numBins, WorkerPool& workers) : pool(workers), grid(edgeOfWorld, maxRadius){
+	edges = edgeOfWorld;
+	radius = grid.getCellSize() < maxRadius ? grid.getCellSize() : maxRadius;
+	numBins = numBins > 0 ? numBins : 1;
+	binWidth = radius / numBins;
+	nearest = NULL;
+	capacity = 0;
+	pairCounts.assign(pool.size(), vector<unsigned long>(numBins, 0));
+	nearestCounts.assign(pool.size(), vector<unsigned long>(numBins, 0));
+	nearestBeyond.assign(pool.size(), 0);
+	frames = 0;
+	idealPairs = 0.0;
+}
+
+/**
+ * Destructor.
+ */
+PairCorrelation::~PairCorrelation(){
+	delete[] nearest;
+}
+
+/**
+ * Adds the pair and nearest neighbor distances of one frame.
+ *
+ * @param pop	The population.
+ */
+void PairCorrelation::accumulate(const vector<Boid>& pop){
+	unsigned int numBoids = pop.size();
+	if(numBoids > capacity){
+		delete[] nearest;
+		capacity = numBoids;
+		nearest = new atomic<float>[capacity];
+	}
+
+	grid.build(pop);
+
+	/* Bin every pair in reach, and keep track of the nearest one for both
+	 * of its Boids. Workers take interleaved blocks of rows, which
+	 * spreads out dense areas of the world.
+	 */
+	unsigned int numWorkers = pool.size();
+	unsigned int numCells = grid.numCells();
+	unsigned int blockSize = grid.getColumns();
+	unsigned int numBins = pairCounts[0].size();
+	float outOfReach = 2.0*radius*radius;
+	pool.run([&](unsigned int w){
+		for(unsigned int i = w; i < numBoids; i += numWorkers){
+			nearest[i].store(outOfReach, memory_order_relaxed);
+		}
+	});
+	pool.run([&](unsigned int w){
+		vector<unsigned long>& counts = pairCounts[w];
+		auto bin = [&](unsigned int i, unsigned int j, float distSquared){
+			unsigned int b = (unsigned int) (sqrt(distSquared) / binWidth);
+			if(b < numBins){
+				counts[b]++;
+			}
+			unsigned int ends[2] = {i, j};
+			for(unsigned int e = 0; e < 2; e++){
+				float current = nearest[ends[e]].load(memory_order_relaxed);
+				while(distSquared < current && !nearest[ends[e]].compare_exchange_weak(current, distSquared, memory_order_relaxed));
+			}
+		};
+		for(unsigned int first = w*blockSize; first < numCells; first += numWorkers*blockSize){
+			unsigned int last = first + blockSize < numCells ? first + blockSize : numCells;
+			grid.forEachPair(first, last, radius, bin);
+		}
+	});
+	pool.run([&](unsigned int w){
+		vector<unsigned long>& counts = nearestCounts[w];
+		for(unsigned int i = w; i < numBoids; i += numWorkers){
+			unsigned int b = (unsigned int) (sqrt(nearest[i].load(memory_order_relaxed)) / binWidth);
+			if(b < numBins){
+				counts[b]++;
+			}
+			else{
+				nearestBeyond[w]++;
+			}
+		}
+	});
+
+	frames++;
+	idealPairs += 0.5*numBoids*(numBoids - 1.0) / (edges.x*edges.y);
+}
+
+/**
+ * Getter for the number of frames accumulated so far.
+ *
+ * @return	The number of frames.
+ */
+unsigned long PairCorrelation::getNumFrames() const{
+	return frames;
+}
+
+/**
+ * Writes the accumulated distributions as a tab separated table, one line
+ * per distance bin.
+ *
+ * Columns are the bin's range, g(r), and the fraction of Boids whose
+ * nearest neighbor falls in the bin. Boids with no neighbor within the
+ * maximum radius make up the rest of that fraction, and are given in a
+ * comment line at the end.
+ *
+ * @param out	Stream to write to.
+ */
+void PairCorrelation::write(ostream& out) const{
+	unsigned int numBins = pairCounts[0].size();
+	vector<unsigned long> pairs(numBins, 0), nearests(numBins, 0);
+	unsigned long beyond = 0, samples = 0;
+	for(unsigned int w = 0; w < pairCounts.size(); w++){
+		for(unsigned int b = 0; b < numBins; b++){
+			pairs[b] += pairCounts[w][b];
+			nearests[b] += nearestCounts[w][b];
+			samples += nearestCounts[w][b];
+		}
+		beyond += nearestBeyond[w];
+	}
+	samples += beyond;
+
+	out << "r_from\tr_to\tg\tnearest_neighbor_fraction\n";
+	for(unsigned int b = 0; b < numBins; b++){
+		double from = b*binWidth, to = (b+1)*binWidth;
+		double ideal = idealPairs * M_PI * (to*to - from*from);
+		out << from << "\t" << to
+			<< "\t" << (ideal > 0.0 ? pairs[b]/ideal : 0.0)
+			<< "\t" << (samples > 0 ? (double) nearests[b]/samples : 0.0) << "\n";
+	}
+	out << "# frames " << frames << ", nearest neighbor beyond " << radius << ": " << (samples > 0 ? (double) beyond/samples : 0.0) << "\n";
+}
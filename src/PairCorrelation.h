@@ -0,0 +1,63 @@
+/**
+ * \file PairCorrelation.h
+ *
+ * Accumulates the pair correlation function and nearest neighbor distance
+ * distribution of a population over many frames. See implementation for
+ * more details.
+ *
+ * @since	2026-10-18
+ * @see		PairCorrelation.cpp
+ */
+
+/* Idempotency.
+ */
+#ifndef PAIR_CORRELATION_H
+#define PAIR_CORRELATION_H
+
+/**
+ * Includes.
+ */
+#include <vector>
+#include <atomic>
+#include <ostream>
+#include "WorkerPool.h"
+#include "SpatialGrid.h"
+
+/**
+ * Definitions.
+ */
+using namespace std;
+
+class PairCorrelation {
+	public:
+		PairCorrelation(Point edgeOfWorld, float maxRadius, unsigned int numBins, WorkerPool& workers);
+		~PairCorrelation();
+
+		void accumulate(const vector<Boid>& pop);
+		unsigned long getNumFrames() const;
+		void write(ostream& out) const;
+
+	protected:
+		/* Properties.
+		 */
+		WorkerPool& pool;
+		SpatialGrid grid;
+		Point edges;
+		float radius;
+		float binWidth;
+		atomic<float>* nearest;				// Squared distance to the nearest neighbor, by Boid.
+		unsigned int capacity;
+		vector<vector<unsigned long> > pairCounts;	// Pairs per distance bin, by worker.
+		vector<vector<unsigned long> > nearestCounts;	// Nearest neighbors per distance bin, by worker.
+		vector<unsigned long> nearestBeyond;		// Boids without a neighbor in range, by worker.
+		unsigned long frames;
+		double idealPairs;	// Pairs per unit area an ideal gas would have had, summed over frames.
+
+	private:
+		PairCorrelation(const PairCorrelation&);
+		PairCorrelation& operator=(const PairCorrelation&);
+};
+
+/* End idempotency.
+ */
+#endif
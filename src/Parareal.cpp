@@ -0,0 +1,269 @@
+/**
+ * \file	Parareal.cpp
+ *
+ * Runs a long simulation of a flock too small to keep many cores busy step
+ * by step, in parallel along the time axis instead, with the parareal method
+ * (Lions, Maday and Turinici, 2001).
+ *
+ * The run is cut up into time slices. A coarse propagator G (long time
+ * steps, with a shorter cutoff and a stride, on one thread) first predicts
+ * the state at the start of every slice, one slice after the other. Every
+ * iteration then runs the fine propagator F (regular steps, i.e. the
+ * simulation itself) over every slice from its predicted start, all slices at
+ * once on the workers, and corrects the predictions slice by slice:
+ *
+ *     U'[n+1] = G(U'[n]) + F(U[n]) - G(U[n])
+ *
+ * where U are the starting states of the last iteration and U' the new ones.
+ * Each iteration leaves one more slice exact, so after as many iterations as
+ * there are slices the run is the serial one, give or take rounding. The
+ * point is to stop well before that, once the corrections no longer move any
+ * Boid by more than some tolerance. How soon that happens depends on how
+ * chaotic the flock is over a slice, so the largest and the mean correction
+ * of the last iteration are kept.
+ *
+ * States are whole populations in the order they started in, and both
+ * propagators are advanceResidents() (see Simulation.cpp) over the whole
+ * population with an empty halo, so they are the simulation's own code.
+ * Corrected Boids are kept inside the (walled) world. Every slice respawns
+ * escaped Boids from a random state of its own, reset whenever the slice is
+ * run, so that the propagators depend on the starting state alone.
+ *
+ * @since	2026-10-18
+ */
+
+/**
+ * Includes.
+ */
+#include <stdexcept>
+#include <math.h>
+#include "Parareal.h"
+#include "Simulation.h"
+
+/**
+ * Constructor from values. Makes the first, coarse prediction of the run.
+ *
+ * @param initialPop		The population at the start of the run.
+ * @param edgeOfWorld		X and Y coordinates of the maximum extent of
+ * 				the (walled) world.
+ * @param pararealSettings	How to cut up the run, and how to propagate.
+ * @param destinationAt		Where the Boids head for, by step.
+ * @param seed			Random state for respawning in the first
+ * 				slice; the others count up from it.
+ * @param workers		Threads to run the slices on, one at a time
+ * 				each. Must outlive the object.
+ * @return			A run that has not been iterated yet.
+ * @throws			std::runtime_error if there is nothing to run,
+ * 				or fewer steps than slices.
+ */
+Parareal::Parareal(const vector<Boid>& initialPop, const Point& edgeOfWorld, const PararealSettings& pararealSettings, const function<Point(unsigned long)>& destinationAt, unsigned int seed, WorkerPool& workers) : pool(workers), destination(destinationAt){
+	if(initialPop.empty() || pararealSettings.slices == 0 || pararealSettings.steps < pararealSettings.slices){
+		throw runtime_error("Nothing to run in parallel in time!");
+	}
+
+	edges = edgeOfWorld;
+	settings = pararealSettings;
+	settings.coarseStep = settings.coarseStep > 0 ? settings.coarseStep : 1;
+	baseSeed = seed;
+	iterations = 0;
+	largestChange = 0.0;
+	meanChange = 0.0;
+	states.resize(settings.slices + 1);
+	coarse.resize(settings.slices);
+	fine.resize(settings.slices);
+	observed.resize(settings.slices);
+	scratch.resize(pool.size() + 1);
+
+	states[0] = initialPop;
+	for(unsigned int n = 0; n < settings.slices; n++){
+		propagate(n, states[n], true, scratch.back(), coarse[n], NULL);
+		states[n+1] = coarse[n];
+	}
+}
+
+/**
+ * Runs an iteration: every slice that isn't exact yet on the fine
+ * propagator, side by side, and then the corrections, one slice after the
+ * other. Does nothing once the run is exact.
+ */
+void Parareal::iterate(){
+	if(isExact()){
+		return;
+	}
+
+	/* The slices before the first have started from exact states for an
+	 * iteration already, so they have nothing left to correct.
+	 */
+	unsigned int first = iterations;
+	unsigned int numWorkers = pool.size();
+	pool.run([&](unsigned int w){
+		for(unsigned int n = first + w; n < settings.slices; n += numWorkers){
+			propagate(n, states[n], false, scratch[w], fine[n], &observed[n]);
+		}
+	});
+
+	/* The start of the first slice hasn't moved, so neither has its
+	 * coarse prediction, and its end is just the fine one.
+	 */
+	Scratch& serial = scratch.back();
+	unsigned int numBoids = states[0].size();
+	double largest = 0.0, total = 0.0;
+	for(unsigned int n = first; n < settings.slices; n++){
+		vector<Boid>& next = states[n+1];
+		if(n > first){
+			propagate(n, states[n], true, serial, serial.predicted, NULL);
+		}
+		for(unsigned int i = 0; i < numBoids; i++){
+			Point f = fine[n][i].getCoordinates();
+			Vector fv = fine[n][i].getVelocity();
+			double x = f.x, y = f.y, vx = fv.x, vy = fv.y;
+			if(n > first){
+				Point g = serial.predicted[i].getCoordinates(), old = coarse[n][i].getCoordinates();
+				Vector gv = serial.predicted[i].getVelocity(), oldv = coarse[n][i].getVelocity();
+				x += g.x - old.x;
+				y += g.y - old.y;
+				vx += gv.x - oldv.x;
+				vy += gv.y - oldv.y;
+				x = x > 0.0 ? (x < edges.x ? x : edges.x) : 0.0;
+				y = y > 0.0 ? (y < edges.y ? y : edges.y) : 0.0;
+			}
+
+			Point previous = next[i].getCoordinates();
+			double change = sqrt((x - previous.x)*(x - previous.x) + (y - previous.y)*(y - previous.y));
+			largest = change > largest ? change : largest;
+			total += change;
+			next[i] = next[i].placedAt(Point(x, y), Vector(vx, vy), next[i].getId());
+		}
+		if(n > first){
+			coarse[n].swap(serial.predicted);
+		}
+	}
+
+	iterations++;
+	largestChange = largest;
+	meanChange = total/((double) numBoids*(settings.slices - first));
+}
+
+/**
+ * Getter for the number of iterations.
+ *
+ * @return	Iterations run so far.
+ */
+unsigned int Parareal::getIterations() const{
+	return iterations;
+}
+
+/**
+ * Getter for the largest correction.
+ *
+ * @return	Farthest any Boid was moved by the last iteration, at the start
+ * 		of any slice; 0 before the first.
+ */
+double Parareal::getLargestChange() const{
+	return largestChange;
+}
+
+/**
+ * Getter for the mean correction.
+ *
+ * @return	Mean distance the Boids were moved by the last iteration, over
+ * 		the slices it corrected; 0 before the first.
+ */
+double Parareal::getMeanChange() const{
+	return meanChange;
+}
+
+/**
+ * Whether the run is as exact as the serial one, having been iterated as
+ * often as it has slices.
+ *
+ * @return	true if further iterations would change nothing.
+ */
+bool Parareal::isExact() const{
+	return iterations >= settings.slices;
+}
+
+/**
+ * Getter for the length of the run.
+ *
+ * @return	Regular steps over all of the slices.
+ */
+unsigned long Parareal::getSteps() const{
+	return settings.steps;
+}
+
+/**
+ * Getter for where a slice starts. The steps are shared out as evenly as
+ * they go, so slices differ by one step at most.
+ *
+ * @param slice	The slice; the number of slices for the end of the run.
+ * @return	Regular steps before the slice.
+ */
+unsigned long Parareal::getSliceStart(unsigned int slice) const{
+	return (unsigned long) ((unsigned long long) slice*settings.steps/settings.slices);
+}
+
+/**
+ * Getter for the result.
+ *
+ * @param pop	Filled with the population at the end of the run, as far
+ * 		as it has converged.
+ */
+void Parareal::getBoids(vector<Boid>& pop) const{
+	pop = states.back();
+}
+
+/**
+ * Getter for the order parameters at the start of a slice.
+ *
+ * @param slice	The slice.
+ * @return	Order parameters of the state the slice was last run from on
+ * 		the fine propagator, along with the work its first step
+ * 		took. All zero before the first iteration.
+ */
+Observables Parareal::getObservables(unsigned int slice) const{
+	return observed[slice];
+}
+
+/**
+ * Propagates a slice from a starting state.
+ *
+ * @param slice		The slice.
+ * @param start		Population at its start.
+ * @param coarsely	true for the coarse propagator, false for the fine
+ * 			one.
+ * @param work		Scratch space of the calling thread.
+ * @param end		Filled with the population at its end.
+ * @param first		Set to the order parameters of the starting state,
+ * 			if not NULL.
+ */
+void Parareal::propagate(unsigned int slice, const vector<Boid>& start, bool coarsely, Scratch& work, vector<Boid>& end, Observables* first) const{
+	unsigned long firstStep = getSliceStart(slice);
+	unsigned long sliceSteps = getSliceStart(slice + 1) - firstStep;
+	unsigned int stepLength = coarsely ? settings.coarseStep : 1;
+	const QualitySettings& quality = coarsely ? settings.coarse : settings.fine;
+	unsigned int seed = baseSeed + slice;
+
+	end = start;
+	for(unsigned long s = 0; s < sliceSteps; s += stepLength){
+		unsigned int length = sliceSteps - s < stepLength ? sliceSteps - s : stepLength;
+
+		/* Milling is about the centroid of the very same state here,
+		 * there being no earlier step to take it from.
+		 */
+		double sumX = 0.0, sumY = 0.0;
+		for(unsigned int i = 0; i < end.size(); i++){
+			Point p = end[i].getCoordinates();
+			sumX += p.x;
+			sumY += p.y;
+		}
+		Point centroid(sumX/end.size(), sumY/end.size());
+
+		clearSums(work.sums);
+		advanceResidents(end, nobody, destination(firstStep + s), quality, length, edges, false, seed, work.flockmates, work.kinematics, work.moved, centroid, work.sums, NULL);
+		if(first && s == 0){
+			*first = summarizeSums(work.sums);
+		}
+		end.swap(work.moved);
+	}
+}
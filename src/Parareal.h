@@ -0,0 +1,95 @@
+/**
+ * \file Parareal.h
+ *
+ * Runs a simulation in parallel along the time axis. See implementation for
+ * more details.
+ *
+ * @since	2026-10-18
+ * @see		Parareal.cpp
+ */
+
+/* Idempotency.
+ */
+#ifndef PARAREAL_H
+#define PARAREAL_H
+
+/**
+ * Includes.
+ */
+#include <vector>
+#include <functional>
+#include "WorkerPool.h"
+#include "Integrator.h"
+#include "QualityController.h"
+#include "Observables.h"
+#include "Boid.h"
+
+/**
+ * Definitions.
+ */
+using namespace std;
+
+/**
+ * How a run is cut up in time, and how rough the coarse propagator is.
+ */
+struct PararealSettings {
+	unsigned int slices;		// Time slices, run side by side.
+	unsigned long steps;		// Regular steps over all of the slices, at least one per slice.
+	unsigned int coarseStep;	// Regular steps per step of the coarse propagator.
+	QualitySettings fine;		// Cutoff and stride of the regular steps.
+	QualitySettings coarse;		// Cutoff and stride of the coarse steps.
+};
+
+class Parareal {
+	public:
+		Parareal(const vector<Boid>& initialPop, const Point& edgeOfWorld, const PararealSettings& pararealSettings, const function<Point(unsigned long)>& destinationAt, unsigned int seed, WorkerPool& workers);
+
+		void iterate();
+		unsigned int getIterations() const;
+		double getLargestChange() const;
+		double getMeanChange() const;
+		bool isExact() const;
+		unsigned long getSteps() const;
+		unsigned long getSliceStart(unsigned int slice) const;
+		void getBoids(vector<Boid>& pop) const;
+		Observables getObservables(unsigned int slice) const;
+
+	protected:
+		/**
+		 * Scratch space of a thread.
+		 */
+		struct Scratch {
+			vector<Boid> flockmates;
+			vector<Boid> moved;
+			vector<Boid> predicted;
+			Kinematics kinematics;
+			ObservableSums sums;
+		};
+
+		void propagate(unsigned int slice, const vector<Boid>& start, bool coarsely, Scratch& work, vector<Boid>& end, Observables* first) const;
+
+		/* Properties.
+		 */
+		WorkerPool& pool;
+		Point edges;
+		PararealSettings settings;
+		function<Point(unsigned long)> destination;	// By step.
+		unsigned int baseSeed;
+		vector<vector<Boid> > states;	// At the start of every slice, and the end of the last.
+		vector<vector<Boid> > coarse;	// Coarse propagation of every slice from its start.
+		vector<vector<Boid> > fine;	// Regular propagation of every slice from its start.
+		vector<Observables> observed;	// At the start of every slice.
+		vector<Boid> nobody;		// Empty halo: every state is the whole flock.
+		vector<Scratch> scratch;	// One per worker, then one for the calling thread.
+		unsigned int iterations;
+		double largestChange;		// Of any Boid, in the last iteration.
+		double meanChange;
+
+	private:
+		Parareal(const Parareal&);
+		Parareal& operator=(const Parareal&);
+};
+
+/* End idempotency.
+ */
+#endif
@@ -0,0 +1,205 @@
+/**
+ * \file	Placement.cpp
+ *
+ * Starting positions for a population that are never closer to each other
+ * than a given spacing, so that separation doesn't blow a freshly placed
+ * flock apart in its first frames.
+ *
+ * The positions are Poisson-disk (blue noise) samples: random, but a
+ * minimum distance apart. They are thrown at a grid with cells small enough
+ * to hold one sample each (spacing/sqrt(2) across), each cell trying a
+ * number of random spots until one is far enough from the samples around
+ * it. Samples closer than the spacing are at most two cells apart, so
+ * cells three apart can't interfere with each other: the cells are split
+ * into nine classes by their row and column modulo 3, and all cells of a
+ * class are filled at the same time on the workers. Every cell has a random
+ * stream of its own, so the result only depends on the seed, not on the
+ * number of workers.
+ *
+ * If the region is too small for the population it is made larger, up to
+ * the whole world. A region much larger than the population needs is cut
+ * down to SPREAD_LIMIT times the side it needs, so that the grid stays in
+ * proportion to the population rather than to the region asked for.
+ *
+ * @since	2026-10-18
+ */
+
+/**
+ * Includes.
+ */
+#include <math.h>
+#include <algorithm>
+#include <stdexcept>
+#include "Placement.h"
+
+/**
+ * Definitions.
+ */
+#define SPOTS_PER_CELL 30 // Random spots a cell tries before giving up
+#define EXPECTED_FILL 0.5 // Conservative number of samples per spacing squared
+#define REGION_GROWTH 1.25 // Side of the region grows by this when too small
+#define SPREAD_LIMIT 4.0 // Largest side of the region, in sides the population needs
+#define MAX_CELLS (1 << 26) // Largest grid tried, in cells
+
+/**
+ * Next number of a small random stream.
+ *
+ * @param state	State of the stream.
+ * @return	A number uniformly distributed on [0, 1).
+ */
+static float nextUniform(unsigned int& state){
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return (state >> 8) * (1.0f/16777216.0f);
+}
+
+/**
+ * Starting state of the random stream for a cell.
+ *
+ * @param seed	Seed of the placement.
+ * @param cell	The cell.
+ * @return	A nonzero state that differs from cell to cell.
+ */
+static unsigned int streamOf(unsigned int seed, unsigned int cell){
+	unsigned int h = seed*0x9E3779B9u ^ (cell + 0x7F4A7C15u)*0x85EBCA6Bu;
+	h ^= h >> 16;
+	h *= 0x85EBCA6Bu;
+	h ^= h >> 13;
+	h *= 0xC2B2AE35u;
+	h ^= h >> 16;
+	return h ? h : 1;
+}
+
+/**
+ * Places a population a minimum distance apart.
+ *
+ * @param numBoids	Number of positions.
+ * @param center	Middle of the region to place them in.
+ * @param size		Side of the (square) region. Made larger if the
+ * 			population doesn't fit, and cut off at the edges of
+ * 			the world.
+ * @param spacing	Minimum distance between any two positions.
+ * @param edgeOfWorld	X and Y coordinates of the maximum extent of the
+ * 			simulated space.
+ * @param seed		Seed for the random numbers; the same seed gives the
+ * 			same positions.
+ * @param workers	The threads to place on.
+ * @param positions	Filled with the positions, in random order.
+ * @throws		std::runtime_error if the population doesn't fit
+ * 			into the world at that spacing, would take too large a
+ * 			grid, or any of the sizes isn't a finite number.
+ */
+void placePoissonDisk(unsigned int numBoids, const Point& center, float size, float spacing, const Point& edgeOfWorld, unsigned int seed, WorkerPool& workers, vector<Point>& positions){
+	positions.clear();
+	if(numBoids == 0){
+		return;
+	}
+	if(!isfinite(center.x) || !isfinite(center.y) || !isfinite(edgeOfWorld.x) || !isfinite(edgeOfWorld.y) || !isfinite(size) || !isfinite(spacing) || spacing <= 0.0){
+		throw runtime_error("Spawn region, spacing and world must be finite");
+	}
+
+	/* Start out large enough for the population to fit comfortably, but
+	 * not so large that the grid dwarfs it.
+	 */
+	float needed = sqrt((double) numBoids*spacing*spacing/EXPECTED_FILL);
+	float side = needed > size ? needed : size;
+	side = side < SPREAD_LIMIT*needed ? side : SPREAD_LIMIT*needed;
+	float cellSize = spacing/sqrt(2.0);
+	float spacingSquared = spacing*spacing;
+	unsigned int numWorkers = workers.size();
+
+	vector<float> xs, ys;
+	vector<char> filled;
+	while(true){
+		float left = center.x - side/2 > 0.0 ? center.x - side/2 : 0.0;
+		float top = center.y - side/2 > 0.0 ? center.y - side/2 : 0.0;
+		float right = center.x + side/2 < edgeOfWorld.x ? center.x + side/2 : edgeOfWorld.x;
+		float bottom = center.y + side/2 < edgeOfWorld.y ? center.y + side/2 : edgeOfWorld.y;
+		double gridColumns = ceil((right - left)/cellSize);
+		double gridRows = ceil((bottom - top)/cellSize);
+		gridColumns = gridColumns > 0.0 ? gridColumns : 0.0;
+		gridRows = gridRows > 0.0 ? gridRows : 0.0;
+		if(gridColumns*gridRows > MAX_CELLS){
+			throw runtime_error("Too many boids to place at that spacing");
+		}
+		int columns = (int) gridColumns;
+		int rows = (int) gridRows;
+		unsigned int numCells = columns*rows;
+
+		xs.assign(numCells, 0.0);
+		ys.assign(numCells, 0.0);
+		filled.assign(numCells, 0);
+
+		/* One class of cells at a time; the cells a cell looks at
+		 * around it all belong to other classes, so they don't change
+		 * while it does.
+		 */
+		for(int phase = 0; phase < 9; phase++){
+			int phaseColumn = phase % 3;
+			int phaseRow = phase / 3;
+			workers.run([&](unsigned int w){
+				for(int row = phaseRow; row < rows; row += 3){
+					for(int column = phaseColumn + 3*w; column < columns; column += 3*numWorkers){
+						unsigned int cell = row*columns + column;
+						unsigned int state = streamOf(seed, cell);
+						float cellLeft = left + column*cellSize;
+						float cellTop = top + row*cellSize;
+						float cellWidth = cellLeft + cellSize < right ? cellSize : right - cellLeft;
+						float cellHeight = cellTop + cellSize < bottom ? cellSize : bottom - cellTop;
+
+						for(int spot = 0; spot < SPOTS_PER_CELL && !filled[cell]; spot++){
+							float x = cellLeft + nextUniform(state)*cellWidth;
+							float y = cellTop + nextUniform(state)*cellHeight;
+							bool clear = true;
+							for(int r = row - 2; r <= row + 2 && clear; r++){
+								for(int c = column - 2; c <= column + 2 && clear; c++){
+									if(r < 0 || r >= rows || c < 0 || c >= columns || !filled[r*columns + c]){
+										continue;
+									}
+									float dx = xs[r*columns + c] - x, dy = ys[r*columns + c] - y;
+									clear = dx*dx + dy*dy >= spacingSquared;
+								}
+							}
+							if(clear){
+								xs[cell] = x;
+								ys[cell] = y;
+								filled[cell] = 1;
+							}
+						}
+					}
+				}
+			});
+		}
+
+		for(unsigned int cell = 0; cell < numCells; cell++){
+			if(filled[cell]){
+				positions.push_back(Point(xs[cell], ys[cell]));
+			}
+		}
+		if(positions.size() >= numBoids){
+			break;
+		}
+
+		/* Didn't fit: try again on a larger region, unless it already
+		 * covers the world.
+		 */
+		if(left <= 0.0 && top <= 0.0 && right >= edgeOfWorld.x && bottom >= edgeOfWorld.y){
+			positions.clear();
+			throw runtime_error("Not enough room in the world for that many boids at that spacing");
+		}
+		positions.clear();
+		side *= REGION_GROWTH;
+	}
+
+	/* Keep a random selection of as many as needed, so the population
+	 * is spread over the whole region rather than packed into its top.
+	 */
+	unsigned int state = streamOf(seed, positions.size());
+	for(unsigned int i = 0; i < numBoids; i++){
+		unsigned int j = i + (unsigned int) (nextUniform(state)*(positions.size() - i));
+		j = j < positions.size() ? j : positions.size() - 1;
+		swap(positions[i], positions[j]);
+	}
+	positions.resize(numBoids);
+}
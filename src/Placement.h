@@ -0,0 +1,32 @@
+/**
+ * \file Placement.h
+ *
+ * Starting positions for a population, a minimum distance apart. See
+ * implementation for more details.
+ *
+ * @since	2026-10-18
+ * @see		Placement.cpp
+ */
+
+/* Idempotency.
+ */
+#ifndef PLACEMENT_H
+#define PLACEMENT_H
+
+/**
+ * Includes.
+ */
+#include <vector>
+#include "WorkerPool.h"
+#include "Boid.h"
+
+/**
+ * Definitions.
+ */
+using namespace std;
+
+void placePoissonDisk(unsigned int numBoids, const Point& center, float size, float spacing, const Point& edgeOfWorld, unsigned int seed, WorkerPool& workers, vector<Point>& positions);
+
+/* End idempotency.
+ */
+#endif
@@ -0,0 +1,161 @@
+/**
+ * \file	QualityController.cpp
+ *
+ * Feedback controller that keeps the frame time of the simulation within a
+ * budget by adjusting the accuracy knobs of the simulation.
+ *
+ * The cost of a frame scales with the number of flockmates each Boid
+ * interacts with, which varies wildly as the flock clusters and spreads out.
+ * The controller keeps a running average of the frame time and, when it
+ * drifts outside the budget, moves one knob one notch at a time between the
+ * configured best and worst settings. Knobs are given up in order of how
+ * little they hurt the look of the simulation: first the perception cutoff
+ * shrinks, then flockmates are subsampled, and finally frames are skipped
+ * when drawing. They are restored in the opposite order.
+ *
+ * Every adjustment is logged to STDERR.
+ *
+ * @since	2026-10-18
+ */
+
+/**
+ * Includes.
+ */
+#include "QualityController.h"
+#include <iostream>
+
+using namespace std;
+
+/**
+ * Definitions.
+ */
+#define SMOOTHING 0.1		// Weight of the newest frame in the running average
+#define COOLDOWN_FRAMES 10	// Frames to wait after an adjustment before the next
+#define HEADROOM 0.5		// Only improve quality when this far below budget
+#define CUTOFF_STEP 0.85	// Factor by which the cutoff shrinks per notch
+
+/**
+ * Constructor from values.
+ *
+ * Starts out at the best quality settings.
+ *
+ * @param frameBudgetMs	Target duration of a frame, in milliseconds.
+ * @param bestQuality	Most accurate (and most expensive) settings allowed.
+ * @param worstQuality	Least accurate (and cheapest) settings allowed.
+ * @return		A fully specified object.
+ */
+QualityController::QualityController(float frameBudgetMs, QualitySettings bestQuality, QualitySettings worstQuality){
+	budget = frameBudgetMs;
+	averageMs = 0.0;
+	framesSinceChange = 0;
+	best = bestQuality;
+	worst = worstQuality;
+	current = bestQuality;
+}
+
+/**
+ * Default destructor.
+ */
+QualityController::~QualityController(){
+}
+
+/**
+ * Report the duration of a finished frame, possibly adjusting the settings
+ * for the next one.
+ *
+ * @param frameMs	Wall-clock duration of the frame, in milliseconds.
+ * @return		true if the settings changed, false otherwise.
+ */
+bool QualityController::frameFinished(float frameMs){
+	/* Smooth out the jitter from individual frames, but let the very
+	 * first frame set the baseline.
+	 */
+	averageMs = averageMs == 0.0 ? frameMs : (1.0 - SMOOTHING)*averageMs + SMOOTHING*frameMs;
+
+	/* Give the previous adjustment a chance to show up in the
+	 * running average before making another.
+	 */
+	if(++framesSinceChange < COOLDOWN_FRAMES){
+		return false;
+	}
+
+	bool changed = false;
+	if(averageMs > budget){
+		changed = degrade();
+	}
+	else if(averageMs < HEADROOM*budget){
+		changed = improve();
+	}
+
+	if(changed){
+		framesSinceChange = 0;
+		cerr << "quality: " << averageMs << " ms/frame (budget " << budget << " ms) -> "
+			<< "cutoff " << current.cutoff
+			<< ", stride " << current.stride
+			<< ", drawing every " << current.renderEvery << " frame(s)" << endl;
+	}
+
+	return changed;
+}
+
+/**
+ * Getter for the current settings.
+ *
+ * @return	The settings to use for the next frame.
+ */
+QualitySettings QualityController::getSettings() const{
+	return current;
+}
+
+/**
+ * Getter for the running average of the frame time.
+ *
+ * @return	Smoothed frame time, in milliseconds.
+ */
+float QualityController::getAverageFrameMs() const{
+	return averageMs;
+}
+
+/**
+ * Give up one notch of accuracy.
+ *
+ * @return	false if already at the worst allowed settings, true otherwise.
+ */
+bool QualityController::degrade(){
+	if(current.cutoff > worst.cutoff){
+		current.cutoff = current.cutoff*CUTOFF_STEP < worst.cutoff ? worst.cutoff : current.cutoff*CUTOFF_STEP;
+		return true;
+	}
+	if(current.stride < worst.stride){
+		current.stride++;
+		return true;
+	}
+	if(current.renderEvery < worst.renderEvery){
+		current.renderEvery++;
+		return true;
+	}
+
+	return false;
+}
+
+/**
+ * Restore one notch of accuracy.
+ *
+ * @return	false if already at the best allowed settings, true otherwise.
+ */
+bool QualityController::improve(){
+	if(current.renderEvery > best.renderEvery){
+		current.renderEvery--;
+		return true;
+	}
+	if(current.stride > best.stride){
+		current.stride--;
+		return true;
+	}
+	if(current.cutoff < best.cutoff){
+		current.cutoff = current.cutoff/CUTOFF_STEP > best.cutoff ? best.cutoff : current.cutoff/CUTOFF_STEP;
+		return true;
+	}
+
+	return false;
+}
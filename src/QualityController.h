@@ -0,0 +1,50 @@
+/**
+ * \file QualityController.h
+ *
+ * Feedback controller that trades simulation accuracy for frame time. See
+ * implementation for more details.
+ *
+ * @since	2026-10-18
+ * @see		QualityController.cpp
+ */
+
+/* Idempotency.
+ */
+#ifndef QUALITY_CONTROLLER_H
+#define QUALITY_CONTROLLER_H
+
+/**
+ * Accuracy knobs that determine how much work goes into a frame.
+ */
+struct QualitySettings {
+	float cutoff;			// Flockmates further away than this (pixels) are ignored.
+	unsigned int stride;		// Only every stride-th flockmate is considered.
+	unsigned int renderEvery;	// Only every renderEvery-th frame is drawn.
+};
+
+class QualityController {
+	public:
+		QualityController(float frameBudgetMs, QualitySettings bestQuality, QualitySettings worstQuality);
+		~QualityController();
+
+		bool frameFinished(float frameMs);
+		QualitySettings getSettings() const;
+		float getAverageFrameMs() const;
+
+	protected:
+		bool degrade();
+		bool improve();
+
+		/* Properties.
+		 */
+		float budget;
+		float averageMs;
+		unsigned int framesSinceChange;
+		QualitySettings best;
+		QualitySettings worst;
+		QualitySettings current;
+};
+
+/* End idempotency.
+ */
+#endif
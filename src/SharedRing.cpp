@@ -0,0 +1,139 @@
+/**
+ * \file	SharedRing.cpp
+ *
+ * Single-producer, single-consumer byte ring in shared memory.
+ *
+ * The ring is mapped anonymously and shared, so it must be created before
+ * the processes that use it are forked off. One process writes and one
+ * process reads; the two only ever communicate through the monotonically
+ * increasing head and tail counters, which are lock-free atomics and thus
+ * safe to share across processes.
+ *
+ * write() and read() never block and move as many bytes as they can, which
+ * lets a process interleave sending and receiving on several rings without
+ * deadlocking when messages are larger than the ring. send() and receive()
+ * are blocking conveniences for small messages.
+ *
+ * @since	2026-10-18
+ */
+
+/**
+ * Includes.
+ */
+#include "SharedRing.h"
+#include <new>
+#include <stdexcept>
+#include <string.h>
+#include <sched.h>
+#include <sys/mman.h>
+
+/**
+ * Constructor from values.
+ *
+ * @param ringCapacity	Size of the ring, in bytes.
+ * @return		An empty ring.
+ * @throws		std::runtime_error if the memory can't be mapped.
+ */
+SharedRing::SharedRing(size_t ringCapacity){
+	capacity = ringCapacity;
+	mappedBytes = sizeof(Positions) + capacity;
+
+	void* memory = mmap(NULL, mappedBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if(memory == MAP_FAILED){
+		throw runtime_error("Unable to map shared memory for ring buffer!");
+	}
+
+	positions = new (memory) Positions;
+	positions->head.store(0);
+	positions->tail.store(0);
+	data = (char*) memory + sizeof(Positions);
+}
+
+/**
+ * Destructor. Unmaps the ring from this process.
+ */
+SharedRing::~SharedRing(){
+	munmap(positions, mappedBytes);
+}
+
+/**
+ * Writes as much as currently fits into the ring.
+ *
+ * @param bytes		Data to write.
+ * @param numBytes	Size of the data.
+ * @return		Number of bytes actually written.
+ */
+size_t SharedRing::write(const void* bytes, size_t numBytes){
+	size_t head = positions->head.load(memory_order_relaxed);
+	size_t tail = positions->tail.load(memory_order_acquire);
+	size_t space = capacity - (head - tail);
+	size_t count = numBytes < space ? numBytes : space;
+
+	/* Copy in at most two pieces, wrapping around the end.
+	 */
+	size_t offset = head % capacity;
+	size_t first = count < capacity - offset ? count : capacity - offset;
+	memcpy(data + offset, bytes, first);
+	memcpy(data, (const char*) bytes + first, count - first);
+
+	positions->head.store(head + count, memory_order_release);
+
+	return count;
+}
+
+/**
+ * Reads as much as is currently available from the ring.
+ *
+ * @param bytes		Buffer to read into.
+ * @param numBytes	Maximum number of bytes to read.
+ * @return		Number of bytes actually read.
+ */
+size_t SharedRing::read(void* bytes, size_t numBytes){
+	size_t tail = positions->tail.load(memory_order_relaxed);
+	size_t head = positions->head.load(memory_order_acquire);
+	size_t available = head - tail;
+	size_t count = numBytes < available ? numBytes : available;
+
+	size_t offset = tail % capacity;
+	size_t first = count < capacity - offset ? count : capacity - offset;
+	memcpy(bytes, data + offset, first);
+	memcpy((char*) bytes + first, data, count - first);
+
+	positions->tail.store(tail + count, memory_order_release);
+
+	return count;
+}
+
+/**
+ * Writes all of the data, waiting for room as necessary.
+ *
+ * @param bytes		Data to write.
+ * @param numBytes	Size of the data.
+ */
+void SharedRing::send(const void* bytes, size_t numBytes){
+	size_t sent = 0;
+	while(sent < numBytes){
+		size_t count = write((const char*) bytes + sent, numBytes - sent);
+		if(count == 0){
+			sched_yield();
+		}
+		sent += count;
+	}
+}
+
+/**
+ * Reads exactly the requested amount of data, waiting for it as necessary.
+ *
+ * @param bytes		Buffer to read into.
+ * @param numBytes	Number of bytes to read.
+ */
+void SharedRing::receive(void* bytes, size_t numBytes){
+	size_t received = 0;
+	while(received < numBytes){
+		size_t count = read((char*) bytes + received, numBytes - received);
+		if(count == 0){
+			sched_yield();
+		}
+		received += count;
+	}
+}
@@ -0,0 +1,61 @@
+/**
+ * \file SharedRing.h
+ *
+ * Single-producer, single-consumer byte ring in memory shared between
+ * processes. See implementation for more details.
+ *
+ * @since	2026-10-18
+ * @see		SharedRing.cpp
+ */
+
+/* Idempotency.
+ */
+#ifndef SHARED_RING_H
+#define SHARED_RING_H
+
+/**
+ * Includes.
+ */
+#include <atomic>
+#include <stddef.h>
+
+/**
+ * Definitions.
+ */
+using namespace std;
+
+class SharedRing {
+	public:
+		SharedRing(size_t capacity);
+		~SharedRing();
+
+		size_t write(const void* bytes, size_t numBytes);
+		size_t read(void* bytes, size_t numBytes);
+		void send(const void* bytes, size_t numBytes);
+		void receive(void* bytes, size_t numBytes);
+
+	protected:
+		/* Read and write positions, on separate cache lines so that
+		 * producer and consumer don't fight over them.
+		 */
+		struct Positions {
+			atomic<size_t> head;	// Total bytes ever written.
+			char padding[64 - sizeof(atomic<size_t>)];
+			atomic<size_t> tail;	// Total bytes ever read.
+		};
+
+		/* Properties.
+		 */
+		Positions* positions;
+		char* data;
+		size_t capacity;
+		size_t mappedBytes;
+
+	private:
+		SharedRing(const SharedRing&);
+		SharedRing& operator=(const SharedRing&);
+};
+
+/* End idempotency.
+ */
+#endif
@@ -0,0 +1,544 @@
+/**
+ * \file	Simulation.cpp
+ *
+ * Parallel engine that advances a population of Boids one step at a time.
+ *
+ * The world is cut into vertical strips, one or more per worker thread (each
+ * always handled by the same worker), and every Boid lives in the strip that
+ * contains it. Narrower strips mean fewer Boids to check for flockmates, but
+ * more of them in the halo. A worker allocates and fills the storage for its
+ * own strips, so on NUMA hosts that memory sits on the node
+ * the worker is pinned to (see WorkerPool.cpp). The strips never move, so
+ * neither does the memory: the only data crossing from one strip to another
+ * is
+ *
+ * - the halo: Boids within the perception cutoff of a strip edge, which
+ *   the owner copies into edge lists for its neighbors to read, and
+ * - the emigrants: Boids that crossed into another strip during a step.
+ *
+ * A step runs in three phases, each on all workers at once: export the
+ * edges, advance the residents (reading only the own strip and the halo),
+ * and take in immigrants. While advancing, each worker also sums up the
+ * order parameters of its residents (see Observables.cpp); the partial sums
+ * are merged once the step is done. If asked to, each worker also keeps the
+ * flockmates it found for its residents, from which the neighbor graph of
+ * the whole population is put together after the step. Every step is timed,
+ * phase by phase and strip by strip, so that a slow one can be taken apart
+ * (see FlightRecorder.cpp).
+ *
+ * @since	2026-10-18
+ */
+
+/**
+ * Includes.
+ */
+#include "Simulation.h"
+#include "BehaviorRules.h"
+#include <stdlib.h>
+#include <math.h>
+#include <stdexcept>
+
+/**
+ * Time taken so far.
+ *
+ * @param start	When it started.
+ * @return	Milliseconds since then.
+ */
+static float millisecondsSince(const chrono::steady_clock::time_point& start){
+	return chrono::duration<float, milli>(chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Constructor from values.
+ *
+ * @param initialPop	The population to start from.
+ * @param edgeOfWorld	X and Y coordinates of the maximum extent of the
+ * 			simulated space.
+ * @param wrapped	true if the edges of the world wrap around, false
+ * 			if they are solid walls.
+ * @param workers	The threads to run the simulation on. Must outlive
+ * 			the simulation.
+ * @param stripsPerWorker	Number of strips of the world per worker.
+ * @return		A fully specified object.
+ */
+Simulation::Simulation(const vector<Boid>& initialPop, Point edgeOfWorld, bool wrapped, WorkerPool& workers, unsigned int stripsPerWorker) : pool(workers){
+	edges = edgeOfWorld;
+	wrap = wrapped;
+	unsigned int numStrips = pool.size()*(stripsPerWorker > 1 ? stripsPerWorker : 1);
+	stripWidth = edges.x / numStrips;
+	keepingNeighbors = false;
+
+	partitions.resize(numStrips);
+	for(unsigned int p = 0; p < partitions.size(); p++){
+		partitions[p].left = p*stripWidth;
+		partitions[p].right = (p+1)*stripWidth;
+	}
+	profile.stripStart.resize(numStrips);
+	profile.stripEnd.resize(numStrips);
+	profile.residents.resize(numStrips);
+	profile.haloSizes.resize(numStrips);
+
+	reset(initialPop);
+}
+
+/**
+ * Default destructor.
+ */
+Simulation::~Simulation(){
+}
+
+/**
+ * Starts over with another population in the same world.
+ *
+ * Each worker picks out and stores the Boids in its own strip. The storage
+ * of the strips is kept, so a simulation that is reused for many runs
+ * doesn't allocate once it has warmed up.
+ *
+ * @param pop	The population to start from.
+ */
+void Simulation::reset(const vector<Boid>& pop){
+	/* Only the centroid is needed before the first step.
+	 */
+	ObservableSums sums;
+	clearSums(sums);
+	for(unsigned int i = 0; i < pop.size(); i++){
+		addBoid(sums, pop[i], Point(0.0, 0.0), -1.0);
+	}
+	latest = summarizeSums(sums);
+	centroid = latest.centroid;
+
+	forEachStrip([&](unsigned int p){
+		Partition& part = partitions[p];
+		part.seed = p + 1;
+		part.neighbors.boids.clear();
+		part.boids.clear();
+		part.boids.reserve(2*pop.size()/partitions.size() + 1);
+		for(unsigned int i = 0; i < pop.size(); i++){
+			if(stripOf(pop[i]) == p){
+				part.boids.push_back(pop[i]);
+			}
+		}
+	});
+}
+
+/**
+ * Advances every Boid in the population one tic.
+ *
+ * @param destination	Coordinates toward which the boids should head.
+ * @param quality	Perception cutoff and flockmate stride to use.
+ */
+void Simulation::step(const Point& destination, const QualitySettings& quality){
+	/* Timing every phase and strip takes a handful of clock readings,
+	 * next to nothing, so it is always done.
+	 */
+	profile.start = chrono::steady_clock::now();
+	forEachStrip([&](unsigned int p){ exportEdges(p, quality.cutoff); });
+
+	/* Milling is measured around the centroid of the positions about to
+	 * be advanced (and summed up).
+	 */
+	double sumX = 0.0, sumY = 0.0;
+	unsigned int numBoids = 0;
+	for(unsigned int p = 0; p < partitions.size(); p++){
+		sumX += partitions[p].positionX;
+		sumY += partitions[p].positionY;
+		numBoids += partitions[p].boids.size();
+	}
+	centroid = numBoids > 0 ? Point(sumX/numBoids, sumY/numBoids) : Point(0.0, 0.0);
+	profile.exported = millisecondsSince(profile.start);
+	forEachStrip([&](unsigned int p){
+		profile.residents[p] = partitions[p].boids.size();
+		profile.stripStart[p] = millisecondsSince(profile.start);
+		advance(p, destination, quality);
+		profile.stripEnd[p] = millisecondsSince(profile.start);
+		profile.haloSizes[p] = partitions[p].halo.size();
+	});
+	profile.advanced = millisecondsSince(profile.start);
+	forEachStrip([&](unsigned int p){ immigrate(p); });
+	profile.immigrated = millisecondsSince(profile.start);
+
+	ObservableSums sums;
+	clearSums(sums);
+	for(unsigned int p = 0; p < partitions.size(); p++){
+		mergeSums(sums, partitions[p].sums);
+	}
+	latest = summarizeSums(sums);
+}
+
+/**
+ * Runs a task on every strip, each on the worker it belongs to, and waits
+ * for all of them to finish.
+ *
+ * @param task	Function to call with the index of each strip.
+ */
+void Simulation::forEachStrip(const function<void(unsigned int)>& task){
+	unsigned int numWorkers = pool.size();
+	pool.run([&](unsigned int w){
+		for(unsigned int p = w; p < partitions.size(); p += numWorkers){
+			task(p);
+		}
+	});
+}
+
+/**
+ * Collects the whole population, e.g. for drawing.
+ *
+ * @param pop	Cleared and filled with every Boid, strip by strip.
+ */
+void Simulation::getBoids(vector<Boid>& pop) const{
+	pop.clear();
+	for(unsigned int p = 0; p < partitions.size(); p++){
+		pop.insert(pop.end(), partitions[p].boids.begin(), partitions[p].boids.end());
+	}
+}
+
+/**
+ * Collects the positions and velocities of the whole population into
+ * arrays indexed by identity, each strip on its own worker.
+ *
+ * @param x, y		Filled with the coordinates of every Boid.
+ * @param vx, vy	Filled with the velocity of every Boid.
+ * @param numBoids	Length of the arrays. Boids with an identity outside
+ * 			of them are left out.
+ */
+void Simulation::getState(double* x, double* y, double* vx, double* vy, unsigned int numBoids){
+	forEachStrip([&](unsigned int p){
+		const vector<Boid>& boids = partitions[p].boids;
+		for(unsigned int i = 0; i < boids.size(); i++){
+			unsigned int id = boids[i].getId();
+			if(id < numBoids){
+				Point coords = boids[i].getCoordinates();
+				Vector velocity = boids[i].getVelocity();
+				x[id] = coords.x;
+				y[id] = coords.y;
+				vx[id] = velocity.x;
+				vy[id] = velocity.y;
+			}
+		}
+	});
+}
+
+/**
+ * Getter for the size of the population.
+ *
+ * @return	The number of Boids.
+ */
+unsigned int Simulation::size() const{
+	unsigned int total = 0;
+	for(unsigned int p = 0; p < partitions.size(); p++){
+		total += partitions[p].boids.size();
+	}
+
+	return total;
+}
+
+/**
+ * Getter for the amount of data that crossed strips in the last step.
+ *
+ * @return	Total number of halo Boids read by all strips.
+ */
+unsigned int Simulation::haloSize() const{
+	unsigned int total = 0;
+	for(unsigned int p = 0; p < partitions.size(); p++){
+		total += partitions[p].halo.size();
+	}
+
+	return total;
+}
+
+/**
+ * Getter for the order parameters of the population.
+ *
+ * @return	Order parameters of the population as it was at the start of
+ * 		the last step.
+ */
+Observables Simulation::getObservables() const{
+	return latest;
+}
+
+/**
+ * Getter for the timings of the last step.
+ *
+ * @return	Where the time of the last step went, phase by phase and
+ * 		strip by strip.
+ */
+const StepProfile& Simulation::getProfile() const{
+	return profile;
+}
+
+/**
+ * Getter for the extent of the world.
+ *
+ * @return	X and Y coordinates of the maximum extent of the world.
+ */
+Point Simulation::getEdges() const{
+	return edges;
+}
+
+/**
+ * Sets whether to keep the flockmates of every Boid during the following
+ * steps, for getNeighborGraph().
+ *
+ * @param keep	true to keep them.
+ */
+void Simulation::keepNeighbors(bool keep){
+	keepingNeighbors = keep;
+}
+
+/**
+ * Puts together the neighbor graph of the last step from the flockmates
+ * kept by the strips: every strip copies its lists to their place in the
+ * graph, on its own worker. Empty unless neighbors are being kept.
+ *
+ * @param graph	Filled with the graph, by identity. Boids with an identity
+ * 		outside of the population are left out.
+ */
+void Simulation::getNeighborGraph(NeighborGraph& graph){
+	unsigned int numBoids = size();
+	graph.offsets.assign(numBoids + 1, 0);
+	for(unsigned int p = 0; p < partitions.size() && keepingNeighbors; p++){
+		const NeighborLists& lists = partitions[p].neighbors;
+		for(unsigned int i = 0; i < lists.boids.size(); i++){
+			if(lists.boids[i] < numBoids){
+				graph.offsets[lists.boids[i] + 1] = lists.counts[i];
+			}
+		}
+	}
+	for(unsigned int i = 0; i < numBoids; i++){
+		graph.offsets[i + 1] += graph.offsets[i];
+	}
+	graph.indices.resize(graph.offsets.back());
+	graph.weights.resize(graph.offsets.back());
+	if(!keepingNeighbors){
+		return;
+	}
+
+	forEachStrip([&](unsigned int p){
+		const NeighborLists& lists = partitions[p].neighbors;
+		unsigned long long from = 0;
+		for(unsigned int i = 0; i < lists.boids.size(); i++){
+			if(lists.boids[i] < numBoids){
+				unsigned long long to = graph.offsets[lists.boids[i]];
+				copy(lists.flockmates.begin() + from, lists.flockmates.begin() + from + lists.counts[i], graph.indices.begin() + to);
+				copy(lists.weights.begin() + from, lists.weights.begin() + from + lists.counts[i], graph.weights.begin() + to);
+			}
+			from += lists.counts[i];
+		}
+	});
+}
+
+/**
+ * Copies the residents close to the edges of a strip into its edge lists,
+ * and sums up the positions of all of its residents on the way, for the
+ * centroid to measure milling around.
+ *
+ * @param part		Index of the strip.
+ * @param cutoff	Perception cutoff.
+ */
+void Simulation::exportEdges(unsigned int part, float cutoff){
+	Partition& own = partitions[part];
+	own.leftEdge.clear();
+	own.rightEdge.clear();
+	own.positionX = own.positionY = 0.0;
+	for(unsigned int i = 0; i < own.boids.size(); i++){
+		Point coords = own.boids[i].getCoordinates();
+		float x = coords.x;
+		own.positionX += coords.x;
+		own.positionY += coords.y;
+		if(x < own.left + cutoff){
+			own.leftEdge.push_back(own.boids[i]);
+		}
+		if(x >= own.right - cutoff){
+			own.rightEdge.push_back(own.boids[i]);
+		}
+	}
+}
+
+/**
+ * Advances the residents of a strip one tic.
+ *
+ * Boids that end up outside of the strip are set aside as emigrants.
+ *
+ * @param part		Index of the strip.
+ * @param destination	Coordinates toward which the boids should head.
+ * @param quality	Perception cutoff and flockmate stride to use.
+ */
+void Simulation::advance(unsigned int part, const Point& destination, const QualitySettings& quality){
+	Partition& own = partitions[part];
+
+	/* Gather the halo: Boids in other strips that are close enough to
+	 * be perceived from this one. Strips to the left can only reach in
+	 * with their right edge, and vice versa.
+	 */
+	own.halo.clear();
+	for(unsigned int p = 0; p < partitions.size(); p++){
+		if(p < part && partitions[p].right > own.left - quality.cutoff){
+			const vector<Boid>& edge = partitions[p].rightEdge;
+			for(unsigned int i = 0; i < edge.size(); i++){
+				if(edge[i].getCoordinates().x >= own.left - quality.cutoff){
+					own.halo.push_back(edge[i]);
+				}
+			}
+		}
+		else if(p > part && partitions[p].left < own.right + quality.cutoff){
+			const vector<Boid>& edge = partitions[p].leftEdge;
+			for(unsigned int i = 0; i < edge.size(); i++){
+				if(edge[i].getCoordinates().x < own.right + quality.cutoff){
+					own.halo.push_back(edge[i]);
+				}
+			}
+		}
+	}
+
+	/* Advance everybody, then sort out who stays and who leaves.
+	 */
+	clearSums(own.sums);
+	advanceResidents(own.boids, own.halo, destination, quality, 1.0, edges, wrap, own.seed, own.flockmates, own.kinematics, own.moved, centroid, own.sums, keepingNeighbors ? &own.neighbors : NULL);
+
+	own.next.clear();
+	own.emigrants.clear();
+	for(unsigned int i = 0; i < own.moved.size(); i++){
+		if(stripOf(own.moved[i]) == part){
+			own.next.push_back(own.moved[i]);
+		}
+		else{
+			own.emigrants.push_back(own.moved[i]);
+		}
+	}
+}
+
+/**
+ * Makes the advanced residents of a strip current, and takes in the Boids
+ * that moved into it from other strips.
+ *
+ * @param part	Index of the strip.
+ */
+void Simulation::immigrate(unsigned int part){
+	Partition& own = partitions[part];
+	own.boids.swap(own.next);
+
+	for(unsigned int p = 0; p < partitions.size(); p++){
+		if(p == part){
+			continue;
+		}
+		const vector<Boid>& arrivals = partitions[p].emigrants;
+		for(unsigned int i = 0; i < arrivals.size(); i++){
+			if(stripOf(arrivals[i]) == part){
+				own.boids.push_back(arrivals[i]);
+			}
+		}
+	}
+}
+
+/**
+ * Finds the strip a Boid belongs in.
+ *
+ * @param boid	The Boid.
+ * @return	Index of the strip containing it.
+ */
+unsigned int Simulation::stripOf(const Boid& boid) const{
+	float strip = floor(boid.getCoordinates().x / stripWidth);
+	if(strip < 0){
+		return 0;
+	}
+
+	return strip >= partitions.size() ? partitions.size() - 1 : (unsigned int) strip;
+}
+
+/**
+ * Advances a group of Boids one tic, given the other Boids around them.
+ *
+ * Works in two passes: first the acceleration each resident steers itself
+ * with, one resident at a time, and then the motion of the whole group in one
+ * sweep (see Integrator.cpp).
+ *
+ * Boids that fail to stay inside a walled world are put back at some random
+ * valid position near the center, at rest.
+ *
+ * Also adds the residents, as they were before advancing, to a set of
+ * order parameter sums, along with the number of pairs looked at and of
+ * flockmates found.
+ *
+ * @param residents	The Boids to advance.
+ * @param halo		Other Boids that the residents can perceive, but
+ * 			that are advanced elsewhere.
+ * @param destination	Coordinates toward which the boids should head.
+ * @param quality	Perception cutoff and flockmate stride to use.
+ * @param timeStep	Length of the tic; 1 for a regular step.
+ * @param edges		X and Y coordinates of the maximum extent of the
+ * 			simulated space.
+ * @param wrapped	true if the edges of the world wrap around.
+ * @param seed		Random state for respawning.
+ * @param flockmates	Scratch space.
+ * @param motion	Scratch space.
+ * @param moved		Cleared and filled with the advanced residents, in
+ * 			order.
+ * @param centroid	Centroid of the whole population before advancing.
+ * @param sums		Order parameter sums to add the residents to.
+ * @param neighbors	Cleared and filled with the flockmates of every
+ * 			resident, if not NULL.
+ */
+void advanceResidents(const vector<Boid>& residents, const vector<Boid>& halo, const Point& destination, const QualitySettings& quality, double timeStep, const Point& edges, bool wrapped, unsigned int& seed, vector<Boid>& flockmates, Kinematics& motion, vector<Boid>& moved, const Point& centroid, ObservableSums& sums, NeighborLists* neighbors){
+	double cutoffSquared = (double) quality.cutoff*quality.cutoff;
+	unsigned int numResidents = residents.size();
+	unsigned int numCandidates = numResidents + halo.size();
+	if(neighbors){
+		neighbors->boids.clear();
+		neighbors->counts.clear();
+		neighbors->flockmates.clear();
+		neighbors->weights.clear();
+	}
+
+	resizeKinematics(motion, numResidents);
+	for(unsigned int i = 0; i < numResidents; i++){
+		/* Only consider the rest of the flock (that is close enough to
+		 * matter), not yourself. Residents come first, then the halo.
+		 */
+		Point position = residents[i].getCoordinates();
+		double nearestSquared = -1.0;
+		flockmates.clear();
+		for(unsigned int j = i % quality.stride; j < numCandidates; j += quality.stride){
+			const Boid& other = j < numResidents ? residents[j] : halo[j - numResidents];
+			double distSquared = d2(position, other.getCoordinates());
+			if(j != i && distSquared <= cutoffSquared){
+				flockmates.push_back(other);
+				nearestSquared = nearestSquared < 0.0 || distSquared < nearestSquared ? distSquared : nearestSquared;
+				if(neighbors){
+					float seen = 1.0/pow(distSquared, PERCEPTION_FALL_OFF/2);
+					neighbors->flockmates.push_back(other.getId());
+					neighbors->weights.push_back(seen < 1.0 ? seen : 1.0);
+				}
+			}
+		}
+		if(neighbors){
+			neighbors->boids.push_back(residents[i].getId());
+			neighbors->counts.push_back(flockmates.size());
+		}
+		addBoid(sums, residents[i], centroid, nearestSquared);
+		sums.pairTests += (numCandidates - i % quality.stride + quality.stride - 1)/quality.stride;
+		sums.interactions += flockmates.size();
+
+		Vector velocity = residents[i].getVelocity();
+		Vector acceleration = residents[i].steeringAcceleration(flockmates, destination);
+		motion.x[i] = position.x;
+		motion.y[i] = position.y;
+		motion.vx[i] = velocity.x;
+		motion.vy[i] = velocity.y;
+		motion.ax[i] = acceleration.x;
+		motion.ay[i] = acceleration.y;
+	}
+
+	bool anyEscaped = integrate(motion, numResidents, edges, wrapped, DRAG_COEFFICIENT, timeStep) > 0;
+
+	moved.clear();
+	for(unsigned int i = 0; i < numResidents; i++){
+		if(anyEscaped && hasEscaped(motion, i, edges)){
+			float x = (int) (edges.x/2) - 100 + rand_r(&seed) % 200;
+			float y = (int) (edges.y/2) - 100 + rand_r(&seed) % 200;
+			moved.push_back(residents[i].placedAt(Point(x, y), Vector(0.0, 0.0), residents[i].getId()));
+		}
+		else{
+			moved.push_back(residents[i].placedAt(Point(motion.x[i], motion.y[i]), Vector(motion.vx[i], motion.vy[i]), residents[i].getId()));
+		}
+	}
+}
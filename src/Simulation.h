@@ -0,0 +1,112 @@
+/**
+ * \file Simulation.h
+ *
+ * Parallel engine that advances a population of Boids. See implementation
+ * for more details.
+ *
+ * @since	2026-10-18
+ * @see		Simulation.cpp
+ */
+
+/* Idempotency.
+ */
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+/**
+ * Includes.
+ */
+#include <vector>
+#include <chrono>
+#include "WorkerPool.h"
+#include "Integrator.h"
+#include "Boid.h"
+#include "QualityController.h"
+#include "Observables.h"
+#include "NeighborGraph.h"
+
+/**
+ * Definitions.
+ */
+using namespace std;
+
+/**
+ * A vertical strip of the world, along with the Boids in it. Owned (and
+ * allocated) by a single worker.
+ */
+struct Partition {
+	float left;			// Strip covers left <= x < right.
+	float right;
+	vector<Boid> boids;		// Current residents.
+	vector<Boid> next;		// Residents after the step in progress.
+	vector<Boid> leftEdge;		// Residents within the cutoff of the left edge.
+	vector<Boid> rightEdge;		// Residents within the cutoff of the right edge.
+	vector<Boid> halo;		// Edge residents of other strips within reach.
+	vector<Boid> emigrants;		// Boids that left the strip during the step.
+	vector<Boid> moved;		// Scratch space for the advanced residents.
+	vector<Boid> flockmates;	// Scratch space for a single Boid.
+	Kinematics kinematics;		// Scratch space for moving the residents.
+	ObservableSums sums;		// Order parameters of the residents, before the step.
+	double positionX;		// Sum of the positions of the residents, before the step.
+	double positionY;
+	NeighborLists neighbors;	// Flockmates of the residents in the step, if kept.
+	unsigned int seed;		// Random state for respawning.
+};
+
+/**
+ * Where the time of a step went, for finding out what made it slow. Times
+ * are in milliseconds from its start.
+ */
+struct StepProfile {
+	chrono::steady_clock::time_point start;
+	float exported;			// End of each phase: halos handed out,
+	float advanced;			// residents advanced,
+	float immigrated;		// and emigrants taken in.
+	vector<float> stripStart;	// Advancing each strip, on its worker.
+	vector<float> stripEnd;
+	vector<unsigned int> residents;	// Of each strip, and the halo they saw.
+	vector<unsigned int> haloSizes;
+};
+
+class Simulation {
+	public:
+		Simulation(const vector<Boid>& initialPop, Point edgeOfWorld, bool wrapped, WorkerPool& workers, unsigned int stripsPerWorker);
+		~Simulation();
+
+		void reset(const vector<Boid>& pop);
+		void step(const Point& destination, const QualitySettings& quality);
+		void getBoids(vector<Boid>& pop) const;
+		void getState(double* x, double* y, double* vx, double* vy, unsigned int numBoids);
+		unsigned int size() const;
+		unsigned int haloSize() const;
+		Observables getObservables() const;
+		const StepProfile& getProfile() const;
+		Point getEdges() const;
+		void keepNeighbors(bool keep);
+		void getNeighborGraph(NeighborGraph& graph);
+
+	protected:
+		void forEachStrip(const function<void(unsigned int)>& task);
+		void exportEdges(unsigned int part, float cutoff);
+		void advance(unsigned int part, const Point& destination, const QualitySettings& quality);
+		void immigrate(unsigned int part);
+		unsigned int stripOf(const Boid& boid) const;
+
+		/* Properties.
+		 */
+		WorkerPool& pool;
+		vector<Partition> partitions;
+		Point edges;
+		bool wrap;
+		float stripWidth;
+		Observables latest;
+		Point centroid;			// Of the current residents, to measure milling around.
+		StepProfile profile;		// Of the last step.
+		bool keepingNeighbors;
+};
+
+void advanceResidents(const vector<Boid>& residents, const vector<Boid>& halo, const Point& destination, const QualitySettings& quality, double timeStep, const Point& edges, bool wrapped, unsigned int& seed, vector<Boid>& flockmates, Kinematics& motion, vector<Boid>& moved, const Point& centroid, ObservableSums& sums, NeighborLists* neighbors);
+
+/* End idempotency.
+ */
+#endif
@@ -0,0 +1,362 @@
+/**
+ * \file	SmallFlock.cpp
+ *
+ * Fast path for flocks of a few hundred Boids at most, as in parameter sweeps
+ * and tournaments, where strips, halos, worker threads and a vector of
+ * flockmates per Boid cost more than the flocking itself.
+ *
+ * The flock is compiled in at fixed sizes (powers of two from
+ * SMALL_FLOCK_MIN up to SMALL_FLOCK_MAX), each the smallest that fits being
+ * padded with absent Boids. Its state is one array per component, a few
+ * kilobytes that stay in L1 cache. Every Boid looks at every other Boid in a
+ * loop of a length known at compile time, with no branches: absent Boids,
+ * the Boid itself and Boids beyond the cutoff are masked out rather than
+ * skipped, so that the compiler can unroll and vectorize the loop (this file
+ * is built with VFLAGS, see the Makefile). The rules are those of
+ * BehaviorRules.h, worked out in double precision throughout, and the
+ * motion is that of Integrator.cpp, walls and all.
+ *
+ * Only flocks in which every Boid flies by the same coefficients, and that
+ * consider every flockmate (a stride of 1), can take this path.
+ *
+ * @since	2026-10-18
+ */
+
+/**
+ * Includes.
+ */
+#include <stdlib.h>
+#include <math.h>
+#include "Integrator.h"
+#include "SmallFlock.h"
+
+/**
+ * Definitions.
+ */
+#define SMALL_FLOCK_MIN 8 // Smallest compiled size
+
+static_assert(PERCEPTION_FALL_OFF == 2.75, "pairSums() works out the perception for a fall-off of 2.75");
+
+/**
+ * What a Boid makes of its flockmates, summed up.
+ */
+struct PairSums {
+	double positionX, positionY;	// Weighted by perception.
+	double velocityX, velocityY;	// Weighted by perception.
+	double perception;
+	double separationX, separationY;
+	double flockmates;
+};
+
+/**
+ * Sums up the flockmates of one Boid, over all N slots of the flock.
+ *
+ * Whether a slot holds a flockmate in sight is a factor of 1 or 0, so that
+ * every slot goes through the same arithmetic. The perception 1/r^2.75 is
+ * worked out as 1/(r^2*sqrt(r)*sqrt(sqrt(r))), which needs no pow() and so
+ * vectorizes.
+ *
+ * @param selfX		X coordinate of the Boid.
+ * @param selfY		Y coordinate of the Boid.
+ * @param x, y		Positions of all slots.
+ * @param vx, vy	Velocities of all slots.
+ * @param present	1 for slots holding a flockmate, 0 for empty slots
+ * 			and the Boid itself.
+ * @param cutoffSquared	Square of the perception cutoff.
+ * @param sums		Filled with the sums.
+ */
+template<unsigned int N> static void pairSums(double selfX, double selfY, const double* __restrict__ x, const double* __restrict__ y, const double* __restrict__ vx, const double* __restrict__ vy, const double* __restrict__ present, double cutoffSquared, PairSums& sums){
+	double positionX = 0.0, positionY = 0.0, velocityX = 0.0, velocityY = 0.0, perception = 0.0;
+	double separationX = 0.0, separationY = 0.0, flockmates = 0.0;
+	for(unsigned int j = 0; j < N; j++){
+		double dx = selfX - x[j];
+		double dy = selfY - y[j];
+		double distSquared = dx*dx + dy*dy;
+		double dist = sqrt(distSquared);
+		double rootDist = sqrt(dist);
+		double seen = 1.0/(distSquared*rootDist*sqrt(rootDist));
+		double flockmate = present[j]*(distSquared <= cutoffSquared ? 1.0 : 0.0);
+
+		double weight = flockmate*(seen < 1.0 ? seen : 1.0);
+		positionX += weight*x[j];
+		positionY += weight*y[j];
+		velocityX += weight*vx[j];
+		velocityY += weight*vy[j];
+		perception += weight;
+
+		/* Flockmates right on top of the Boid give no direction to
+		 * steer in.
+		 */
+		double push = flockmate*(dist > 0.0 ? COLLISION_DIST/(distSquared*dist) : 0.0);
+		separationX += push*dx;
+		separationY += push*dy;
+
+		flockmates += flockmate;
+	}
+
+	sums.positionX = positionX;
+	sums.positionY = positionY;
+	sums.velocityX = velocityX;
+	sums.velocityY = velocityY;
+	sums.perception = perception;
+	sums.separationX = separationX;
+	sums.separationY = separationY;
+	sums.flockmates = flockmates;
+}
+
+/**
+ * Squared distance from a Boid to its nearest flockmate in sight, over all N
+ * slots of the flock. Only needed for the order parameters.
+ *
+ * @param selfX		X coordinate of the Boid.
+ * @param selfY		Y coordinate of the Boid.
+ * @param x, y		Positions of all slots.
+ * @param present	1 for slots holding a flockmate, 0 for empty slots
+ * 			and the Boid itself.
+ * @param cutoffSquared	Square of the perception cutoff.
+ * @return		The squared distance, or -1 if there is no flockmate
+ * 			in sight.
+ */
+template<unsigned int N> static double nearestSquared(double selfX, double selfY, const double* x, const double* y, const double* present, double cutoffSquared){
+	double nearest = -1.0;
+	for(unsigned int j = 0; j < N; j++){
+		double dx = selfX - x[j];
+		double dy = selfY - y[j];
+		double distSquared = dx*dx + dy*dy;
+		if(present[j] > 0.0 && distSquared <= cutoffSquared && (nearest < 0.0 || distSquared < nearest)){
+			nearest = distSquared;
+		}
+	}
+
+	return nearest;
+}
+
+/**
+ * A small flock with room for N Boids.
+ */
+template<unsigned int N> class FixedFlock : public SmallFlock {
+	public:
+		FixedFlock(const vector<Boid>& pop, const RuleCoefficients& ruleCoefficients, const Point& edgeOfWorld);
+
+		void step(const Point& destination, float cutoff, bool observe);
+		void getBoids(vector<Boid>& pop) const;
+		unsigned int size() const;
+
+	protected:
+		Vector acceleration(unsigned int boid, const Point& destination, const PairSums& sums) const;
+		Boid boidAt(unsigned int boid) const;
+
+		/* Properties.
+		 */
+		Kinematics motion;		// N slots, the first numBoids in use.
+		double present[N];		// 1 for slots in use.
+		unsigned int ids[N];
+		unsigned int numBoids;
+		RuleCoefficients coefficients;
+		Point edges;
+		unsigned int seed;		// Random state for respawning.
+};
+
+/**
+ * Constructor from values.
+ *
+ * @param pop			The population; at most N Boids.
+ * @param ruleCoefficients	Coefficients every Boid flies by.
+ * @param edgeOfWorld		X and Y coordinates of the maximum extent of
+ * 				the simulated space, which has walls.
+ * @return			A fully specified object.
+ */
+template<unsigned int N> FixedFlock<N>::FixedFlock(const vector<Boid>& pop, const RuleCoefficients& ruleCoefficients, const Point& edgeOfWorld){
+	numBoids = pop.size();
+	coefficients = ruleCoefficients;
+	edges = edgeOfWorld;
+	seed = 1;
+
+	/* Empty slots sit at the origin, at rest, and are never seen.
+	 */
+	resizeKinematics(motion, N);
+	ObservableSums sums;
+	clearSums(sums);
+	for(unsigned int i = 0; i < N; i++){
+		Point coords = i < numBoids ? pop[i].getCoordinates() : Point(0.0, 0.0);
+		Vector velocity = i < numBoids ? pop[i].getVelocity() : Vector(0.0, 0.0);
+		motion.x[i] = coords.x;
+		motion.y[i] = coords.y;
+		motion.vx[i] = velocity.x;
+		motion.vy[i] = velocity.y;
+		motion.ax[i] = motion.ay[i] = 0.0;
+		present[i] = i < numBoids ? 1.0 : 0.0;
+		ids[i] = i < numBoids ? pop[i].getId() : 0;
+		if(i < numBoids){
+			addBoid(sums, pop[i], Point(0.0, 0.0), -1.0);
+		}
+	}
+	latest = summarizeSums(sums);
+}
+
+/**
+ * Advances every Boid one tic.
+ *
+ * Boids that fail to stay inside the world are put back at some random
+ * valid position near the center, at rest.
+ *
+ * @param destination	Coordinates toward which the boids should head.
+ * @param cutoff	Perception cutoff.
+ * @param observe	true to sum up the order parameters of the flock
+ * 			before the step, for getObservables().
+ */
+template<unsigned int N> void FixedFlock<N>::step(const Point& destination, float cutoff, bool observe){
+	double cutoffSquared = (double) cutoff*cutoff;
+
+	ObservableSums sums;
+	Point centroid(0.0, 0.0);
+	if(observe){
+		clearSums(sums);
+		for(unsigned int i = 0; i < numBoids; i++){
+			centroid.x += motion.x[i]/numBoids;
+			centroid.y += motion.y[i]/numBoids;
+		}
+	}
+
+	/* The Boid itself is left out by marking its slot empty for the
+	 * while.
+	 */
+	PairSums pairs;
+	for(unsigned int i = 0; i < numBoids; i++){
+		present[i] = 0.0;
+		pairSums<N>(motion.x[i], motion.y[i], &motion.x[0], &motion.y[0], &motion.vx[0], &motion.vy[0], present, cutoffSquared, pairs);
+		if(observe){
+			addBoid(sums, boidAt(i), centroid, nearestSquared<N>(motion.x[i], motion.y[i], &motion.x[0], &motion.y[0], present, cutoffSquared));
+		}
+		present[i] = 1.0;
+
+		Vector steering = acceleration(i, destination, pairs);
+		motion.ax[i] = steering.x;
+		motion.ay[i] = steering.y;
+	}
+
+	if(integrate(motion, numBoids, edges, false, DRAG_COEFFICIENT, 1.0) > 0){
+		for(unsigned int i = 0; i < numBoids; i++){
+			if(hasEscaped(motion, i, edges)){
+				motion.x[i] = (float) ((int) (edges.x/2) - 100 + rand_r(&seed) % 200);
+				motion.y[i] = (float) ((int) (edges.y/2) - 100 + rand_r(&seed) % 200);
+				motion.vx[i] = motion.vy[i] = 0.0;
+			}
+		}
+	}
+
+	if(observe){
+		latest = summarizeSums(sums);
+	}
+}
+
+/**
+ * Works out the acceleration a Boid steers itself with from the sums over
+ * its flockmates, as the rules of BehaviorRules.h do.
+ *
+ * @param boid		Index of the Boid.
+ * @param destination	Coordinates toward which the boid should head.
+ * @param sums		Sums over its flockmates.
+ * @return		Acceleration vector, drag not included.
+ */
+template<unsigned int N> Vector FixedFlock<N>::acceleration(unsigned int boid, const Point& destination, const PairSums& sums) const{
+	double x = motion.x[boid], y = motion.y[boid];
+	double vx = motion.vx[boid], vy = motion.vy[boid];
+
+	double cohesionX = 0.0, cohesionY = 0.0, alignmentX = 0.0, alignmentY = 0.0;
+	if(sums.flockmates > 0.0){
+		cohesionX = sums.positionX/sums.perception - x;
+		cohesionY = sums.positionY/sums.perception - y;
+		alignmentX = sums.velocityX/sums.perception - vx;
+		alignmentY = sums.velocityY/sums.perception - vy;
+	}
+
+	double attractionX = 0.0, attractionY = 0.0;
+	double dx = x - destination.x, dy = y - destination.y;
+	double dist = sqrt(dx*dx + dy*dy);
+	if(dist > 0.0){
+		double pull = 1.0/(1.0 + DESTINATION_DECAY*dist);
+		attractionX = -pull*dx/dist;
+		attractionY = -pull*dy/dist;
+	}
+
+	return Vector(coefficients.cohesion*cohesionX + coefficients.separation*sums.separationX + coefficients.alignment*alignmentX + coefficients.attraction*attractionX,
+		coefficients.cohesion*cohesionY + coefficients.separation*sums.separationY + coefficients.alignment*alignmentY + coefficients.attraction*attractionY);
+}
+
+/**
+ * Makes a Boid out of a slot.
+ *
+ * @param boid	Index of the slot.
+ * @return	The Boid in it.
+ */
+template<unsigned int N> Boid FixedFlock<N>::boidAt(unsigned int boid) const{
+	return Boid(Point(motion.x[boid], motion.y[boid]), Vector(motion.vx[boid], motion.vy[boid]), coefficients.cohesion, coefficients.separation, coefficients.alignment, coefficients.attraction, edges, ids[boid]);
+}
+
+/**
+ * Collects the whole population.
+ *
+ * @param pop	Cleared and filled with every Boid, in the order they
+ * 		were given in.
+ */
+template<unsigned int N> void FixedFlock<N>::getBoids(vector<Boid>& pop) const{
+	pop.clear();
+	for(unsigned int i = 0; i < numBoids; i++){
+		pop.push_back(boidAt(i));
+	}
+}
+
+/**
+ * Getter for the size of the population.
+ *
+ * @return	The number of Boids.
+ */
+template<unsigned int N> unsigned int FixedFlock<N>::size() const{
+	return numBoids;
+}
+
+/**
+ * Makes a small flock, if the population is small enough.
+ *
+ * @param pop		The population; every Boid must fly by the same
+ * 			coefficients.
+ * @param coefficients	Those coefficients.
+ * @param edgeOfWorld	X and Y coordinates of the maximum extent of the
+ * 			simulated space, which has walls.
+ * @return		The flock, to be deleted by the caller, or NULL if
+ * 			there are more than SMALL_FLOCK_MAX Boids.
+ */
+SmallFlock* SmallFlock::create(const vector<Boid>& pop, const RuleCoefficients& coefficients, const Point& edgeOfWorld){
+	unsigned int numBoids = pop.size();
+	if(numBoids <= SMALL_FLOCK_MIN) return new FixedFlock<SMALL_FLOCK_MIN>(pop, coefficients, edgeOfWorld);
+	if(numBoids <= 16) return new FixedFlock<16>(pop, coefficients, edgeOfWorld);
+	if(numBoids <= 32) return new FixedFlock<32>(pop, coefficients, edgeOfWorld);
+	if(numBoids <= 64) return new FixedFlock<64>(pop, coefficients, edgeOfWorld);
+	if(numBoids <= 128) return new FixedFlock<128>(pop, coefficients, edgeOfWorld);
+	if(numBoids <= SMALL_FLOCK_MAX) return new FixedFlock<SMALL_FLOCK_MAX>(pop, coefficients, edgeOfWorld);
+
+	return NULL;
+}
+
+/**
+ * Default constructor, for subclasses.
+ */
+SmallFlock::SmallFlock(){
+}
+
+/**
+ * Destructor, necessary for inheritance.
+ */
+SmallFlock::~SmallFlock(){
+}
+
+/**
+ * Getter for the order parameters of the population.
+ *
+ * @return	Order parameters of the population as it was at the start of
+ * 		the last step that observed it.
+ */
+Observables SmallFlock::getObservables() const{
+	return latest;
+}
@@ -0,0 +1,59 @@
+/**
+ * \file SmallFlock.h
+ *
+ * Fast path for flocks of a few hundred Boids at most. See implementation
+ * for more details.
+ *
+ * @since	2026-10-18
+ * @see		SmallFlock.cpp
+ */
+
+/* Idempotency.
+ */
+#ifndef SMALL_FLOCK_H
+#define SMALL_FLOCK_H
+
+/**
+ * Includes.
+ */
+#include <vector>
+#include "BehaviorRules.h"
+#include "Observables.h"
+#include "Boid.h"
+
+/**
+ * Definitions.
+ */
+#define SMALL_FLOCK_MAX 256 // Largest flock that takes the fast path
+
+using namespace std;
+
+/**
+ * A small flock that all flies by the same coefficients, on a single thread.
+ * Made by create(), at the smallest compiled size that fits.
+ */
+class SmallFlock {
+	public:
+		static SmallFlock* create(const vector<Boid>& pop, const RuleCoefficients& coefficients, const Point& edgeOfWorld);
+		virtual ~SmallFlock();
+
+		virtual void step(const Point& destination, float cutoff, bool observe) = 0;
+		virtual void getBoids(vector<Boid>& pop) const = 0;
+		virtual unsigned int size() const = 0;
+		Observables getObservables() const;
+
+	protected:
+		SmallFlock();
+
+		/* Properties.
+		 */
+		Observables latest;
+
+	private:
+		SmallFlock(const SmallFlock&);
+		SmallFlock& operator=(const SmallFlock&);
+};
+
+/* End idempotency.
+ */
+#endif
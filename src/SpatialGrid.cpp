@@ -0,0 +1,151 @@
+/**
+ * \file	SpatialGrid.cpp
+ *
+ * Uniform grid over the world for finding Boids that are close to each
+ * other without comparing every Boid to every other.
+ *
+ * The Boids are sorted into square cells by a counting sort, and stored cell
+ * by cell in one array (with an array of offsets to where each cell starts),
+ * so that a cell and its neighbors can be scanned without chasing pointers.
+ * Boids outside of the world are put in the nearest cell on the border.
+ *
+ * @since	2026-10-18
+ */
+
+/**
+ * Includes.
+ */
+#include "SpatialGrid.h"
+#include <math.h>
+
+/**
+ * Constructor from values.
+ *
+ * @param edgeOfWorld	X and Y coordinates of the maximum extent of the
+ * 			simulated space.
+ * @param cellSize	Width and height of a cell.
+ * @return		An empty grid.
+ */
+SpatialGrid::SpatialGrid(Point edgeOfWorld, float cellSize){
+	edges = edgeOfWorld;
+	size = cellSize > 1.0 ? cellSize : 1.0;
+	columns = (unsigned int) ceil(edges.x / size);
+	rows = (unsigned int) ceil(edges.y / size);
+	columns = columns > 0 ? columns : 1;
+	rows = rows > 0 ? rows : 1;
+	cellStarts.assign(columns*rows + 1, 0);
+}
+
+/**
+ * Default destructor.
+ */
+SpatialGrid::~SpatialGrid(){
+}
+
+/**
+ * Sorts a population into the cells, replacing whatever was there before.
+ *
+ * @param boids	The population.
+ */
+void SpatialGrid::build(const vector<Boid>& boids){
+	unsigned int numBoids = boids.size();
+	xs.resize(numBoids);
+	ys.resize(numBoids);
+	members.resize(numBoids);
+	cellStarts.assign(columns*rows + 1, 0);
+
+	/* Count the residents of each cell...
+	 */
+	vector<unsigned int> cells(numBoids);
+	for(unsigned int i = 0; i < numBoids; i++){
+		Point coords = boids[i].getCoordinates();
+		xs[i] = coords.x;
+		ys[i] = coords.y;
+		cells[i] = cellOf(xs[i], ys[i]);
+		cellStarts[cells[i]+1]++;
+	}
+
+	/* ...turn the counts into offsets...
+	 */
+	for(unsigned int c = 0; c < columns*rows; c++){
+		cellStarts[c+1] += cellStarts[c];
+	}
+
+	/* ...and put everybody in their place.
+	 */
+	vector<unsigned int> filled(cellStarts.begin(), cellStarts.end() - 1);
+	for(unsigned int i = 0; i < numBoids; i++){
+		members[filled[cells[i]]++] = i;
+	}
+}
+
+/**
+ * Getter for the number of cells.
+ *
+ * @return	Total number of cells in the grid.
+ */
+unsigned int SpatialGrid::numCells() const{
+	return columns*rows;
+}
+
+/**
+ * Getter for the number of Boids in the grid.
+ *
+ * @return	Size of the population the grid was last built from.
+ */
+unsigned int SpatialGrid::numBoids() const{
+	return members.size();
+}
+
+/**
+ * Finds the cell containing a point.
+ *
+ * @param x	X coordinate.
+ * @param y	Y coordinate.
+ * @return	Index of the cell, row by row.
+ */
+unsigned int SpatialGrid::cellOf(float x, float y) const{
+	int column = (int) floor(x / size);
+	int row = (int) floor(y / size);
+	column = column < 0 ? 0 : (column >= (int) columns ? columns - 1 : column);
+	row = row < 0 ? 0 : (row >= (int) rows ? rows - 1 : row);
+
+	return row*columns + column;
+}
+
+/**
+ * Getter for the number of Boids in a cell.
+ *
+ * @param cell	Index of the cell.
+ * @return	Number of Boids in it.
+ */
+unsigned int SpatialGrid::cellSize(unsigned int cell) const{
+	return cellStarts[cell+1] - cellStarts[cell];
+}
+
+/**
+ * Getter for the width and height of a cell.
+ *
+ * @return	Size of a cell.
+ */
+float SpatialGrid::getCellSize() const{
+	return size;
+}
+
+/**
+ * Getter for the number of columns of cells.
+ *
+ * @return	Number of cells along the X axis.
+ */
+unsigned int SpatialGrid::getColumns() const{
+	return columns;
+}
+
+/**
+ * Getter for the number of rows of cells.
+ *
+ * @return	Number of cells along the Y axis.
+ */
+unsigned int SpatialGrid::getRows() const{
+	return rows;
+}
@@ -0,0 +1,117 @@
+/**
+ * \file SpatialGrid.h
+ *
+ * Uniform grid for finding Boids that are close to each other. See
+ * implementation for more details.
+ *
+ * @since	2026-10-18
+ * @see		SpatialGrid.cpp
+ */
+
+/* Idempotency.
+ */
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+/**
+ * Includes.
+ */
+#include <vector>
+#include "Boid.h"
+
+/**
+ * Definitions.
+ */
+using namespace std;
+
+class SpatialGrid {
+	public:
+		SpatialGrid(Point edgeOfWorld, float cellSize);
+		~SpatialGrid();
+
+		void build(const vector<Boid>& boids);
+		unsigned int numCells() const;
+		unsigned int numBoids() const;
+		unsigned int cellOf(float x, float y) const;
+		unsigned int cellSize(unsigned int cell) const;
+		float getCellSize() const;
+		unsigned int getColumns() const;
+		unsigned int getRows() const;
+
+		/**
+		 * Visits every pair of Boids closer than some radius, once.
+		 *
+		 * Only pairs in which the first Boid lives in one of the given
+		 * cells are visited, so disjoint ranges of cells can be
+		 * handed to different threads. The radius must not be larger
+		 * than the size of a cell.
+		 *
+		 * @param firstCell	First cell to visit.
+		 * @param lastCell	One past the last cell to visit.
+		 * @param radius	Maximum distance between the Boids.
+		 * @param visit		Called as visit(i, j, distanceSquared)
+		 * 			with the indices of the Boids in the
+		 * 			population the grid was built from.
+		 */
+		template<class Visitor> void forEachPair(unsigned int firstCell, unsigned int lastCell, float radius, Visitor& visit) const{
+			/* Half of the surrounding cells: the rest are covered
+			 * when visiting from the other side.
+			 */
+			const int stencil[4][2] = {{1, 0}, {-1, 1}, {0, 1}, {1, 1}};
+			float radiusSquared = radius*radius;
+
+			for(unsigned int cell = firstCell; cell < lastCell; cell++){
+				int column = cell % columns;
+				int row = cell / columns;
+				for(unsigned int a = cellStarts[cell]; a < cellStarts[cell+1]; a++){
+					unsigned int i = members[a];
+
+					/* Pairs within the cell itself.
+					 */
+					for(unsigned int b = a+1; b < cellStarts[cell+1]; b++){
+						unsigned int j = members[b];
+						float dx = xs[j] - xs[i], dy = ys[j] - ys[i];
+						float distSquared = dx*dx + dy*dy;
+						if(distSquared <= radiusSquared){
+							visit(i, j, distSquared);
+						}
+					}
+
+					/* Pairs with the neighboring cells.
+					 */
+					for(unsigned int s = 0; s < 4; s++){
+						int otherColumn = column + stencil[s][0];
+						int otherRow = row + stencil[s][1];
+						if(otherColumn < 0 || otherColumn >= (int) columns || otherRow >= (int) rows){
+							continue;
+						}
+						unsigned int other = otherRow*columns + otherColumn;
+						for(unsigned int b = cellStarts[other]; b < cellStarts[other+1]; b++){
+							unsigned int j = members[b];
+							float dx = xs[j] - xs[i], dy = ys[j] - ys[i];
+							float distSquared = dx*dx + dy*dy;
+							if(distSquared <= radiusSquared){
+								visit(i, j, distSquared);
+							}
+						}
+					}
+				}
+			}
+		}
+
+	protected:
+		/* Properties.
+		 */
+		Point edges;
+		float size;
+		unsigned int columns;
+		unsigned int rows;
+		vector<unsigned int> cellStarts;	// Members of cell c are members[cellStarts[c]] up to members[cellStarts[c+1]].
+		vector<unsigned int> members;		// Indices of the Boids, cell by cell.
+		vector<float> xs;			// Coordinates of the Boids, by index.
+		vector<float> ys;
+};
+
+/* End idempotency.
+ */
+#endif
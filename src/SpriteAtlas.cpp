@@ -0,0 +1,311 @@
+/**
+ * \file	SpriteAtlas.cpp
+ *
+ * Sprites of a Boid at every heading, size and tint, drawn once at startup
+ * into one surface, so that none of it costs anything while drawing frames.
+ *
+ * The sprites are baked from a strip with a handful of headings: each heading
+ * of the atlas starts from the closest one on the strip and turns it the
+ * rest of the way, and each zoom level scales it, both by looking up the
+ * source pixel under the middle of every target pixel (no blending, which
+ * would smear the transparent color into the edges). Tinted sprites take
+ * the brightness of the source and the hue of the tint. Tint 0 keeps the
+ * colors of the strip.
+ *
+ * Sprites of the same zoom and tint lie side by side on shelves, and every
+ * frame is found by arithmetic on its heading, zoom and tint, in constant
+ * time.
+ *
+ * @since	2026-10-18
+ */
+
+/**
+ * Includes.
+ */
+#include <math.h>
+#include <stdexcept>
+#include "SpriteAtlas.h"
+
+/**
+ * Definitions.
+ */
+#define PI 3.14159265
+#define ATLAS_WIDTH 4096 // Pixels across the atlas, well below what SDL allows
+
+/**
+ * Constructor from values.
+ *
+ * @param strip		Sprites side by side along the top of the image, one
+ * 			for each of a number of headings, counter-clockwise
+ * 			from the X-axis. Its color key, if any, is
+ * 			transparent.
+ * @param stripFrames	Number of sprites on the strip.
+ * @param spriteWidth	Width of a sprite on the strip.
+ * @param spriteHeight	Height of a sprite on the strip.
+ * @param numHeadings	Number of headings to draw.
+ * @param zooms		Sizes to draw, relative to the strip.
+ * @param tints		Colors to draw in besides the colors of the strip,
+ * 			as 0xRRGGBB.
+ * @return		A fully specified object.
+ * @throws		std::runtime_error if the strip is not 32-bit, too
+ * 			small or can't be read, or the atlas can't be made.
+ */
+SpriteAtlas::SpriteAtlas(SDL_Surface* strip, unsigned int stripFrames, unsigned int spriteWidth, unsigned int spriteHeight, unsigned int numHeadings, const vector<float>& zooms, const vector<Uint32>& tints){
+	SDL_PixelFormat* format = strip->format;
+	if(format->BytesPerPixel != 4){
+		throw runtime_error("Sprite strip is not 32-bit");
+	}
+	if((unsigned int) strip->w < spriteWidth*stripFrames || (unsigned int) strip->h < spriteHeight){
+		throw runtime_error("Sprite strip is too small");
+	}
+	if(numHeadings == 0 || zooms.empty()){
+		throw runtime_error("Nothing to put in the sprite atlas");
+	}
+
+	headings = numHeadings;
+	numZooms = zooms.size();
+	numTints = tints.size() + 1;
+	tintColors = tints;
+	keyed = (strip->flags & SDL_SRCCOLORKEY) != 0;
+	colorKey = keyed ? format->colorkey : SDL_MapRGB(format, 255, 0, 255);
+
+	/* Locking also undoes the run-length encoding of keyed surfaces.
+	 */
+	if(SDL_MUSTLOCK(strip) && SDL_LockSurface(strip) < 0){
+		throw runtime_error("Unable to read the sprite strip");
+	}
+	unsigned int stripWidth = spriteWidth*stripFrames;
+	vector<Uint32> source(stripWidth*spriteHeight);
+	for(unsigned int y = 0; y < spriteHeight; y++){
+		const Uint32* row = (const Uint32*) ((const Uint8*) strip->pixels + y*strip->pitch);
+		for(unsigned int x = 0; x < stripWidth; x++){
+			source[y*stripWidth + x] = row[x];
+		}
+	}
+	if(SDL_MUSTLOCK(strip)){
+		SDL_UnlockSurface(strip);
+	}
+
+	/* Lay the frames out on shelves, a new shelf for every zoom and
+	 * tint and whenever one fills up.
+	 */
+	frames.resize(numZooms*numTints*headings);
+	int shelfTop = 0;
+	int atlasWidth = 0;
+	for(unsigned int z = 0; z < numZooms; z++){
+		int width = (int) ceil(spriteWidth*zooms[z]);
+		int height = (int) ceil(spriteHeight*zooms[z]);
+		if(width <= 0 || height <= 0 || width > ATLAS_WIDTH){
+			throw runtime_error("Sprite zoom out of range");
+		}
+		for(unsigned int t = 0; t < numTints; t++){
+			int x = 0;
+			for(unsigned int h = 0; h < headings; h++){
+				if(x + width > ATLAS_WIDTH){
+					x = 0;
+					shelfTop += height;
+				}
+				SDL_Rect& frame = frames[(z*numTints + t)*headings + h];
+				frame.x = x;
+				frame.y = shelfTop;
+				frame.w = width;
+				frame.h = height;
+				x += width;
+				atlasWidth = x > atlasWidth ? x : atlasWidth;
+			}
+			shelfTop += height;
+		}
+	}
+
+	atlas = SDL_CreateRGBSurface(SDL_SWSURFACE, atlasWidth, shelfTop, 32, format->Rmask, format->Gmask, format->Bmask, format->Amask);
+	if(!atlas){
+		throw runtime_error("Unable to make the sprite atlas");
+	}
+	SDL_SetColorKey(atlas, SDL_SRCCOLORKEY, colorKey);
+
+	for(unsigned int z = 0; z < numZooms; z++){
+		for(unsigned int t = 0; t < numTints; t++){
+			for(unsigned int h = 0; h < headings; h++){
+				bake(source, stripWidth, stripFrames, spriteWidth, spriteHeight, h, zooms[z], t, frames[(z*numTints + t)*headings + h]);
+			}
+		}
+	}
+}
+
+/**
+ * Destructor.
+ */
+SpriteAtlas::~SpriteAtlas(){
+	SDL_FreeSurface(atlas);
+}
+
+/**
+ * Draws one frame of the atlas.
+ *
+ * @param source	Pixels of the strip.
+ * @param stripWidth	Width of the strip.
+ * @param stripFrames	Number of sprites on the strip.
+ * @param spriteWidth	Width of a sprite on the strip.
+ * @param spriteHeight	Height of a sprite on the strip.
+ * @param heading	Heading to draw.
+ * @param zoom		Size to draw at, relative to the strip.
+ * @param tint		Tint to draw in.
+ * @param frame		Where in the atlas to draw.
+ */
+void SpriteAtlas::bake(const vector<Uint32>& source, unsigned int stripWidth, unsigned int stripFrames, unsigned int spriteWidth, unsigned int spriteHeight, unsigned int heading, float zoom, unsigned int tint, const SDL_Rect& frame){
+	/* Start from the closest heading on the strip, and turn the rest
+	 * of the way.
+	 */
+	float angle = heading*360.0/headings;
+	float degreesPerFrame = 360.0/stripFrames;
+	unsigned int closest = (unsigned int) floor(angle/degreesPerFrame + 0.5) % stripFrames;
+	float turn = (angle - closest*degreesPerFrame)*PI/180.0;
+	if(turn > PI){
+		turn -= 2*PI;
+	}
+	float c = cos(turn), s = sin(turn);
+
+	Uint8 tintR = (tint > 0 ? tintColors[tint-1] : 0) >> 16;
+	Uint8 tintG = (tint > 0 ? tintColors[tint-1] : 0) >> 8;
+	Uint8 tintB = (tint > 0 ? tintColors[tint-1] : 0);
+
+	Uint32* pixels = (Uint32*) atlas->pixels;
+	unsigned int pitch = atlas->pitch/4;
+	for(int v = 0; v < frame.h; v++){
+		for(int u = 0; u < frame.w; u++){
+			/* Middle of the target pixel, relative to the middle of
+			 * the sprite, back in the coordinates of the strip. Turning
+			 * counter-clockwise on screen, where Y points down.
+			 */
+			float xd = (u + 0.5 - frame.w*0.5)/zoom;
+			float yd = (v + 0.5 - frame.h*0.5)/zoom;
+			float xs = c*xd - s*yd + spriteWidth*0.5;
+			float ys = s*xd + c*yd + spriteHeight*0.5;
+
+			Uint32 color = colorKey;
+			if(xs >= 0.0 && ys >= 0.0 && xs < spriteWidth && ys < spriteHeight){
+				Uint32 pixel = source[(unsigned int) ys*stripWidth + closest*spriteWidth + (unsigned int) xs];
+				if(!keyed || pixel != colorKey){
+					color = pixel;
+					if(tint > 0){
+						Uint8 r, g, b;
+						SDL_GetRGB(pixel, atlas->format, &r, &g, &b);
+						unsigned int brightness = r > g ? (r > b ? r : b) : (g > b ? g : b);
+						color = SDL_MapRGB(atlas->format, tintR*brightness/255, tintG*brightness/255, tintB*brightness/255);
+					}
+					if(color == colorKey){
+						color ^= 1;
+					}
+				}
+			}
+			pixels[(frame.y + v)*pitch + frame.x + u] = color;
+		}
+	}
+}
+
+/**
+ * Finds the heading of the atlas closest to a direction of travel.
+ *
+ * @param velocity	Direction in which the Boid is moving.
+ * @return		The heading, counted counter-clockwise from the
+ * 			X-axis.
+ */
+unsigned int SpriteAtlas::headingOf(const Vector& velocity) const{
+	/* Calculate the angle to the X-axis.
+	 *
+	 * The coordinate system on screen is left-handed, not the standard
+	 * right-handedness, so a 90 degree rotation needs to be applied.
+	 * atan2() delivers signed angles on [-pi,pi], so negative ones are
+	 * moved up a turn.
+	 */
+	float angle = -90.0 + (180.0/PI)*atan2(velocity.x, velocity.y);
+	angle = angle >= 0.0 ? angle : angle + 360.0;
+
+	float degreesPerHeading = 360.0/headings;
+	return (unsigned int) floor(angle/degreesPerHeading + 0.5) % headings;
+}
+
+/**
+ * Finds a frame.
+ *
+ * @param heading	Heading, as from headingOf().
+ * @param zoom		Index of the zoom level.
+ * @param tint		Index of the tint; 0 for the colors of the strip.
+ * @return		Number of the frame.
+ */
+unsigned int SpriteAtlas::frameOf(unsigned int heading, unsigned int zoom, unsigned int tint) const{
+	return (zoom*numTints + tint)*headings + heading;
+}
+
+/**
+ * Getter for where a frame is in the atlas.
+ *
+ * @param frame	Number of the frame, as from frameOf().
+ * @return	Its rectangle.
+ */
+const SDL_Rect& SpriteAtlas::getFrame(unsigned int frame) const{
+	return frames[frame];
+}
+
+/**
+ * Getter for the number of headings.
+ *
+ * @return	The number of headings.
+ */
+unsigned int SpriteAtlas::getNumHeadings() const{
+	return headings;
+}
+
+/**
+ * Getter for the number of zoom levels.
+ *
+ * @return	The number of zoom levels.
+ */
+unsigned int SpriteAtlas::getNumZooms() const{
+	return numZooms;
+}
+
+/**
+ * Getter for the number of tints, the colors of the strip included.
+ *
+ * @return	The number of tints.
+ */
+unsigned int SpriteAtlas::getNumTints() const{
+	return numTints;
+}
+
+/**
+ * Getter for the pixels of the atlas. Never needs locking.
+ *
+ * @return	The pixels, row after row.
+ */
+const Uint32* SpriteAtlas::getPixels() const{
+	return (const Uint32*) atlas->pixels;
+}
+
+/**
+ * Getter for the distance between rows of the atlas.
+ *
+ * @return	Pixels from one row to the next.
+ */
+unsigned int SpriteAtlas::getPitch() const{
+	return atlas->pitch/4;
+}
+
+/**
+ * Getter for the transparent color.
+ *
+ * @return	The color that is not to be drawn.
+ */
+Uint32 SpriteAtlas::getColorKey() const{
+	return colorKey;
+}
+
+/**
+ * Getter for the atlas as a surface, e.g. for blitting from it.
+ *
+ * @return	The surface.
+ */
+SDL_Surface* SpriteAtlas::getSurface() const{
+	return atlas;
+}
@@ -0,0 +1,65 @@
+/**
+ * \file SpriteAtlas.h
+ *
+ * Sprites of a Boid at every heading, size and tint, drawn once at startup.
+ * See implementation for more details.
+ *
+ * @since	2026-10-18
+ * @see		SpriteAtlas.cpp
+ */
+
+/* Idempotency.
+ */
+#ifndef SPRITE_ATLAS_H
+#define SPRITE_ATLAS_H
+
+/**
+ * Includes.
+ */
+#include <vector>
+#include <SDL/SDL.h>
+#include "Boid.h"
+
+/**
+ * Definitions.
+ */
+using namespace std;
+
+class SpriteAtlas {
+	public:
+		SpriteAtlas(SDL_Surface* strip, unsigned int stripFrames, unsigned int spriteWidth, unsigned int spriteHeight, unsigned int numHeadings, const vector<float>& zooms, const vector<Uint32>& tints);
+		~SpriteAtlas();
+
+		unsigned int headingOf(const Vector& velocity) const;
+		unsigned int frameOf(unsigned int heading, unsigned int zoom, unsigned int tint) const;
+		const SDL_Rect& getFrame(unsigned int frame) const;
+		unsigned int getNumHeadings() const;
+		unsigned int getNumZooms() const;
+		unsigned int getNumTints() const;
+		const Uint32* getPixels() const;
+		unsigned int getPitch() const;
+		Uint32 getColorKey() const;
+		SDL_Surface* getSurface() const;
+
+	protected:
+		void bake(const vector<Uint32>& source, unsigned int stripWidth, unsigned int stripFrames, unsigned int spriteWidth, unsigned int spriteHeight, unsigned int heading, float zoom, unsigned int tint, const SDL_Rect& frame);
+
+		/* Properties.
+		 */
+		SDL_Surface* atlas;
+		vector<SDL_Rect> frames;	// By zoom, then tint, then heading.
+		unsigned int headings;
+		unsigned int numZooms;
+		unsigned int numTints;
+		vector<Uint32> tintColors;
+		Uint32 colorKey;
+		bool keyed;			// Whether the strip had a color key of its own.
+
+	private:
+		SpriteAtlas(const SpriteAtlas&);
+		SpriteAtlas& operator=(const SpriteAtlas&);
+};
+
+/* End idempotency.
+ */
+#endif
@@ -0,0 +1,346 @@
+/**
+ * \file	TileRenderer.cpp
+ *
+ * Draws a population on all of the workers, straight into the pixels of the
+ * screen, instead of blitting one sprite after the other on a single thread.
+ *
+ * The screen is cut up into square tiles. First every worker sorts a share
+ * of the Boids into the tiles their sprite overlaps, keeping lists of its
+ * own so there is nothing to lock. Then the workers take turns picking up
+ * tiles, clear them and copy the sprites of every list for that tile into
+ * them, clipped to the tile. Each tile belongs to exactly one worker, so no
+ * two threads ever write the same pixels, and since the lists are merged in
+ * the order of the Boids, overlapping sprites come out as they would have
+ * one at a time.
+ *
+ * Instead of black, the tiles can be cleared to a heatmap of square cells,
+ * from black for cold cells to red for hot ones, which then shows under the
+ * Boids at no extra cost.
+ *
+ * The Boids can also leave fading trails, however long, without keeping any
+ * history of where they have been: an intensity per pixel of the screen is
+ * kept from frame to frame, faded by a constant factor whenever a frame is
+ * drawn, and topped up under the middle of every Boid. The workers do this
+ * tile by tile along with the rest of the drawing, in one pass over the
+ * pixels and one over the Boids, so trails cost the same whether they fade
+ * in a few frames or hardly at all.
+ *
+ * The sprites come from a SpriteAtlas, at any of its sizes and tints.
+ * Expects a 32-bit screen in the same format as the atlas, which is what
+ * sdl-wrapper sets up.
+ *
+ * @since	2026-10-18
+ */
+
+/**
+ * Includes.
+ */
+#include <math.h>
+#include <algorithm>
+#include "TileRenderer.h"
+
+/**
+ * Definitions.
+ */
+#define TRAIL_LEVELS 256 // Shades of trail, including none
+
+/**
+ * Constructor from values.
+ *
+ * @param sprites	Frames to draw the Boids with. Must outlive the
+ * 			renderer.
+ * @param workers	The threads to draw on. Must outlive the renderer.
+ * @param tilePixels	Pixels along the side of a tile.
+ * @return		A fully specified object.
+ */
+TileRenderer::TileRenderer(const SpriteAtlas& sprites, WorkerPool& workers, unsigned int tilePixels) : atlas(sprites), pool(workers){
+	tileSize = tilePixels > 1 ? tilePixels : 1;
+	screenWidth = 0;
+	screenHeight = 0;
+	columns = 0;
+	rows = 0;
+	heatColumns = 0;
+	heatCell = 1.0;
+	trailDecay = 0.0;
+}
+
+/**
+ * Destructor.
+ */
+TileRenderer::~TileRenderer(){
+}
+
+/**
+ * Draws a population and shows it on screen.
+ *
+ * @param screen	Surface to draw on; must be 32-bit.
+ * @param pop		The population.
+ * @param zoom		Zoom level of the atlas to draw at.
+ * @param tints		Tint of the atlas to draw each Boid in, by identity.
+ * 			Boids without one are drawn in tint 0.
+ * @return		false on inability to lock the screen, true otherwise.
+ */
+bool TileRenderer::draw(SDL_Surface* screen, const vector<Boid>& pop, unsigned int zoom, const vector<unsigned char>& tints){
+	if(screen->w != screenWidth || screen->h != screenHeight){
+		layout(screen->w, screen->h);
+	}
+	if(trailDecay > 0.0 && trail.size() != (size_t) screenWidth*screenHeight){
+		trail.assign((size_t) screenWidth*screenHeight, 0.0);
+	}
+
+	/* Sort the sprites into tiles, each worker a contiguous share of the
+	 * population into lists of its own.
+	 */
+	unsigned int numWorkers = pool.size();
+	unsigned int numTiles = columns*rows;
+	unsigned int numBoids = pop.size();
+	pool.run([&](unsigned int w){
+		bin(pop, (unsigned long) numBoids*w/numWorkers, (unsigned long) numBoids*(w+1)/numWorkers, zoom, tints, &bins[w*numTiles]);
+	});
+
+	if(SDL_MUSTLOCK(screen) && SDL_LockSurface(screen) < 0){
+		return false;
+	}
+
+	/* Then draw the tiles. Neighboring tiles go to different workers,
+	 * which spreads a dense flock out over all of them.
+	 */
+	Uint32* pixels = (Uint32*) screen->pixels;
+	unsigned int pitch = screen->pitch/4;
+	Uint32 background = SDL_MapRGB(screen->format, 0, 0, 0);
+	heatColors.resize(heat.size());
+	for(unsigned int cell = 0; cell < heat.size(); cell++){
+		heatColors[cell] = SDL_MapRGB(screen->format, (Uint8) (200*heat[cell]), (Uint8) (40*heat[cell]), 0);
+	}
+	trailColors.resize(trailDecay > 0.0 ? TRAIL_LEVELS : 0);
+	for(unsigned int level = 0; level < trailColors.size(); level++){
+		float shade = (float) level/(TRAIL_LEVELS - 1);
+		trailColors[level] = SDL_MapRGB(screen->format, (Uint8) (60*shade), (Uint8) (140*shade), (Uint8) (255*shade));
+	}
+	pool.run([&](unsigned int w){
+		for(unsigned int tile = w; tile < numTiles; tile += numWorkers){
+			rasterize(tile, pixels, pitch, background);
+		}
+	});
+
+	if(SDL_MUSTLOCK(screen)){
+		SDL_UnlockSurface(screen);
+	}
+
+	/* Preform the actual rendering.
+	 */
+	SDL_Flip(screen);
+
+	return true;
+}
+
+/**
+ * Sets the heatmap to draw under the Boids from now on.
+ *
+ * @param cellHeat	Heat of every cell, from 0 to 1, row by row. Empty
+ * 			for no heatmap.
+ * @param cellColumns	Number of cells along the X axis.
+ * @param cellPixels	Pixels along the side of a cell.
+ */
+void TileRenderer::setHeatmap(const vector<float>& cellHeat, unsigned int cellColumns, float cellPixels){
+	heat = cellHeat;
+	heatColumns = cellColumns > 0 ? cellColumns : 1;
+	heatCell = cellPixels > 1.0 ? cellPixels : 1.0;
+}
+
+/**
+ * Sets how quickly the trails of the Boids fade from now on.
+ *
+ * @param decay	Factor the trails are faded by every frame drawn, e.g.
+ * 		0.95; 1 for trails that never fade, 0 for no trails.
+ */
+void TileRenderer::setTrails(float decay){
+	trailDecay = decay > 0.0 ? (decay < 1.0 ? decay : 1.0) : 0.0;
+	if(trailDecay == 0.0){
+		trail.clear();
+	}
+}
+
+/**
+ * Cuts a screen up into tiles.
+ *
+ * @param newWidth	Width of the screen.
+ * @param newHeight	Height of the screen.
+ */
+void TileRenderer::layout(int newWidth, int newHeight){
+	screenWidth = newWidth;
+	screenHeight = newHeight;
+	columns = (screenWidth + tileSize - 1)/tileSize;
+	rows = (screenHeight + tileSize - 1)/tileSize;
+	bins.assign(pool.size()*columns*rows, vector<Sprite>());
+}
+
+/**
+ * Sorts part of a population into the tiles their sprites overlap.
+ *
+ * @param pop	The population.
+ * @param first	First Boid to sort.
+ * @param last	One past the last Boid to sort.
+ * @param zoom	Zoom level to draw at.
+ * @param tints	Tint of each Boid, by identity.
+ * @param tiles	Lists of sprites to fill, one per tile.
+ */
+void TileRenderer::bin(const vector<Boid>& pop, unsigned int first, unsigned int last, unsigned int zoom, const vector<unsigned char>& tints, vector<Sprite>* tiles){
+	for(unsigned int tile = 0; tile < columns*rows; tile++){
+		tiles[tile].clear();
+	}
+
+	for(unsigned int i = first; i < last; i++){
+		Point coordinates = pop[i].getCoordinates();
+
+		/* Image should be _centered_ on the coordinates.
+		 */
+		unsigned int id = pop[i].getId();
+		unsigned int tint = id < tints.size() ? tints[id] : 0;
+		Sprite sprite;
+		sprite.frame = atlas.frameOf(atlas.headingOf(pop[i].getVelocity()), zoom, tint);
+		int width = atlas.getFrame(sprite.frame).w;
+		int height = atlas.getFrame(sprite.frame).h;
+		sprite.x = (int) floor(coordinates.x) - width/2;
+		sprite.y = (int) floor(coordinates.y) - height/2;
+
+		int left = sprite.x > 0 ? sprite.x : 0;
+		int top = sprite.y > 0 ? sprite.y : 0;
+		int right = sprite.x + width < screenWidth ? sprite.x + width : screenWidth;
+		int bottom = sprite.y + height < screenHeight ? sprite.y + height : screenHeight;
+		if(left >= right || top >= bottom){
+			continue;
+		}
+
+		for(int row = top/tileSize; row <= (bottom - 1)/tileSize; row++){
+			for(int column = left/tileSize; column <= (right - 1)/tileSize; column++){
+				tiles[row*columns + column].push_back(sprite);
+			}
+		}
+	}
+}
+
+/**
+ * Clears a tile, with the trails over it if there are any, and draws the
+ * sprites overlapping it.
+ *
+ * @param tile		The tile.
+ * @param pixels	Pixels of the screen.
+ * @param pitch		Pixels from one row of the screen to the next.
+ * @param background	Color to clear to.
+ */
+void TileRenderer::rasterize(unsigned int tile, Uint32* pixels, unsigned int pitch, Uint32 background){
+	int left = (tile % columns)*tileSize;
+	int top = (tile / columns)*tileSize;
+	int right = left + tileSize < screenWidth ? left + tileSize : screenWidth;
+	int bottom = top + tileSize < screenHeight ? top + tileSize : screenHeight;
+
+	bool trails = trailDecay > 0.0;
+	if(trails){
+		accumulate(tile, left, top, right, bottom);
+	}
+	for(int y = top; y < bottom; y++){
+		Uint32* row = pixels + y*pitch;
+		clearRow(row, left, right, y, background);
+		if(trails){
+			const float* intensity = &trail[(size_t) y*screenWidth];
+			for(int x = left; x < right; x++){
+				unsigned int level = (unsigned int) (intensity[x]*(TRAIL_LEVELS - 1));
+				if(level > 0){
+					row[x] = trailColors[level];
+				}
+			}
+		}
+	}
+
+	/* The lists of the workers hold consecutive parts of the population,
+	 * so going through them in turn draws the Boids in order.
+	 */
+	const Uint32* sheet = atlas.getPixels();
+	unsigned int sheetPitch = atlas.getPitch();
+	Uint32 colorKey = atlas.getColorKey();
+	unsigned int numTiles = columns*rows;
+	for(unsigned int w = 0; w < pool.size(); w++){
+		const vector<Sprite>& sprites = bins[w*numTiles + tile];
+		for(unsigned int s = 0; s < sprites.size(); s++){
+			const Sprite& sprite = sprites[s];
+			const SDL_Rect& frame = atlas.getFrame(sprite.frame);
+			int x0 = sprite.x > left ? sprite.x : left;
+			int y0 = sprite.y > top ? sprite.y : top;
+			int x1 = sprite.x + frame.w < right ? sprite.x + frame.w : right;
+			int y1 = sprite.y + frame.h < bottom ? sprite.y + frame.h : bottom;
+
+			for(int y = y0; y < y1; y++){
+				const Uint32* source = sheet + (frame.y + y - sprite.y)*sheetPitch + frame.x + (x0 - sprite.x);
+				Uint32* target = pixels + y*pitch;
+				for(int x = x0; x < x1; x++, source++){
+					if(*source != colorKey){
+						target[x] = *source;
+					}
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Fades the trails over a tile, and adds the Boids in it to them.
+ *
+ * @param tile		The tile.
+ * @param left, top	First pixel of the tile.
+ * @param right, bottom	One past the last pixel of the tile.
+ */
+void TileRenderer::accumulate(unsigned int tile, int left, int top, int right, int bottom){
+	float decay = trailDecay;
+	for(int y = top; y < bottom; y++){
+		float* intensity = &trail[(size_t) y*screenWidth];
+		for(int x = left; x < right; x++){
+			intensity[x] *= decay;
+		}
+	}
+
+	/* A sprite may overlap several tiles, but its middle (where the Boid
+	 * is) lies in just one of them.
+	 */
+	unsigned int numTiles = columns*rows;
+	for(unsigned int w = 0; w < pool.size(); w++){
+		const vector<Sprite>& sprites = bins[w*numTiles + tile];
+		for(unsigned int s = 0; s < sprites.size(); s++){
+			const SDL_Rect& frame = atlas.getFrame(sprites[s].frame);
+			int x = sprites[s].x + frame.w/2;
+			int y = sprites[s].y + frame.h/2;
+			if(x >= left && x < right && y >= top && y < bottom){
+				trail[(size_t) y*screenWidth + x] = 1.0;
+			}
+		}
+	}
+}
+
+/**
+ * Clears part of a row of pixels, to the heatmap if there is one.
+ *
+ * @param row		First pixel of the row.
+ * @param left		First pixel to clear.
+ * @param right		One past the last pixel to clear.
+ * @param y		Index of the row.
+ * @param background	Color to clear to without a heatmap.
+ */
+void TileRenderer::clearRow(Uint32* row, int left, int right, int y, Uint32 background) const{
+	if(heatColors.empty()){
+		fill(row + left, row + right, background);
+		return;
+	}
+
+	/* Cells past the edge of the heatmap are left cold.
+	 */
+	unsigned int cellRow = (unsigned int) (y/heatCell);
+	int x = left;
+	while(x < right){
+		unsigned int column = (unsigned int) (x/heatCell);
+		int end = (int) ceil((column + 1)*heatCell);
+		end = end > x ? (end < right ? end : right) : x + 1;
+		unsigned int cell = cellRow*heatColumns + column;
+		fill(row + x, row + end, column < heatColumns && cell < heatColors.size() ? heatColors[cell] : background);
+		x = end;
+	}
+}
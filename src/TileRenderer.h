@@ -0,0 +1,80 @@
+/**
+ * \file TileRenderer.h
+ *
+ * Draws a population on several threads at once, straight into the pixels
+ * of the screen. See implementation for more details.
+ *
+ * @since	2026-10-18
+ * @see		TileRenderer.cpp
+ */
+
+/* Idempotency.
+ */
+#ifndef TILE_RENDERER_H
+#define TILE_RENDERER_H
+
+/**
+ * Includes.
+ */
+#include <vector>
+#include <SDL/SDL.h>
+#include "WorkerPool.h"
+#include "SpriteAtlas.h"
+#include "Boid.h"
+
+/**
+ * Definitions.
+ */
+using namespace std;
+
+class TileRenderer {
+	public:
+		TileRenderer(const SpriteAtlas& sprites, WorkerPool& workers, unsigned int tilePixels);
+		~TileRenderer();
+
+		bool draw(SDL_Surface* screen, const vector<Boid>& pop, unsigned int zoom, const vector<unsigned char>& tints);
+		void setHeatmap(const vector<float>& cellHeat, unsigned int cellColumns, float cellPixels);
+		void setTrails(float decay);
+
+	protected:
+		/* A sprite to be drawn: where its upper left corner goes, and
+		 * which frame of the atlas to draw.
+		 */
+		struct Sprite {
+			int x;
+			int y;
+			unsigned int frame;
+		};
+
+		void layout(int width, int height);
+		void bin(const vector<Boid>& pop, unsigned int first, unsigned int last, unsigned int zoom, const vector<unsigned char>& tints, vector<Sprite>* tiles);
+		void rasterize(unsigned int tile, Uint32* pixels, unsigned int pitch, Uint32 background);
+		void clearRow(Uint32* row, int left, int right, int y, Uint32 background) const;
+		void accumulate(unsigned int tile, int left, int top, int right, int bottom);
+
+		/* Properties.
+		 */
+		const SpriteAtlas& atlas;
+		WorkerPool& pool;
+		int screenWidth;
+		int screenHeight;
+		int tileSize;			// Pixels along the side of a tile.
+		unsigned int columns;		// Of tiles on the screen.
+		unsigned int rows;
+		vector<vector<Sprite> > bins;	// Sprites per tile, by worker and then tile.
+		vector<float> heat;		// Heatmap under the Boids, 0 to 1 per cell, if any.
+		vector<Uint32> heatColors;	// The same, as colors of the screen.
+		unsigned int heatColumns;
+		float heatCell;			// Pixels along the side of a cell.
+		float trailDecay;		// Of the trails per frame drawn, 0 for none.
+		vector<float> trail;		// Trail intensity, 0 to 1 per pixel of the screen.
+		vector<Uint32> trailColors;	// Colors of the screen, by intensity level.
+
+	private:
+		TileRenderer(const TileRenderer&);
+		TileRenderer& operator=(const TileRenderer&);
+};
+
+/* End idempotency.
+ */
+#endif
@@ -0,0 +1,295 @@
+/**
+ * \file	TrajectoryArchive.cpp
+ *
+ * Compressed archives of recorded runs, for keeping long runs on disk.
+ *
+ * The frames are grouped into chunks (64 frames, say) that are compressed
+ * independently of each other, so any chunk can be decoded on its own and
+ * chunks can be compressed and decompressed in parallel. An index of the
+ * chunks at the end of the file gives random access to any frame.
+ *
+ * A chunk is compressed in three stages:
+ *
+ * 1. Quantization: positions and velocities are rounded to fixed steps
+ *    (1/64 px, say), which loses nothing that can be seen on screen.
+ * 2. Temporal delta: Boids move smoothly, so each value is replaced by how
+ *    far it is off from a linear extrapolation of the two frames before (or
+ *    the one frame before, or zero, at the start of the chunk). The values
+ *    are laid out field by field and frame by frame, and stored as
+ *    variable-length integers, so the mostly tiny residuals take a byte.
+ * 3. LZ77 (see LZCodec.cpp), which squeezes out runs and repeats.
+ *
+ * Decompression reverses the stages exactly, so that archiving an archive's
+ * frames again gives the same archive.
+ *
+ * @since	2026-10-18
+ */
+
+/**
+ * Includes.
+ */
+#include "TrajectoryArchive.h"
+#include "LZCodec.h"
+#include <stdexcept>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * Definitions.
+ */
+#define NUM_FIELDS 4	// x, y, vx and vy
+
+/**
+ * Quantized value of a field of a record.
+ *
+ * @param record	The record.
+ * @param field		Index of the field.
+ * @param header	Archive with the quantization steps.
+ * @return		The value, in steps.
+ */
+static int quantize(const TrajectoryRecord& record, unsigned int field, const ArchiveHeader& header){
+	const float* values = &record.x;
+	float step = field < 2 ? header.positionStep : header.velocityStep;
+
+	return (int) lrintf(values[field] / step);
+}
+
+/**
+ * Compresses a chunk of frames.
+ *
+ * @param frames	The frames, one after the other.
+ * @param numFrames	Number of frames.
+ * @param header	Archive the chunk belongs to.
+ * @param encoded	Scratch space.
+ * @param compressed	Cleared and filled with the compressed chunk.
+ */
+void encodeChunk(const TrajectoryRecord* frames, unsigned int numFrames, const ArchiveHeader& header, vector<unsigned char>& encoded, vector<unsigned char>& compressed){
+	unsigned int numBoids = header.numBoids;
+
+	encoded.clear();
+	for(unsigned int field = 0; field < NUM_FIELDS; field++){
+		for(unsigned int f = 0; f < numFrames; f++){
+			const TrajectoryRecord* frame = frames + (size_t) f*numBoids;
+			const TrajectoryRecord* previous = f >= 1 ? frame - numBoids : NULL;
+			const TrajectoryRecord* beforeThat = f >= 2 ? frame - 2*(size_t) numBoids : NULL;
+			for(unsigned int i = 0; i < numBoids; i++){
+				int value = quantize(frame[i], field, header);
+				int predicted = 0;
+				if(f >= 2){
+					predicted = 2*quantize(previous[i], field, header) - quantize(beforeThat[i], field, header);
+				}
+				else if(f == 1){
+					predicted = quantize(previous[i], field, header);
+				}
+
+				/* Zigzag the residual so that small negative
+				 * numbers are small too, seven bits per byte.
+				 */
+				int residual = value - predicted;
+				unsigned int zigzag = ((unsigned int) residual << 1) ^ (unsigned int) (residual >> 31);
+				while(zigzag >= 0x80){
+					encoded.push_back((zigzag & 0x7f) | 0x80);
+					zigzag >>= 7;
+				}
+				encoded.push_back(zigzag);
+			}
+		}
+	}
+
+	lzCompress(encoded.empty() ? NULL : &encoded[0], encoded.size(), compressed);
+}
+
+/**
+ * Decompresses a chunk of frames.
+ *
+ * @param compressed	The compressed chunk.
+ * @param chunk		Index entry of the chunk.
+ * @param header	Archive the chunk belongs to.
+ * @param encoded	Scratch space.
+ * @param frames	Resized to and filled with the frames, one after the
+ * 			other.
+ * @return		false if the chunk is corrupt.
+ */
+bool decodeChunk(const unsigned char* compressed, const ArchiveChunk& chunk, const ArchiveHeader& header, vector<unsigned char>& encoded, vector<TrajectoryRecord>& frames){
+	unsigned int numBoids = header.numBoids;
+	unsigned int numFrames = chunk.numFrames;
+	if(!lzDecompress(compressed, chunk.compressedBytes, chunk.rawBytes, encoded)){
+		return false;
+	}
+
+	/* Rebuild the quantized values first, since the prediction works on
+	 * those.
+	 */
+	vector<int> values((size_t) numFrames*numBoids);
+	frames.resize((size_t) numFrames*numBoids);
+	size_t at = 0;
+	for(unsigned int field = 0; field < NUM_FIELDS; field++){
+		float step = field < 2 ? header.positionStep : header.velocityStep;
+		for(unsigned int f = 0; f < numFrames; f++){
+			for(unsigned int i = 0; i < numBoids; i++){
+				unsigned int zigzag = 0;
+				unsigned int shift = 0;
+				unsigned char next;
+				do{
+					if(at >= encoded.size() || shift > 28){
+						return false;
+					}
+					next = encoded[at++];
+					zigzag |= (unsigned int) (next & 0x7f) << shift;
+					shift += 7;
+				}while(next & 0x80);
+
+				size_t k = (size_t) f*numBoids + i;
+				int residual = (int) (zigzag >> 1) ^ -(int) (zigzag & 1);
+				int predicted = 0;
+				if(f >= 2){
+					predicted = 2*values[k - numBoids] - values[k - 2*numBoids];
+				}
+				else if(f == 1){
+					predicted = values[k - numBoids];
+				}
+				values[k] = predicted + residual;
+				(&frames[k].x)[field] = values[k] * step;
+			}
+		}
+	}
+
+	return at == encoded.size();
+}
+
+/**
+ * Constructor from a file.
+ *
+ * @param path	Path of the archive.
+ * @return	A view of the archived chunks.
+ * @throws	std::runtime_error if the file can't be mapped or isn't a
+ * 		complete archive.
+ */
+TrajectoryArchive::TrajectoryArchive(const string& path){
+	int fd = open(path.c_str(), O_RDONLY);
+	if(fd < 0){
+		throw runtime_error("Unable to open archive " + path + "!");
+	}
+	struct stat info;
+	if(fstat(fd, &info) < 0 || (size_t) info.st_size < sizeof(ArchiveHeader) + sizeof(ArchiveFooter)){
+		close(fd);
+		throw runtime_error("Not a complete archive: " + path + "!");
+	}
+	mappedBytes = info.st_size;
+	mapping = mmap(NULL, mappedBytes, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if(mapping == MAP_FAILED){
+		throw runtime_error("Unable to map archive " + path + "!");
+	}
+
+	/* The index is found from the end, and must fit in between.
+	 */
+	header = (const ArchiveHeader*) mapping;
+	const ArchiveFooter* footer = (const ArchiveFooter*) ((const char*) mapping + mappedBytes - sizeof(ArchiveFooter));
+	bool valid = memcmp(header->magic, ARCHIVE_MAGIC, sizeof(header->magic)) == 0 && header->version == ARCHIVE_VERSION
+		&& memcmp(footer->magic, ARCHIVE_MAGIC, sizeof(footer->magic)) == 0
+		&& footer->indexOffset >= sizeof(ArchiveHeader)
+		&& footer->indexOffset + footer->numChunks*sizeof(ArchiveChunk) + sizeof(ArchiveFooter) == mappedBytes;
+	if(!valid){
+		munmap(mapping, mappedBytes);
+		throw runtime_error("Not a complete archive: " + path + "!");
+	}
+	index = (const ArchiveChunk*) ((const char*) mapping + footer->indexOffset);
+	numChunks = footer->numChunks;
+}
+
+/**
+ * Destructor. Unmaps the file.
+ */
+TrajectoryArchive::~TrajectoryArchive(){
+	munmap(mapping, mappedBytes);
+}
+
+/**
+ * Getter for the size of the archived population.
+ *
+ * @return	Number of records in each frame.
+ */
+unsigned int TrajectoryArchive::getNumBoids() const{
+	return header->numBoids;
+}
+
+/**
+ * Getter for the length of the archived run.
+ *
+ * @return	Number of frames in the archive.
+ */
+unsigned long TrajectoryArchive::getNumFrames() const{
+	return numChunks > 0 ? index[numChunks-1].firstFrame + index[numChunks-1].numFrames : 0;
+}
+
+/**
+ * Getter for the extent of the archived world.
+ *
+ * @return	X and Y coordinates of the maximum extent of the world.
+ */
+Point TrajectoryArchive::getEdges() const{
+	return Point(header->width, header->height);
+}
+
+/**
+ * Getter for the number of chunks.
+ *
+ * @return	Number of chunks in the archive.
+ */
+unsigned long TrajectoryArchive::getNumChunks() const{
+	return numChunks;
+}
+
+/**
+ * Looks up a chunk in the index.
+ *
+ * @param chunk	Index of the chunk; must be less than getNumChunks().
+ * @return	Its index entry.
+ */
+const ArchiveChunk& TrajectoryArchive::getChunk(unsigned long chunk) const{
+	return index[chunk];
+}
+
+/**
+ * Finds the chunk holding a frame.
+ *
+ * @param frame	Index of the frame; must be less than getNumFrames().
+ * @return	Index of the chunk.
+ */
+unsigned long TrajectoryArchive::chunkOf(unsigned long frame) const{
+	unsigned long low = 0, high = numChunks;
+	while(high - low > 1){
+		unsigned long middle = (low + high) / 2;
+		if(index[middle].firstFrame <= frame){
+			low = middle;
+		}
+		else{
+			high = middle;
+		}
+	}
+
+	return low;
+}
+
+/**
+ * Decompresses a chunk. Safe to call from several threads at once.
+ *
+ * @param chunk		Index of the chunk; must be less than
+ * 			getNumChunks().
+ * @param frames	Filled with the frames of the chunk, one after the
+ * 			other.
+ * @throws		std::runtime_error if the chunk is corrupt.
+ */
+void TrajectoryArchive::readChunk(unsigned long chunk, vector<TrajectoryRecord>& frames) const{
+	const ArchiveChunk& entry = index[chunk];
+	vector<unsigned char> encoded;
+	if(entry.offset + entry.compressedBytes > mappedBytes
+		|| !decodeChunk((const unsigned char*) mapping + entry.offset, entry, *header, encoded, frames)){
+		throw runtime_error("Corrupt chunk in archive!");
+	}
+}
@@ -0,0 +1,98 @@
+/**
+ * \file TrajectoryArchive.h
+ *
+ * Compressed, seekable archives of recorded runs. See implementation for
+ * more details.
+ *
+ * @since	2026-10-18
+ * @see		TrajectoryArchive.cpp
+ */
+
+/* Idempotency.
+ */
+#ifndef TRAJECTORY_ARCHIVE_H
+#define TRAJECTORY_ARCHIVE_H
+
+/**
+ * Includes.
+ */
+#include <vector>
+#include <string>
+#include "TrajectoryFile.h"
+
+/**
+ * Definitions.
+ */
+#define ARCHIVE_MAGIC "FLOCKARC"
+#define ARCHIVE_VERSION 1
+
+using namespace std;
+
+/**
+ * Start of an archive, followed by the chunks.
+ */
+struct ArchiveHeader {
+	char magic[8];
+	unsigned int version;
+	unsigned int numBoids;	// Records per frame.
+	float width;		// Extent of the world.
+	float height;
+	unsigned int chunkFrames;	// Frames per chunk; the last one may be shorter.
+	float positionStep;	// Quantization steps.
+	float velocityStep;
+};
+
+/**
+ * Entry of the chunk index.
+ */
+struct ArchiveChunk {
+	unsigned long long offset;	// From the start of the file.
+	unsigned long long firstFrame;
+	unsigned int numFrames;
+	unsigned int rawBytes;		// Encoded size before compression.
+	unsigned int compressedBytes;
+	unsigned int reserved;
+};
+
+/**
+ * End of an archive, after the chunk index.
+ */
+struct ArchiveFooter {
+	unsigned long long indexOffset;
+	unsigned long long numChunks;
+	char magic[8];
+};
+
+void encodeChunk(const TrajectoryRecord* frames, unsigned int numFrames, const ArchiveHeader& header, vector<unsigned char>& encoded, vector<unsigned char>& compressed);
+bool decodeChunk(const unsigned char* compressed, const ArchiveChunk& chunk, const ArchiveHeader& header, vector<unsigned char>& encoded, vector<TrajectoryRecord>& frames);
+
+class TrajectoryArchive {
+	public:
+		TrajectoryArchive(const string& path);
+		~TrajectoryArchive();
+
+		unsigned int getNumBoids() const;
+		unsigned long getNumFrames() const;
+		Point getEdges() const;
+		unsigned long getNumChunks() const;
+		const ArchiveChunk& getChunk(unsigned long chunk) const;
+		unsigned long chunkOf(unsigned long frame) const;
+		void readChunk(unsigned long chunk, vector<TrajectoryRecord>& frames) const;
+
+	protected:
+		/* Properties.
+		 */
+		void* mapping;
+		size_t mappedBytes;
+		const ArchiveHeader* header;
+		const ArchiveChunk* index;
+		unsigned long numChunks;
+
+	private:
+		TrajectoryArchive(const TrajectoryArchive&);
+		TrajectoryArchive& operator=(const TrajectoryArchive&);
+};
+
+/* End idempotency.
+ */
+#endif
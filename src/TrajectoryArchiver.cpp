@@ -0,0 +1,227 @@
+/**
+ * \file	TrajectoryArchiver.cpp
+ *
+ * Writes a run to a compressed archive (see TrajectoryArchive.cpp) while it
+ * is being simulated.
+ *
+ * Frames are collected into a chunk; a full chunk is handed to a small set
+ * of compressor threads and the simulation carries on. Chunks finish in any
+ * order, and whichever thread finishes the next chunk due writes it (and
+ * any that were waiting on it) to the file. The number of chunks in flight
+ * is bounded, so if compression can't keep up the simulation is held back
+ * rather than memory running out. The chunk index and footer are written
+ * on destruction, so an archive is only readable once the archiver is gone.
+ *
+ * @since	2026-10-18
+ */
+
+/**
+ * Includes.
+ */
+#include "TrajectoryArchiver.h"
+#include <stdexcept>
+#include <string.h>
+
+/**
+ * Definitions.
+ */
+#define POSITION_STEP (1.0/64.0)	// px
+#define VELOCITY_STEP (1.0/1024.0)	// px/frame
+
+/**
+ * Constructor from values. Creates the file and starts the compressors.
+ *
+ * @param path		Path of the archive; overwritten.
+ * @param numBoids	Size of the population.
+ * @param edgeOfWorld	X and Y coordinates of the maximum extent of the
+ * 			simulated space.
+ * @param chunkFrames	Frames per chunk.
+ * @param numThreads	Number of compressor threads.
+ * @return		An archiver that has archived no frames.
+ * @throws		std::runtime_error if the file can't be written.
+ */
+TrajectoryArchiver::TrajectoryArchiver(const string& path, unsigned int numBoids, Point edgeOfWorld, unsigned int chunkFrames, unsigned int numThreads) : out(path.c_str(), ios::binary | ios::trunc){
+	if(!out){
+		throw runtime_error("Unable to write archive " + path + "!");
+	}
+
+	memset(&header, 0, sizeof(ArchiveHeader));
+	memcpy(header.magic, ARCHIVE_MAGIC, sizeof(header.magic));
+	header.version = ARCHIVE_VERSION;
+	header.numBoids = numBoids;
+	header.width = edgeOfWorld.x;
+	header.height = edgeOfWorld.y;
+	header.chunkFrames = chunkFrames > 0 ? chunkFrames : 1;
+	header.positionStep = POSITION_STEP;
+	header.velocityStep = VELOCITY_STEP;
+	out.write((const char*) &header, sizeof(ArchiveHeader));
+
+	currentFrames = 0;
+	frames = 0;
+	offset = sizeof(ArchiveHeader);
+	submitted = 0;
+	stopping = false;
+	numThreads = numThreads > 0 ? numThreads : 1;
+	for(unsigned int t = 0; t < numThreads; t++){
+		compressors.push_back(thread(&TrajectoryArchiver::compress, this));
+	}
+}
+
+/**
+ * Destructor. Writes out the last chunk, the index and the footer, and
+ * closes the file.
+ */
+TrajectoryArchiver::~TrajectoryArchiver(){
+	submit();
+	{
+		unique_lock<mutex> guard(lock);
+		stopping = true;
+	}
+	work.notify_all();
+	for(unsigned int t = 0; t < compressors.size(); t++){
+		compressors[t].join();
+	}
+
+	/* Pad so that the index can be read in place from a mapping.
+	 */
+	const char padding[sizeof(unsigned long long)] = {0};
+	unsigned int numPadding = (sizeof(padding) - offset % sizeof(padding)) % sizeof(padding);
+	out.write(padding, numPadding);
+	offset += numPadding;
+
+	ArchiveFooter footer;
+	memset(&footer, 0, sizeof(ArchiveFooter));
+	footer.indexOffset = offset;
+	footer.numChunks = index.size();
+	memcpy(footer.magic, ARCHIVE_MAGIC, sizeof(footer.magic));
+	if(!index.empty()){
+		out.write((const char*) &index[0], index.size()*sizeof(ArchiveChunk));
+	}
+	out.write((const char*) &footer, sizeof(ArchiveFooter));
+}
+
+/**
+ * Appends a frame.
+ *
+ * @param pop	The population, in any order.
+ */
+void TrajectoryArchiver::record(const vector<Boid>& pop){
+	size_t start = current.size();
+	current.resize(start + header.numBoids);
+	for(unsigned int i = 0; i < pop.size(); i++){
+		unsigned int id = pop[i].getId();
+		if(id < header.numBoids){
+			Point coords = pop[i].getCoordinates();
+			Vector velocity = pop[i].getVelocity();
+			TrajectoryRecord record = {(float) coords.x, (float) coords.y, (float) velocity.x, (float) velocity.y};
+			current[start + id] = record;
+		}
+	}
+	frameAdded();
+}
+
+/**
+ * Appends a frame that is already laid out by identity.
+ *
+ * @param frame	The records of the frame.
+ */
+void TrajectoryArchiver::recordFrame(const TrajectoryRecord* frame){
+	current.insert(current.end(), frame, frame + header.numBoids);
+	frameAdded();
+}
+
+/**
+ * Counts a frame that has been added to the chunk being filled, and hands
+ * the chunk on once it is full.
+ */
+void TrajectoryArchiver::frameAdded(){
+	currentFrames++;
+	frames++;
+	if(currentFrames == header.chunkFrames){
+		submit();
+	}
+}
+
+/**
+ * Getter for the length of the archive.
+ *
+ * @return	Number of frames archived so far.
+ */
+unsigned long TrajectoryArchiver::getNumFrames() const{
+	return frames;
+}
+
+/**
+ * Getter for the size of the archive.
+ *
+ * @return	Bytes written to the file so far.
+ */
+unsigned long long TrajectoryArchiver::getCompressedBytes() const{
+	unique_lock<mutex> guard(lock);
+	return offset;
+}
+
+/**
+ * Hands the chunk being filled to the compressors, waiting for room if
+ * they have fallen behind.
+ */
+void TrajectoryArchiver::submit(){
+	if(currentFrames == 0){
+		return;
+	}
+
+	PendingChunk* chunk = new PendingChunk;
+	memset(&chunk->entry, 0, sizeof(ArchiveChunk));
+	chunk->number = submitted++;
+	chunk->entry.firstFrame = frames - currentFrames;
+	chunk->entry.numFrames = currentFrames;
+	chunk->frames.swap(current);
+	currentFrames = 0;
+
+	unique_lock<mutex> guard(lock);
+	while(queue.size() >= 2*compressors.size()){
+		room.wait(guard);
+	}
+	queue.push_back(chunk);
+	work.notify_one();
+}
+
+/**
+ * Main loop of a compressor thread.
+ */
+void TrajectoryArchiver::compress(){
+	vector<unsigned char> encoded;
+	unique_lock<mutex> guard(lock);
+	while(true){
+		while(queue.empty() && !stopping){
+			work.wait(guard);
+		}
+		if(queue.empty()){
+			return;
+		}
+
+		PendingChunk* chunk = queue.front();
+		queue.pop_front();
+		room.notify_one();
+		guard.unlock();
+
+		encodeChunk(chunk->frames.empty() ? NULL : &chunk->frames[0], chunk->entry.numFrames, header, encoded, chunk->compressed);
+		chunk->entry.rawBytes = encoded.size();
+		chunk->entry.compressedBytes = chunk->compressed.size();
+		chunk->frames.clear();
+
+		/* Write out whatever is next in line.
+		 */
+		guard.lock();
+		done[chunk->number] = chunk;
+		while(!done.empty() && done.begin()->first == index.size()){
+			PendingChunk* next = done.begin()->second;
+			done.erase(done.begin());
+			next->entry.offset = offset;
+			out.write((const char*) (next->compressed.empty() ? NULL : &next->compressed[0]), next->compressed.size());
+			offset += next->compressed.size();
+			index.push_back(next->entry);
+			delete next;
+		}
+	}
+}
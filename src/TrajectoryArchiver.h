@@ -0,0 +1,84 @@
+/**
+ * \file TrajectoryArchiver.h
+ *
+ * Writes a run to a compressed archive as it happens. See implementation for
+ * more details.
+ *
+ * @since	2026-10-18
+ * @see		TrajectoryArchiver.cpp
+ */
+
+/* Idempotency.
+ */
+#ifndef TRAJECTORY_ARCHIVER_H
+#define TRAJECTORY_ARCHIVER_H
+
+/**
+ * Includes.
+ */
+#include <vector>
+#include <string>
+#include <deque>
+#include <map>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "TrajectoryArchive.h"
+
+/**
+ * Definitions.
+ */
+using namespace std;
+
+class TrajectoryArchiver {
+	public:
+		TrajectoryArchiver(const string& path, unsigned int numBoids, Point edgeOfWorld, unsigned int chunkFrames, unsigned int numThreads);
+		~TrajectoryArchiver();
+
+		void record(const vector<Boid>& pop);
+		void recordFrame(const TrajectoryRecord* frame);
+		unsigned long getNumFrames() const;
+		unsigned long long getCompressedBytes() const;
+
+	protected:
+		/**
+		 * A chunk on its way to the file.
+		 */
+		struct PendingChunk {
+			unsigned long number;	// Position in the archive.
+			ArchiveChunk entry;
+			vector<TrajectoryRecord> frames;
+			vector<unsigned char> compressed;
+		};
+
+		void frameAdded();
+		void submit();
+		void compress();
+
+		/* Properties.
+		 */
+		ofstream out;
+		ArchiveHeader header;
+		vector<TrajectoryRecord> current;	// Frames of the chunk being filled.
+		unsigned int currentFrames;
+		unsigned long frames;
+		vector<ArchiveChunk> index;
+		unsigned long long offset;		// Where the next chunk goes.
+		unsigned long submitted;		// Chunks handed to the compressors.
+		deque<PendingChunk*> queue;		// Chunks waiting to be compressed, in order.
+		map<unsigned long, PendingChunk*> done;	// Compressed chunks waiting for their turn, by number.
+		vector<thread> compressors;
+		mutable mutex lock;
+		condition_variable work;		// Something to compress, or time to stop.
+		condition_variable room;		// Space in the queue.
+		bool stopping;
+
+	private:
+		TrajectoryArchiver(const TrajectoryArchiver&);
+		TrajectoryArchiver& operator=(const TrajectoryArchiver&);
+};
+
+/* End idempotency.
+ */
+#endif
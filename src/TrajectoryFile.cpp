@@ -0,0 +1,113 @@
+/**
+ * \file	TrajectoryFile.cpp
+ *
+ * Read access to a recorded run (see TrajectoryRecorder.cpp).
+ *
+ * The file is a header followed by fixed-size frames, so any frame can be
+ * found without reading the ones before it. It is memory-mapped read-only
+ * rather than read in: the pages of a frame are only loaded when the frame
+ * is looked at, and can be dropped again by the kernel, so files much larger
+ * than memory can be worked through. Several threads may read frames at
+ * the same time.
+ *
+ * A trailing partial frame (from a recording still in progress) is ignored.
+ *
+ * @since	2026-10-18
+ */
+
+/**
+ * Includes.
+ */
+#include "TrajectoryFile.h"
+#include <stdexcept>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * Constructor from a file.
+ *
+ * @param path	Path of the trajectory file.
+ * @return	A view of the recorded frames.
+ * @throws	std::runtime_error if the file can't be mapped or isn't a
+ * 		trajectory file.
+ */
+TrajectoryFile::TrajectoryFile(const string& path){
+	int fd = open(path.c_str(), O_RDONLY);
+	if(fd < 0){
+		throw runtime_error("Unable to open trajectory file " + path + "!");
+	}
+	struct stat info;
+	if(fstat(fd, &info) < 0 || (size_t) info.st_size < sizeof(TrajectoryHeader)){
+		close(fd);
+		throw runtime_error("Not a trajectory file: " + path + "!");
+	}
+	mappedBytes = info.st_size;
+	mapping = mmap(NULL, mappedBytes, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if(mapping == MAP_FAILED){
+		throw runtime_error("Unable to map trajectory file " + path + "!");
+	}
+
+	header = (const TrajectoryHeader*) mapping;
+	if(memcmp(header->magic, TRAJECTORY_MAGIC, sizeof(header->magic)) != 0 || header->version != TRAJECTORY_VERSION){
+		munmap(mapping, mappedBytes);
+		throw runtime_error("Not a trajectory file: " + path + "!");
+	}
+	numFrames = getFrameBytes() > 0 ? (mappedBytes - sizeof(TrajectoryHeader)) / getFrameBytes() : 0;
+}
+
+/**
+ * Destructor. Unmaps the file.
+ */
+TrajectoryFile::~TrajectoryFile(){
+	munmap(mapping, mappedBytes);
+}
+
+/**
+ * Getter for the size of the recorded population.
+ *
+ * @return	Number of records in each frame.
+ */
+unsigned int TrajectoryFile::getNumBoids() const{
+	return header->numBoids;
+}
+
+/**
+ * Getter for the length of the recording.
+ *
+ * @return	Number of complete frames in the file.
+ */
+unsigned long TrajectoryFile::getNumFrames() const{
+	return numFrames;
+}
+
+/**
+ * Getter for the extent of the recorded world.
+ *
+ * @return	X and Y coordinates of the maximum extent of the world.
+ */
+Point TrajectoryFile::getEdges() const{
+	return Point(header->width, header->height);
+}
+
+/**
+ * Looks up a frame.
+ *
+ * @param frame	Index of the frame; must be less than getNumFrames().
+ * @return	The records of the frame, indexed by Boid identity.
+ */
+const TrajectoryRecord* TrajectoryFile::getFrame(unsigned long frame) const{
+	return (const TrajectoryRecord*) ((const char*) mapping + sizeof(TrajectoryHeader) + frame*getFrameBytes());
+}
+
+/**
+ * Getter for the size of a frame.
+ *
+ * @return	Size of a frame, in bytes.
+ */
+size_t TrajectoryFile::getFrameBytes() const{
+	return header->numBoids*sizeof(TrajectoryRecord);
+}
@@ -0,0 +1,79 @@
+/**
+ * \file TrajectoryFile.h
+ *
+ * Recorded runs of a population on disk. See implementation for more
+ * details.
+ *
+ * @since	2026-10-18
+ * @see		TrajectoryFile.cpp
+ */
+
+/* Idempotency.
+ */
+#ifndef TRAJECTORY_FILE_H
+#define TRAJECTORY_FILE_H
+
+/**
+ * Includes.
+ */
+#include <string>
+#include <stddef.h>
+#include "Boid.h"
+
+/**
+ * Definitions.
+ */
+#define TRAJECTORY_MAGIC "FLOCKTRJ"
+#define TRAJECTORY_VERSION 1
+
+using namespace std;
+
+/**
+ * Start of a trajectory file, followed by one frame after the other.
+ */
+struct TrajectoryHeader {
+	char magic[8];
+	unsigned int version;
+	unsigned int numBoids;	// Records per frame.
+	float width;		// Extent of the world.
+	float height;
+};
+
+/**
+ * A Boid in a recorded frame. Each frame holds numBoids of these, indexed by
+ * the identity of the Boid.
+ */
+struct TrajectoryRecord {
+	float x;
+	float y;
+	float vx;
+	float vy;
+};
+
+class TrajectoryFile {
+	public:
+		TrajectoryFile(const string& path);
+		~TrajectoryFile();
+
+		unsigned int getNumBoids() const;
+		unsigned long getNumFrames() const;
+		Point getEdges() const;
+		const TrajectoryRecord* getFrame(unsigned long frame) const;
+		size_t getFrameBytes() const;
+
+	protected:
+		/* Properties.
+		 */
+		void* mapping;
+		size_t mappedBytes;
+		const TrajectoryHeader* header;
+		unsigned long numFrames;
+
+	private:
+		TrajectoryFile(const TrajectoryFile&);
+		TrajectoryFile& operator=(const TrajectoryFile&);
+};
+
+/* End idempotency.
+ */
+#endif
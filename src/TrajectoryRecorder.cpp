@@ -0,0 +1,97 @@
+/**
+ * \file	TrajectoryRecorder.cpp
+ *
+ * Records the frames of a run to a trajectory file (see TrajectoryFile.h for
+ * the layout).
+ *
+ * Every frame lists the whole population in the order of the Boids'
+ * identities, no matter in which order the simulation hands them over, so
+ * that a Boid can be followed from frame to frame. Boids with an identity
+ * outside of the recorded population are left out.
+ *
+ * @since	2026-10-18
+ */
+
+/**
+ * Includes.
+ */
+#include "TrajectoryRecorder.h"
+#include <stdexcept>
+#include <string.h>
+
+/**
+ * Constructor from values. Creates the file and writes its header.
+ *
+ * @param path		Path of the trajectory file; overwritten.
+ * @param numBoids	Size of the population.
+ * @param edgeOfWorld	X and Y coordinates of the maximum extent of the
+ * 			simulated space.
+ * @return		A recorder that has recorded no frames.
+ * @throws		std::runtime_error if the file can't be written.
+ */
+TrajectoryRecorder::TrajectoryRecorder(const string& path, unsigned int numBoids, Point edgeOfWorld) : out(path.c_str(), ios::binary | ios::trunc){
+	if(!out){
+		throw runtime_error("Unable to write trajectory file " + path + "!");
+	}
+
+	TrajectoryHeader header;
+	memset(&header, 0, sizeof(TrajectoryHeader));
+	memcpy(header.magic, TRAJECTORY_MAGIC, sizeof(header.magic));
+	header.version = TRAJECTORY_VERSION;
+	header.numBoids = numBoids;
+	header.width = edgeOfWorld.x;
+	header.height = edgeOfWorld.y;
+	out.write((const char*) &header, sizeof(TrajectoryHeader));
+
+	frame.resize(numBoids);
+	frames = 0;
+}
+
+/**
+ * Destructor. Flushes and closes the file.
+ */
+TrajectoryRecorder::~TrajectoryRecorder(){
+}
+
+/**
+ * Appends a frame.
+ *
+ * @param pop	The population, in any order.
+ */
+void TrajectoryRecorder::record(const vector<Boid>& pop){
+	frames++;
+	if(frame.empty()){
+		return;
+	}
+
+	memset(&frame[0], 0, frame.size()*sizeof(TrajectoryRecord));
+	for(unsigned int i = 0; i < pop.size(); i++){
+		unsigned int id = pop[i].getId();
+		if(id < frame.size()){
+			Point coords = pop[i].getCoordinates();
+			Vector velocity = pop[i].getVelocity();
+			TrajectoryRecord record = {(float) coords.x, (float) coords.y, (float) velocity.x, (float) velocity.y};
+			frame[id] = record;
+		}
+	}
+	out.write((const char*) &frame[0], frame.size()*sizeof(TrajectoryRecord));
+}
+
+/**
+ * Appends a frame that is already laid out by identity.
+ *
+ * @param records	The records of the frame.
+ */
+void TrajectoryRecorder::recordFrame(const TrajectoryRecord* records){
+	out.write((const char*) records, frame.size()*sizeof(TrajectoryRecord));
+	frames++;
+}
+
+/**
+ * Getter for the length of the recording.
+ *
+ * @return	Number of frames recorded so far.
+ */
+unsigned long TrajectoryRecorder::getNumFrames() const{
+	return frames;
+}
@@ -0,0 +1,52 @@
+/**
+ * \file TrajectoryRecorder.h
+ *
+ * Records a run of a population to disk. See implementation for more
+ * details.
+ *
+ * @since	2026-10-18
+ * @see		TrajectoryRecorder.cpp
+ */
+
+/* Idempotency.
+ */
+#ifndef TRAJECTORY_RECORDER_H
+#define TRAJECTORY_RECORDER_H
+
+/**
+ * Includes.
+ */
+#include <vector>
+#include <string>
+#include <fstream>
+#include "TrajectoryFile.h"
+
+/**
+ * Definitions.
+ */
+using namespace std;
+
+class TrajectoryRecorder {
+	public:
+		TrajectoryRecorder(const string& path, unsigned int numBoids, Point edgeOfWorld);
+		~TrajectoryRecorder();
+
+		void record(const vector<Boid>& pop);
+		void recordFrame(const TrajectoryRecord* records);
+		unsigned long getNumFrames() const;
+
+	protected:
+		/* Properties.
+		 */
+		ofstream out;
+		vector<TrajectoryRecord> frame;
+		unsigned long frames;
+
+	private:
+		TrajectoryRecorder(const TrajectoryRecorder&);
+		TrajectoryRecorder& operator=(const TrajectoryRecorder&);
+};
+
+/* End idempotency.
+ */
+#endif
@@ -0,0 +1,214 @@
+/**
+ * \file	WorkerPool.cpp
+ *
+ * Pool of persistent worker threads, each pinned to its own CPU core.
+ *
+ * On hosts with more than one NUMA node (e.g. dual-socket servers), memory
+ * is physically allocated on the node of the thread that first touches it.
+ * Pinning the workers keeps them on the node where the data they allocated
+ * lives, so that a worker which builds its own part of the population keeps
+ * reading it from local memory. Workers are spread over the cores node by
+ * node, so consecutive workers (which get neighboring parts of the world)
+ * share a node wherever possible.
+ *
+ * The topology is read from sysfs; without it, all cores are assumed to
+ * belong to node 0.
+ *
+ * @since	2026-10-18
+ */
+
+/**
+ * Includes.
+ */
+#include "WorkerPool.h"
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <pthread.h>
+#include <sched.h>
+
+/**
+ * Definitions.
+ */
+#define MAX_NODES 64
+
+/**
+ * Parses a sysfs CPU list such as "0-3,8-11".
+ *
+ * @param list	The CPU list.
+ * @param cpus	CPU numbers found are appended here.
+ */
+static void parseCpuList(const string& list, vector<int>& cpus){
+	stringstream ranges(list);
+	string range;
+	while(getline(ranges, range, ',')){
+		int first, last;
+		char dash;
+		stringstream bounds(range);
+		if(!(bounds >> first)){
+			continue;
+		}
+		last = (bounds >> dash >> last) ? last : first;
+		for(int cpu = first; cpu <= last; cpu++){
+			cpus.push_back(cpu);
+		}
+	}
+}
+
+/**
+ * Lists the CPU cores of the host, grouped by NUMA node.
+ *
+ * @param cpus	Filled with CPU numbers, node by node.
+ * @param nodes	Filled with the NUMA node of each of those CPUs.
+ */
+static void cpuTopology(vector<int>& cpus, vector<int>& nodes){
+	for(int node = 0; node < MAX_NODES; node++){
+		ifstream file(("/sys/devices/system/node/node" + to_string(node) + "/cpulist").c_str());
+		string list;
+		if(!file || !getline(file, list)){
+			continue;
+		}
+		parseCpuList(list, cpus);
+		nodes.resize(cpus.size(), node);
+	}
+
+	/* No NUMA information available; assume one node.
+	 */
+	if(cpus.empty()){
+		unsigned int numCpus = thread::hardware_concurrency();
+		for(unsigned int cpu = 0; cpu < (numCpus > 0 ? numCpus : 1); cpu++){
+			cpus.push_back(cpu);
+			nodes.push_back(0);
+		}
+	}
+}
+
+/**
+ * Constructor from values.
+ *
+ * Starts the workers and pins each of them to a core.
+ *
+ * @param numWorkers	Number of worker threads (at least 1).
+ * @return		A pool of idle workers.
+ */
+WorkerPool::WorkerPool(unsigned int numWorkers){
+	task = NULL;
+	generation = 0;
+	pending = 0;
+	quitting = false;
+
+	vector<int> hostCpus, hostNodes;
+	cpuTopology(hostCpus, hostNodes);
+
+	/* Hand out the cores in contiguous blocks, so that neighboring
+	 * workers end up on the same node.
+	 */
+	numWorkers = numWorkers > 0 ? numWorkers : 1;
+	for(unsigned int w = 0; w < numWorkers; w++){
+		unsigned int slot = (w*hostCpus.size()/numWorkers) % hostCpus.size();
+		cpus.push_back(hostCpus[slot]);
+		nodes.push_back(hostNodes[slot]);
+	}
+
+	for(unsigned int w = 0; w < numWorkers; w++){
+		threads.push_back(thread(&WorkerPool::workerLoop, this, w));
+
+		cpu_set_t cpuSet;
+		CPU_ZERO(&cpuSet);
+		CPU_SET(cpus[w], &cpuSet);
+		pthread_setaffinity_np(threads[w].native_handle(), sizeof(cpu_set_t), &cpuSet);
+	}
+}
+
+/**
+ * Destructor. Waits for the workers to finish.
+ */
+WorkerPool::~WorkerPool(){
+	{
+		unique_lock<mutex> guard(lock);
+		quitting = true;
+	}
+	wake.notify_all();
+
+	for(unsigned int w = 0; w < threads.size(); w++){
+		threads[w].join();
+	}
+}
+
+/**
+ * Runs a task on every worker, and waits until all of them are done.
+ *
+ * The task is called once per worker with the index of that worker, and
+ * must not throw.
+ *
+ * @param work	The task to run.
+ */
+void WorkerPool::run(const function<void(unsigned int)>& work){
+	unique_lock<mutex> guard(lock);
+	task = &work;
+	pending = threads.size();
+	generation++;
+	wake.notify_all();
+
+	done.wait(guard, [this]{ return pending == 0; });
+	task = NULL;
+}
+
+/**
+ * Getter for the number of workers.
+ *
+ * @return	The number of worker threads.
+ */
+unsigned int WorkerPool::size() const{
+	return threads.size();
+}
+
+/**
+ * Getter for the core a worker is pinned to.
+ *
+ * @param worker	Index of the worker.
+ * @return		The CPU number.
+ */
+int WorkerPool::getCpu(unsigned int worker) const{
+	return cpus[worker];
+}
+
+/**
+ * Getter for the NUMA node a worker runs on.
+ *
+ * @param worker	Index of the worker.
+ * @return		The node number.
+ */
+int WorkerPool::getNode(unsigned int worker) const{
+	return nodes[worker];
+}
+
+/**
+ * Main loop of a worker: wait for a task, run it, report back.
+ *
+ * @param worker	Index of the worker.
+ */
+void WorkerPool::workerLoop(unsigned int worker){
+	unsigned long seen = 0;
+	while(true){
+		const function<void(unsigned int)>* work;
+		{
+			unique_lock<mutex> guard(lock);
+			wake.wait(guard, [this, seen]{ return quitting || generation != seen; });
+			if(quitting){
+				return;
+			}
+			seen = generation;
+			work = task;
+		}
+
+		(*work)(worker);
+
+		{
+			unique_lock<mutex> guard(lock);
+			if(--pending == 0){
+				done.notify_one();
+			}
+		}
+	}
+}
@@ -0,0 +1,59 @@
+/**
+ * \file WorkerPool.h
+ *
+ * Pool of worker threads pinned to CPU cores. See implementation for more
+ * details.
+ *
+ * @since	2026-10-18
+ * @see		WorkerPool.cpp
+ */
+
+/* Idempotency.
+ */
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+/**
+ * Includes.
+ */
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+/**
+ * Definitions.
+ */
+using namespace std;
+
+class WorkerPool {
+	public:
+		WorkerPool(unsigned int numWorkers);
+		~WorkerPool();
+
+		void run(const function<void(unsigned int)>& task);
+		unsigned int size() const;
+		int getCpu(unsigned int worker) const;
+		int getNode(unsigned int worker) const;
+
+	protected:
+		void workerLoop(unsigned int worker);
+
+		/* Properties.
+		 */
+		vector<thread> threads;
+		vector<int> cpus;
+		vector<int> nodes;
+		mutex lock;
+		condition_variable wake;
+		condition_variable done;
+		const function<void(unsigned int)>* task;
+		unsigned long generation;
+		unsigned int pending;
+		bool quitting;
+};
+
+/* End idempotency.
+ */
+#endif
@@ -0,0 +1,386 @@
+/**
+ * \file analyze.cpp
+ *
+ * Driver program for offline analysis of recorded runs (see
+ * TrajectoryRecorder.cpp). Works through the frames of a trajectory file in
+ * parallel and writes summary tables:
+ *
+ * - prefix-speeds.tsv: distribution of Boid speeds.
+ * - prefix-observables.tsv: order parameters over time, in the same format
+ *   as the simulation's --observables option. Only neighbors within the
+ *   cluster radius count towards the nearest neighbor distance.
+ * - prefix-displacements.tsv: net displacement and path length of each Boid.
+ * - prefix-lifetimes.tsv: distribution of cluster lifetimes.
+ *
+ * The file is memory-mapped, and each worker thread takes a contiguous range
+ * of frames, so nothing but the frames being looked at is ever in memory.
+ * Results that span the ranges (path lengths, cluster lifetimes) are kept
+ * per worker and stitched together in order at the end.
+ *
+ * A cluster is a set of Boids linked by chains of Boids within the cluster
+ * radius of each other, and is known by its lowest Boid identity. It lives
+ * for as long as consecutive analyzed frames have a cluster by that name.
+ * Clusters alive at the start or end of the analyzed frames are cut short.
+ *
+ * @since	2026-10-18
+ */
+
+/**
+ * Definitions.
+ */
+#define SPEED_BINS 40
+#define SPEED_BIN_WIDTH 0.25	// px/frame
+#define LIFETIME_BINS 40	// Bins of doubling width
+
+/**
+ * Includes.
+ */
+#include <iostream>
+#include <fstream>
+#include <stdexcept>
+#include <chrono>
+#include <thread>
+#include <stdlib.h>
+#include <math.h>
+#include "WorkerPool.h"
+#include "TrajectoryFile.h"
+#include "SpatialGrid.h"
+#include "Observables.h"
+
+using namespace std;
+
+/**
+ * What a worker finds out about its range of frames.
+ */
+struct RangeResults {
+	unsigned long first;			// Range of analyzed frames, by sample number.
+	unsigned long last;
+	vector<unsigned long> speedCounts;	// Boids per speed bin.
+	vector<double> pathLengths;		// Distance travelled by each Boid.
+	vector<unsigned long> lifetimeCounts;	// Clusters that lived inside the range, by doubling bin.
+	vector<unsigned long> runs;		// Frames each cluster has been alive so far.
+	vector<unsigned long> headRuns;		// Frames each cluster was alive from the start of the range.
+	vector<bool> fromStart;			// Whether the current run began at the start of the range.
+	vector<bool> whole;			// Whether the cluster was alive throughout the range.
+};
+
+/**
+ * Finds the root of a Boid in a union-find forest, halving the path to it.
+ *
+ * @param parents	The forest.
+ * @param boid		The Boid.
+ * @return		Index of the root.
+ */
+unsigned int findRoot(vector<unsigned int>& parents, unsigned int boid){
+	while(parents[boid] != boid){
+		parents[boid] = parents[parents[boid]];
+		boid = parents[boid];
+	}
+
+	return boid;
+}
+
+/**
+ * Bin of doubling width a lifetime falls into: 1, 2-3, 4-7, ...
+ *
+ * @param lifetime	The lifetime, at least 1.
+ * @return		Index of the bin.
+ */
+unsigned int lifetimeBin(unsigned long lifetime){
+	unsigned int bin = 0;
+	while(lifetime > 1 && bin+1 < LIFETIME_BINS){
+		lifetime /= 2;
+		bin++;
+	}
+
+	return bin;
+}
+
+/**
+ * Analyzes a contiguous range of frames.
+ *
+ * @param file		The recording.
+ * @param firstFrame	First recorded frame analyzed (sample 0).
+ * @param every		Recorded frames between analyzed ones.
+ * @param numSamples	Number of analyzed frames in the whole run.
+ * @param radius	Link radius of clusters.
+ * @param results	Range to analyze; filled with the results.
+ * @param observables	Filled with the order parameters of the range, by
+ * 			sample number.
+ */
+void analyzeRange(const TrajectoryFile& file, unsigned long firstFrame, unsigned long every, unsigned long numSamples, float radius, RangeResults& results, vector<Observables>& observables){
+	unsigned int numBoids = file.getNumBoids();
+	Point edges = file.getEdges();
+	SpatialGrid grid(edges, radius);
+	vector<Boid> boids;
+	vector<unsigned int> parents(numBoids);
+	vector<float> nearest(numBoids);
+	vector<bool> alive(numBoids);
+
+	results.speedCounts.assign(SPEED_BINS, 0);
+	results.pathLengths.assign(numBoids, 0.0);
+	results.lifetimeCounts.assign(LIFETIME_BINS, 0);
+	results.runs.assign(numBoids, 0);
+	results.headRuns.assign(numBoids, 0);
+	results.fromStart.assign(numBoids, true);
+	results.whole.assign(numBoids, false);
+
+	for(unsigned long s = results.first; s < results.last; s++){
+		const TrajectoryRecord* records = file.getFrame(firstFrame + s*every);
+		boids.clear();
+		for(unsigned int i = 0; i < numBoids; i++){
+			boids.push_back(Boid(Point(records[i].x, records[i].y), Vector(records[i].vx, records[i].vy), 0.0, 0.0, 0.0, 0.0, edges, i));
+		}
+
+		/* Speeds, and the way to the next analyzed frame (which may
+		 * belong to the next range).
+		 */
+		for(unsigned int i = 0; i < numBoids; i++){
+			float speed = sqrt(records[i].vx*records[i].vx + records[i].vy*records[i].vy);
+			unsigned int bin = (unsigned int) (speed / SPEED_BIN_WIDTH);
+			results.speedCounts[bin < SPEED_BINS ? bin : SPEED_BINS-1]++;
+		}
+		if(s+1 < numSamples){
+			const TrajectoryRecord* next = file.getFrame(firstFrame + (s+1)*every);
+			for(unsigned int i = 0; i < numBoids; i++){
+				float dx = next[i].x - records[i].x, dy = next[i].y - records[i].y;
+				results.pathLengths[i] += sqrt(dx*dx + dy*dy);
+			}
+		}
+
+		/* Nearest neighbors and clusters from the pairs in reach.
+		 */
+		grid.build(boids);
+		for(unsigned int i = 0; i < numBoids; i++){
+			parents[i] = i;
+			nearest[i] = -1.0;
+		}
+		auto link = [&](unsigned int i, unsigned int j, float distSquared){
+			nearest[i] = nearest[i] < 0.0 || distSquared < nearest[i] ? distSquared : nearest[i];
+			nearest[j] = nearest[j] < 0.0 || distSquared < nearest[j] ? distSquared : nearest[j];
+			unsigned int a = findRoot(parents, i), b = findRoot(parents, j);
+			if(a < b){
+				parents[b] = a;
+			}
+			else if(b < a){
+				parents[a] = b;
+			}
+		};
+		grid.forEachPair(0, grid.numCells(), radius, link);
+
+		/* Order parameters, around this frame's own centroid.
+		 */
+		ObservableSums sums;
+		clearSums(sums);
+		for(unsigned int i = 0; i < numBoids; i++){
+			addBoid(sums, boids[i], Point(0.0, 0.0), -1.0);
+		}
+		Point centroid = summarizeSums(sums).centroid;
+		clearSums(sums);
+		for(unsigned int i = 0; i < numBoids; i++){
+			addBoid(sums, boids[i], centroid, nearest[i]);
+		}
+		observables[s] = summarizeSums(sums);
+
+		/* Follow the clusters by their lowest identity.
+		 */
+		alive.assign(numBoids, false);
+		for(unsigned int i = 0; i < numBoids; i++){
+			alive[findRoot(parents, i)] = true;
+		}
+		for(unsigned int c = 0; c < numBoids; c++){
+			if(alive[c]){
+				results.runs[c]++;
+			}
+			else{
+				if(results.runs[c] > 0){
+					if(results.fromStart[c]){
+						results.headRuns[c] = results.runs[c];
+					}
+					else{
+						results.lifetimeCounts[lifetimeBin(results.runs[c])]++;
+					}
+				}
+				results.runs[c] = 0;
+				results.fromStart[c] = false;
+			}
+		}
+	}
+
+	/* Whatever is still alive either lived through the whole range or
+	 * carries on into the next one.
+	 */
+	for(unsigned int c = 0; c < numBoids; c++){
+		results.whole[c] = results.fromStart[c] && results.runs[c] > 0;
+	}
+}
+
+/**
+ * Main function.
+ *
+ * Reads the options, splits the frames among the workers and writes out
+ * what they found.
+ */
+int main(int argc, char* argv[]){
+	string usage = " [trajectory file] [--threads n] [--from frame] [--to frame] [--every k] [--cluster-radius px] [--output prefix]";
+
+	/* Check for arguments.
+	 */
+	if(argc < 2){
+		cerr << "Usage: " << argv[0] << usage << endl;
+		exit(1);
+	}
+
+	/* Read optional settings.
+	 */
+	string path(argv[1]);
+	unsigned int numThreads = thread::hardware_concurrency();
+	unsigned long from = 0;
+	unsigned long to = 0; // Up to the end
+	unsigned long every = 1;
+	float clusterRadius = 25.0;
+	string prefix = "analysis";
+	for(int i = 2; i < argc; i++){
+		string option(argv[i]);
+		if(i+1 >= argc){
+			cerr << "Missing value for " << option << endl << "Usage: " << argv[0] << usage << endl;
+			exit(1);
+		}
+		if(option == "--threads"){
+			numThreads = atoi(argv[++i]) > 1 ? atoi(argv[i]) : 1;
+		}
+		else if(option == "--from"){
+			from = atol(argv[++i]) > 0 ? atol(argv[i]) : 0;
+		}
+		else if(option == "--to"){
+			to = atol(argv[++i]) > 0 ? atol(argv[i]) : 0;
+		}
+		else if(option == "--every"){
+			every = atol(argv[++i]) > 1 ? atol(argv[i]) : 1;
+		}
+		else if(option == "--cluster-radius"){
+			clusterRadius = atof(argv[++i]);
+		}
+		else if(option == "--output"){
+			prefix = argv[++i];
+		}
+		else{
+			cerr << "Unknown option " << option << endl << "Usage: " << argv[0] << usage << endl;
+			exit(1);
+		}
+	}
+
+	TrajectoryFile* file = NULL;
+	try{
+		file = new TrajectoryFile(path);
+	}
+	catch(runtime_error& e){
+		cerr << e.what() << endl;
+		exit(1);
+	}
+	unsigned int numBoids = file->getNumBoids();
+	to = to > 0 && to < file->getNumFrames() ? to : file->getNumFrames();
+	unsigned long numSamples = to > from ? (to - from + every - 1) / every : 0;
+
+	/* Each worker takes a contiguous range of frames.
+	 */
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	WorkerPool workers(numThreads);
+	unsigned int numWorkers = workers.size();
+	vector<RangeResults> ranges(numWorkers);
+	vector<Observables> observables(numSamples);
+	for(unsigned int w = 0; w < numWorkers; w++){
+		ranges[w].first = numSamples*w / numWorkers;
+		ranges[w].last = numSamples*(w+1) / numWorkers;
+	}
+	workers.run([&](unsigned int w){
+		analyzeRange(*file, from, every, numSamples, clusterRadius, ranges[w], observables);
+	});
+
+	/* Stitch the ranges together, in order.
+	 */
+	vector<unsigned long> speedCounts(SPEED_BINS, 0);
+	vector<double> pathLengths(numBoids, 0.0);
+	vector<unsigned long> lifetimeCounts(LIFETIME_BINS, 0);
+	vector<unsigned long> carried(numBoids, 0);
+	unsigned long cutShort = 0;
+	for(unsigned int w = 0; w < numWorkers; w++){
+		RangeResults& range = ranges[w];
+		if(range.first == range.last){
+			continue;
+		}
+		for(unsigned int b = 0; b < SPEED_BINS; b++){
+			speedCounts[b] += range.speedCounts[b];
+		}
+		for(unsigned int b = 0; b < LIFETIME_BINS; b++){
+			lifetimeCounts[b] += range.lifetimeCounts[b];
+		}
+		for(unsigned int c = 0; c < numBoids; c++){
+			pathLengths[c] += range.pathLengths[c];
+			if(range.whole[c]){
+				carried[c] += range.runs[c];
+			}
+			else{
+				unsigned long lifetime = carried[c] + range.headRuns[c];
+				if(lifetime > 0){
+					lifetimeCounts[lifetimeBin(lifetime)]++;
+				}
+				carried[c] = range.runs[c];
+			}
+		}
+	}
+	for(unsigned int c = 0; c < numBoids; c++){
+		if(carried[c] > 0){
+			lifetimeCounts[lifetimeBin(carried[c])]++;
+			cutShort++;
+		}
+	}
+	chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+	/* Write out the tables.
+	 */
+	ofstream speedsOut((prefix + "-speeds.tsv").c_str());
+	unsigned long numSpeeds = numSamples*numBoids;
+	speedsOut << "speed_from\tspeed_to\tfraction\n";
+	for(unsigned int b = 0; b < SPEED_BINS; b++){
+		speedsOut << b*SPEED_BIN_WIDTH << "\t" << (b+1 < SPEED_BINS ? (b+1)*SPEED_BIN_WIDTH : INFINITY)
+			<< "\t" << (numSpeeds > 0 ? (double) speedCounts[b]/numSpeeds : 0.0) << "\n";
+	}
+	speedsOut.close();
+
+	ofstream observablesOut((prefix + "-observables.tsv").c_str());
+	writeObservablesHeader(observablesOut);
+	for(unsigned long s = 0; s < numSamples; s++){
+		writeObservables(observablesOut, from + s*every, observables[s]);
+	}
+	observablesOut.close();
+
+	ofstream displacementsOut((prefix + "-displacements.tsv").c_str());
+	displacementsOut << "id\tdx\tdy\tdisplacement\tpath_length\n";
+	if(numSamples > 0){
+		const TrajectoryRecord* first = file->getFrame(from);
+		const TrajectoryRecord* last = file->getFrame(from + (numSamples-1)*every);
+		for(unsigned int i = 0; i < numBoids; i++){
+			float dx = last[i].x - first[i].x, dy = last[i].y - first[i].y;
+			displacementsOut << i << "\t" << dx << "\t" << dy << "\t" << sqrt(dx*dx + dy*dy) << "\t" << pathLengths[i] << "\n";
+		}
+	}
+	displacementsOut.close();
+
+	ofstream lifetimesOut((prefix + "-lifetimes.tsv").c_str());
+	lifetimesOut << "lifetime_from\tlifetime_to\tclusters\n";
+	for(unsigned int b = 0; b < LIFETIME_BINS; b++){
+		if(lifetimeCounts[b] > 0){
+			lifetimesOut << (1ul << b)*every << "\t" << ((2ul << b) - 1)*every << "\t" << lifetimeCounts[b] << "\n";
+		}
+	}
+	lifetimesOut << "# lifetimes in frames; " << cutShort << " clusters still alive at the end are included\n";
+	lifetimesOut.close();
+
+	cout << "Analyzed " << numSamples << " frames of " << numBoids << " boids in " << elapsed.count() << " s: "
+		<< numSamples/elapsed.count() << " frames/sec, "
+		<< numSamples*file->getFrameBytes()/elapsed.count()/1e6 << " MB/sec" << endl;
+
+	delete file;
+	exit(0);
+}
@@ -0,0 +1,168 @@
+/**
+ * \file archive.cpp
+ *
+ * Driver program for converting between recorded runs (see
+ * TrajectoryRecorder.cpp) and compressed archives (see
+ * TrajectoryArchive.cpp):
+ *
+ *     flock-archive pack [trajectory file] [archive]
+ *     flock-archive unpack [archive] [trajectory file]
+ *
+ * Both ways work on all cores: packing hands chunks to the archiver's
+ * compressor threads, unpacking decompresses a batch of chunks at once on
+ * the worker threads and writes them out in order.
+ *
+ * @since	2026-10-18
+ */
+
+/**
+ * Definitions.
+ */
+#define CHUNK_FRAMES 64
+
+/**
+ * Includes.
+ *
+ * TrajectoryArchiver.h goes before the other headers of the project, since
+ * the standard headers it pulls in break on the min() and max() macros of
+ * geometry/common.h.
+ */
+#include <iostream>
+#include <fstream>
+#include <stdexcept>
+#include <chrono>
+#include <thread>
+#include <stdlib.h>
+#include "TrajectoryArchiver.h"
+#include "WorkerPool.h"
+#include "TrajectoryFile.h"
+#include "TrajectoryRecorder.h"
+#include "TrajectoryArchive.h"
+
+using namespace std;
+
+/**
+ * Compresses a recorded run.
+ *
+ * @param from		Path of the trajectory file.
+ * @param to		Path of the archive.
+ * @param chunkFrames	Frames per chunk.
+ * @param numThreads	Number of compressor threads.
+ * @throws		std::runtime_error if a file can't be read or written.
+ */
+void pack(const string& from, const string& to, unsigned int chunkFrames, unsigned int numThreads){
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	TrajectoryFile file(from);
+	{
+		TrajectoryArchiver archiver(to, file.getNumBoids(), file.getEdges(), chunkFrames, numThreads);
+		for(unsigned long f = 0; f < file.getNumFrames(); f++){
+			archiver.recordFrame(file.getFrame(f));
+		}
+	}
+	chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+	double rawBytes = (double) file.getNumFrames()*file.getFrameBytes();
+	double compressedBytes = ifstream(to.c_str(), ios::binary | ios::ate).tellg();
+	cout << "Packed " << file.getNumFrames() << " frames in " << elapsed.count() << " s: "
+		<< file.getNumFrames()/elapsed.count() << " frames/sec, "
+		<< rawBytes/elapsed.count()/1e6 << " MB/sec, ratio " << (compressedBytes > 0.0 ? rawBytes/compressedBytes : 0.0) << endl;
+}
+
+/**
+ * Decompresses an archive back into a recorded run.
+ *
+ * @param from		Path of the archive.
+ * @param to		Path of the trajectory file.
+ * @param workers	Threads to decompress on.
+ * @throws		std::runtime_error if a file can't be read or
+ * 			written, or the archive is corrupt.
+ */
+void unpack(const string& from, const string& to, WorkerPool& workers){
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	TrajectoryArchive archive(from);
+	TrajectoryRecorder recorder(to, archive.getNumBoids(), archive.getEdges());
+	unsigned int numBoids = archive.getNumBoids();
+	unsigned int numWorkers = workers.size();
+	unsigned long numChunks = archive.getNumChunks();
+	vector<vector<TrajectoryRecord> > batch(numWorkers);
+	vector<string> errors(numWorkers);
+
+	for(unsigned long first = 0; first < numChunks; first += numWorkers){
+		workers.run([&](unsigned int w){
+			if(first + w < numChunks){
+				try{
+					archive.readChunk(first + w, batch[w]);
+				}
+				catch(runtime_error& e){
+					errors[w] = e.what();
+				}
+			}
+		});
+		for(unsigned int w = 0; w < numWorkers && first + w < numChunks; w++){
+			if(!errors[w].empty()){
+				throw runtime_error(errors[w]);
+			}
+			for(unsigned int f = 0; f < archive.getChunk(first + w).numFrames; f++){
+				recorder.recordFrame(&batch[w][(size_t) f*numBoids]);
+			}
+		}
+	}
+	chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+	cout << "Unpacked " << archive.getNumFrames() << " frames in " << elapsed.count() << " s: "
+		<< archive.getNumFrames()/elapsed.count() << " frames/sec" << endl;
+}
+
+/**
+ * Main function.
+ *
+ * Reads the arguments and converts the file.
+ */
+int main(int argc, char* argv[]){
+	string usage = " pack|unpack [from] [to] [--threads n] [--chunk-frames k]";
+
+	/* Check for arguments.
+	 */
+	if(argc < 4 || (string(argv[1]) != "pack" && string(argv[1]) != "unpack")){
+		cerr << "Usage: " << argv[0] << usage << endl;
+		exit(1);
+	}
+
+	/* Read optional settings.
+	 */
+	unsigned int numThreads = thread::hardware_concurrency();
+	unsigned int chunkFrames = CHUNK_FRAMES;
+	for(int i = 4; i < argc; i++){
+		string option(argv[i]);
+		if(i+1 >= argc){
+			cerr << "Missing value for " << option << endl << "Usage: " << argv[0] << usage << endl;
+			exit(1);
+		}
+		if(option == "--threads"){
+			numThreads = atoi(argv[++i]) > 1 ? atoi(argv[i]) : 1;
+		}
+		else if(option == "--chunk-frames"){
+			chunkFrames = atoi(argv[++i]) > 1 ? atoi(argv[i]) : 1;
+		}
+		else{
+			cerr << "Unknown option " << option << endl << "Usage: " << argv[0] << usage << endl;
+			exit(1);
+		}
+	}
+
+	try{
+		if(string(argv[1]) == "pack"){
+			pack(argv[2], argv[3], chunkFrames, numThreads);
+		}
+		else{
+			WorkerPool workers(numThreads);
+			unpack(argv[2], argv[3], workers);
+		}
+	}
+	catch(runtime_error& e){
+		cerr << e.what() << endl;
+		exit(1);
+	}
+
+	exit(0);
+}
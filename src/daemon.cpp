@@ -0,0 +1,863 @@
+/**
+ * \file daemon.cpp
+ *
+ * Driver program for a long-running simulation service. Takes jobs over a
+ * Unix domain socket, runs them headless and streams the results back, so
+ * that scripts running many short experiments don't pay for starting up a
+ * process, its threads and its memory every time.
+ *
+ * The protocol is line based. A client sends
+ *
+ *     run [key=value ...]
+ *
+ * with any of the keys below, and gets back tab separated lines: an
+ * "observables" line every so many steps if asked for (same columns as the
+ * simulation's --observables option), then a "done" line with the number of
+ * steps, the time taken and the steps per second, or an "error" line.
+ *
+ *     ensemble [key=value,value,... ...]
+ *
+ * runs several such jobs side by side, one per value of the keys that are
+ * given a list (the rest are shared), and tags each "observables" line with
+ * the number of the job after the word "observables". Only cohesion,
+ * separation, alignment, attraction, seed, orbit and period may vary. The
+ * jobs are stepped ENSEMBLE_LANES at a time on a LaneEnsemble (see
+ * LaneEnsemble.cpp), with as many ensembles at once as there are workers.
+ *
+ *     parareal [key=value ...]
+ *
+ * runs a job in parallel in time instead (see Parareal.cpp): the steps are
+ * cut up into slices, one per worker unless told otherwise, and a "parareal"
+ * line follows every iteration with its number, the largest and the mean
+ * distance it moved the boids by, and the time taken so far. Iterations stop
+ * once that largest distance is within the tolerance. The "observables"
+ * lines are for the start of every slice. Takes the keys of a run, except for
+ * record and archive, and:
+ *
+ * - slices: number of time slices, at most one per step. The steps are
+ *   shared out evenly between them.
+ * - coarse: steps the coarse propagator takes at once.
+ * - coarse-cutoff, coarse-stride: perception cutoff and flockmate stride of
+ *   the coarse propagator.
+ * - iterations: most iterations to run, 0 for up to one per slice.
+ * - tolerance: in pixels.
+ *
+ * "quit" ends the connection and "shutdown" stops the daemon.
+ *
+ * - boids, cohesion, separation, alignment, attraction: as for flocking.
+ * - steps: number of steps to run, at least 1.
+ * - seed: seed for the starting positions, so runs can be repeated.
+ * - width, height: extent of the world.
+ * - cutoff, stride: perception cutoff and flockmate stride.
+ * - spawn, spacing: side of the region the boids start in, and the minimum
+ *   distance between them there.
+ * - orbit, period: radius of a circle about the middle of the world that
+ *   the destination goes around, once every period steps. 0 for a
+ *   destination that stays in the middle.
+ * - observables: stream the order parameters every so many steps.
+ * - record, archive: write the run to a trajectory file or an archive.
+ * - from: trajectory file to start from, e.g. a dump of the flight recorder
+ *   of flocking: the boids start out as in its last frame, and boids, width
+ *   and height are those of the file.
+ * - deterministic: 1 to run in fixed point (see below).
+ *
+ * Jobs run one after the other, each on all of the worker threads, which
+ * are started once and stay pinned. The simulation is kept between jobs in
+ * the same world and only reset, so its storage is reused too. Jobs with at
+ * most SMALL_FLOCK_MAX boids and a stride of 1 run on a single thread
+ * instead, on a SmallFlock (see SmallFlock.cpp).
+ *
+ * With deterministic=1, a run goes in fixed point instead, on a
+ * DeterministicFlock (see DeterministicFlock.cpp), and comes out the same to
+ * the bit on any machine and any number of workers. A "checksum" line with a
+ * fingerprint of the final state comes before the "done" line, to compare
+ * runs by. Such runs consider every flockmate, and their destination stays
+ * in the middle of the world, since orbits are worked out with libm.
+ *
+ * @since	2026-10-18
+ */
+
+/**
+ * Definitions.
+ */
+#define DEFAULT_SOCKET "/tmp/flock-daemon.sock"
+#define ARCHIVE_CHUNK_FRAMES 64
+#define ARCHIVE_THREADS 2
+#define PI 3.14159265
+
+/**
+ * Includes.
+ *
+ * TrajectoryArchiver.h goes before the other headers of the project, since
+ * the standard headers it pulls in break on the min() and max() macros of
+ * geometry/common.h.
+ */
+#include <iostream>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <chrono>
+#include <thread>
+#include <functional>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <math.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "TrajectoryArchiver.h"
+#include "WorkerPool.h"
+#include "Simulation.h"
+#include "SmallFlock.h"
+#include "DeterministicFlock.h"
+#include "LaneEnsemble.h"
+#include "Parareal.h"
+#include "Observables.h"
+#include "TrajectoryRecorder.h"
+#include "TrajectoryFile.h"
+#include "Placement.h"
+
+using namespace std;
+
+/**
+ * Description of a simulation run.
+ */
+struct Job {
+	unsigned int numBoids;
+	float cohesion;
+	float separation;
+	float alignment;
+	float attraction;
+	unsigned long steps;
+	unsigned int seed;
+	float width;
+	float height;
+	float cutoff;		// 0 for the whole world.
+	unsigned int stride;
+	float spawnSize;	// Side of the region the boids start in.
+	float spacing;		// Minimum distance between them at the start.
+	float orbit;		// Radius the destination circles at, 0 for none.
+	unsigned int period;	// Steps per circle.
+	unsigned int observablesEvery;	// 0 for none.
+	string record;
+	string archive;
+	bool deterministic;	// Fixed point, the same on any machine.
+	string from;		// Trajectory file to start from, instead of spawning.
+};
+
+/**
+ * How to run a job in parallel in time, on top of the job itself.
+ */
+struct PararealJob {
+	unsigned int slices;		// 0 for one per worker.
+	unsigned int coarseStep;	// Steps per coarse step.
+	float coarseCutoff;		// 0 for the cutoff of the job.
+	unsigned int coarseStride;
+	unsigned int maxIterations;	// 0 for up to one per slice.
+	double tolerance;		// Largest correction (pixels) to stop at.
+};
+
+/**
+ * Reads a job description.
+ *
+ * @param line	The words after "run".
+ * @param job	Filled with the job; anything not given keeps the
+ * 		defaults of flocking.
+ * @param error	Set to what is wrong with the description, if anything.
+ * @return	true if the description is valid.
+ */
+bool parseJob(const string& line, Job& job, string& error){
+	job.numBoids = 500;
+	job.cohesion = 0.005;
+	job.separation = 0.2;
+	job.alignment = 0.05;
+	job.attraction = 1.0;
+	job.steps = 1000;
+	job.seed = 1;
+	job.width = 1200;
+	job.height = 700;
+	job.cutoff = 0.0;
+	job.stride = 1;
+	job.spawnSize = 200.0;
+	job.spacing = 5.0;
+	job.orbit = 0.0;
+	job.period = 1000;
+	job.observablesEvery = 0;
+	job.record.clear();
+	job.archive.clear();
+	job.deterministic = false;
+	job.from.clear();
+
+	istringstream words(line);
+	string word;
+	while(words >> word){
+		size_t equals = word.find('=');
+		if(equals == string::npos){
+			error = "expected key=value, got " + word;
+			return false;
+		}
+		string key = word.substr(0, equals);
+		string value = word.substr(equals + 1);
+		const char* number = value.c_str();
+		if(key == "boids"){
+			if(atol(number) <= 0 || atol(number) > UINT_MAX){
+				error = "boids must be from 1 to 4294967295, got " + value;
+				return false;
+			}
+			job.numBoids = atol(number);
+		}
+		else if(key == "cohesion") job.cohesion = atof(number);
+		else if(key == "separation") job.separation = atof(number);
+		else if(key == "alignment") job.alignment = atof(number);
+		else if(key == "attraction") job.attraction = atof(number);
+		else if(key == "steps"){
+			if(atol(number) <= 0){
+				error = "steps must be positive, got " + value;
+				return false;
+			}
+			job.steps = atol(number);
+		}
+		else if(key == "seed") job.seed = atoi(number);
+		else if(key == "width") job.width = atof(number);
+		else if(key == "height") job.height = atof(number);
+		else if(key == "cutoff") job.cutoff = atof(number);
+		else if(key == "stride") job.stride = atoi(number) > 1 ? atoi(number) : 1;
+		else if(key == "spawn") job.spawnSize = atof(number) > 0.0 ? atof(number) : 0.0;
+		else if(key == "spacing") job.spacing = atof(number) > 1.0 ? atof(number) : 1.0;
+		else if(key == "orbit") job.orbit = atof(number) > 0.0 ? atof(number) : 0.0;
+		else if(key == "period") job.period = atoi(number) > 1 ? atoi(number) : 1;
+		else if(key == "observables") job.observablesEvery = atoi(number) > 0 ? atoi(number) : 0;
+		else if(key == "record") job.record = value;
+		else if(key == "archive") job.archive = value;
+		else if(key == "deterministic") job.deterministic = atoi(number) != 0;
+		else if(key == "from") job.from = value;
+		else{
+			error = "unknown key " + key;
+			return false;
+		}
+	}
+
+	/* A run from a trajectory file takes place in its world, with its
+	 * population.
+	 */
+	if(!job.from.empty()){
+		try{
+			TrajectoryFile file(job.from);
+			if(file.getNumFrames() == 0){
+				error = job.from + " has no frames";
+				return false;
+			}
+			job.numBoids = file.getNumBoids();
+			job.width = file.getEdges().x;
+			job.height = file.getEdges().y;
+		}
+		catch(runtime_error& e){
+			error = e.what();
+			return false;
+		}
+	}
+
+	/* Anything but a finite number would turn into sizes that can't be
+	 * allocated further down.
+	 */
+	double sizes[] = {job.cohesion, job.separation, job.alignment, job.attraction, job.width, job.height, job.cutoff, job.spawnSize, job.spacing, job.orbit};
+	for(unsigned int i = 0; i < sizeof(sizes)/sizeof(sizes[0]); i++){
+		if(!isfinite(sizes[i])){
+			error = "coefficients and sizes must be finite numbers";
+			return false;
+		}
+	}
+	if(job.width < 1.0 || job.height < 1.0){
+		error = "world too small";
+		return false;
+	}
+	if(job.deterministic && (job.stride != 1 || job.orbit > 0.0)){
+		error = "deterministic runs consider every flockmate and have a destination that stays put";
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * Reads the description of an ensemble of jobs.
+ *
+ * @param line	The words after "ensemble".
+ * @param jobs	Filled with one job per value of the keys given a list.
+ * @param error	Set to what is wrong with the description, if anything.
+ * @return	true if the description is valid.
+ */
+bool parseEnsemble(const string& line, vector<Job>& jobs, string& error){
+	const string varying[] = {"cohesion", "separation", "alignment", "attraction", "seed", "orbit", "period"};
+	vector<string> shared;
+	vector<string> keys;
+	vector<vector<string> > values;
+	istringstream words(line);
+	string word;
+	while(words >> word){
+		size_t equals = word.find('=');
+		if(equals == string::npos || word.find(',', equals) == string::npos){
+			shared.push_back(word);
+			continue;
+		}
+		string key = word.substr(0, equals);
+		if(find(varying, varying + sizeof(varying)/sizeof(varying[0]), key) == varying + sizeof(varying)/sizeof(varying[0])){
+			error = key + " can't vary within an ensemble";
+			return false;
+		}
+		istringstream list(word.substr(equals + 1));
+		vector<string> keyValues;
+		string value;
+		while(getline(list, value, ',')){
+			keyValues.push_back(value);
+		}
+		if(!values.empty() && keyValues.size() != values[0].size()){
+			error = "lists of different lengths";
+			return false;
+		}
+		keys.push_back(key);
+		values.push_back(keyValues);
+	}
+
+	/* Each job is read like a run, with its own value of every list.
+	 */
+	unsigned int numJobs = values.empty() ? 1 : values[0].size();
+	jobs.resize(numJobs);
+	for(unsigned int j = 0; j < numJobs; j++){
+		ostringstream jobLine;
+		for(unsigned int w = 0; w < shared.size(); w++){
+			jobLine << shared[w] << ' ';
+		}
+		for(unsigned int k = 0; k < keys.size(); k++){
+			jobLine << keys[k] << '=' << values[k][j] << ' ';
+		}
+		if(!parseJob(jobLine.str(), jobs[j], error)){
+			return false;
+		}
+	}
+
+	if(jobs[0].stride != 1 || !jobs[0].record.empty() || !jobs[0].archive.empty() || jobs[0].deterministic){
+		error = "ensembles consider every flockmate, record nothing and run in floating point";
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * Reads the description of a job to run in parallel in time.
+ *
+ * @param line		The words after "parareal".
+ * @param job		Filled with the job.
+ * @param parareal	Filled with how to run it.
+ * @param error		Set to what is wrong with the description, if
+ * 			anything.
+ * @return		true if the description is valid.
+ */
+bool parsePararealJob(const string& line, Job& job, PararealJob& parareal, string& error){
+	parareal.slices = 0;
+	parareal.coarseStep = 2;
+	parareal.coarseCutoff = 0.0;
+	parareal.coarseStride = 2;
+	parareal.maxIterations = 0;
+	parareal.tolerance = 0.01;
+
+	/* Anything that isn't about parareal is about the job.
+	 */
+	ostringstream jobLine;
+	istringstream words(line);
+	string word;
+	while(words >> word){
+		size_t equals = word.find('=');
+		string key = word.substr(0, equals);
+		const char* number = equals == string::npos ? "" : word.c_str() + equals + 1;
+		if(key == "slices") parareal.slices = atoi(number) > 0 ? atoi(number) : 0;
+		else if(key == "coarse") parareal.coarseStep = atoi(number) > 1 ? atoi(number) : 1;
+		else if(key == "coarse-cutoff") parareal.coarseCutoff = atof(number) > 0.0 ? atof(number) : 0.0;
+		else if(key == "coarse-stride") parareal.coarseStride = atoi(number) > 1 ? atoi(number) : 1;
+		else if(key == "iterations") parareal.maxIterations = atoi(number) > 0 ? atoi(number) : 0;
+		else if(key == "tolerance") parareal.tolerance = atof(number) > 0.0 ? atof(number) : 0.0;
+		else jobLine << word << ' ';
+	}
+	if(!parseJob(jobLine.str(), job, error)){
+		return false;
+	}
+
+	if(!job.record.empty() || !job.archive.empty() || job.deterministic){
+		error = "parareal runs record nothing and run in floating point";
+		return false;
+	}
+	if(!isfinite(parareal.coarseCutoff) || !isfinite(parareal.tolerance)){
+		error = "coarse-cutoff and tolerance must be finite numbers";
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * Where a job's boids head for at some step: the middle of the world, or a
+ * point going around it.
+ *
+ * @param job	The job.
+ * @param step	The step.
+ * @return	Coordinates of the destination.
+ */
+Point destinationAt(const Job& job, unsigned long step){
+	double angle = 2*PI*(step % job.period)/job.period;
+
+	return Point(job.width/2 + job.orbit*cos(angle), job.height/2 + job.orbit*sin(angle));
+}
+
+/**
+ * Places the starting population of a job: a little ways away from the
+ * middle of the world, none of them too close to another, heading
+ * outwards, as flocking does. Or as in the last frame of a trajectory file,
+ * if the job starts from one.
+ *
+ * @param job		The job.
+ * @param workers	Threads to place on.
+ * @param pop		Cleared and filled with the population.
+ * @throws		std::runtime_error if the population doesn't fit, or the
+ * 			trajectory file can't be read.
+ */
+void spawnPopulation(const Job& job, WorkerPool& workers, vector<Boid>& pop){
+	Point center(job.width/2, job.height/2);
+	Point edges(job.width, job.height);
+	if(!job.from.empty()){
+		TrajectoryFile file(job.from);
+		if(file.getNumFrames() == 0 || file.getNumBoids() != job.numBoids){
+			throw runtime_error(job.from + " has changed!");
+		}
+		const TrajectoryRecord* records = file.getFrame(file.getNumFrames() - 1);
+		pop.clear();
+		for(unsigned int i = 0; i < job.numBoids; i++){
+			pop.push_back(Boid(Point(records[i].x, records[i].y), Vector(records[i].vx, records[i].vy), job.cohesion, job.separation, job.alignment, job.attraction, edges, i));
+		}
+		return;
+	}
+
+	vector<Point> positions;
+	placePoissonDisk(job.numBoids, center, job.spawnSize, job.spacing, edges, job.seed, workers, positions);
+
+	pop.clear();
+	for(unsigned int i = 0; i < job.numBoids; i++){
+		Vector velocity(copysign(3.0, positions[i].x-center.x), copysign(3.0, positions[i].y-center.y));
+		pop.push_back(Boid(positions[i], velocity, job.cohesion, job.separation, job.alignment, job.attraction, edges, i));
+	}
+}
+
+/**
+ * Runs a job and streams the results to the client.
+ *
+ * @param job		The job.
+ * @param workers	Threads to run it on.
+ * @param sim		Simulation kept from the last job, or NULL; replaced
+ * 			if the job takes place in another world.
+ * @param reply		Stream to the client.
+ * @return		false if the client went away.
+ */
+bool runJob(const Job& job, WorkerPool& workers, Simulation*& sim, FILE* reply){
+	static vector<Boid> pop;
+	Point edges(job.width, job.height);
+	try{
+		spawnPopulation(job, workers, pop);
+	}
+	catch(runtime_error& e){
+		fprintf(reply, "error\t%s\n", e.what());
+		return fflush(reply) == 0;
+	}
+
+	/* Deterministic runs go in fixed point, and other small flocks that
+	 * consider every flockmate take the fast path.
+	 */
+	RuleCoefficients coefficients = {job.cohesion, job.separation, job.alignment, job.attraction, DRAG_COEFFICIENT};
+	DeterministicFlock* fixed = NULL;
+	SmallFlock* small = NULL;
+	if(job.deterministic){
+		try{
+			fixed = new DeterministicFlock(pop, coefficients, edges, job.seed, workers);
+		}
+		catch(runtime_error& e){
+			fprintf(reply, "error\t%s\n", e.what());
+			return fflush(reply) == 0;
+		}
+	}
+	else if(job.stride == 1){
+		small = SmallFlock::create(pop, coefficients, edges);
+	}
+	if(sim && (sim->getEdges().x != edges.x || sim->getEdges().y != edges.y)){
+		delete sim;
+		sim = NULL;
+	}
+	if(!small && !fixed && sim){
+		sim->reset(pop);
+	}
+	else if(!small && !fixed){
+		sim = new Simulation(pop, edges, false, workers, 1);
+	}
+
+	TrajectoryRecorder* recorder = NULL;
+	TrajectoryArchiver* archiver = NULL;
+	try{
+		if(!job.record.empty()){
+			recorder = new TrajectoryRecorder(job.record, job.numBoids, edges);
+		}
+		if(!job.archive.empty()){
+			archiver = new TrajectoryArchiver(job.archive, job.numBoids, edges, ARCHIVE_CHUNK_FRAMES, ARCHIVE_THREADS);
+		}
+	}
+	catch(runtime_error& e){
+		delete recorder;
+		delete small;
+		delete fixed;
+		fprintf(reply, "error\t%s\n", e.what());
+		return fflush(reply) == 0;
+	}
+
+	/* Everything is in sight unless told otherwise.
+	 */
+	float diagonal = sqrt(edges.x*edges.x + edges.y*edges.y);
+	QualitySettings quality = {job.cutoff > 0.0 ? job.cutoff : diagonal, job.stride, 1};
+	bool connected = true;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for(unsigned long s = 0; s < job.steps && connected; s++){
+		bool observe = job.observablesEvery > 0 && s % job.observablesEvery == 0;
+		Point destination = destinationAt(job, s);
+		if(fixed){
+			fixed->step(destination, quality.cutoff, observe);
+		}
+		else if(small){
+			small->step(destination, quality.cutoff, observe);
+		}
+		else{
+			sim->step(destination, quality);
+		}
+		if(recorder || archiver){
+			if(fixed){
+				fixed->getBoids(pop);
+			}
+			else if(small){
+				small->getBoids(pop);
+			}
+			else{
+				sim->getBoids(pop);
+			}
+			if(recorder){
+				recorder->record(pop);
+			}
+			if(archiver){
+				archiver->record(pop);
+			}
+		}
+		if(observe){
+			ostringstream line;
+			line << "observables\t";
+			writeObservables(line, s, fixed ? fixed->getObservables() : small ? small->getObservables() : sim->getObservables());
+			connected = fputs(line.str().c_str(), reply) >= 0;
+		}
+	}
+	chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+	delete recorder;
+	delete archiver;
+	delete small;
+
+	if(connected && fixed){
+		fprintf(reply, "checksum\t%016llx\n", (unsigned long long) fixed->checksum());
+	}
+	delete fixed;
+	if(connected){
+		fprintf(reply, "done\t%lu\t%g\t%g\n", job.steps, elapsed.count(), job.steps/elapsed.count());
+	}
+
+	return connected && fflush(reply) == 0;
+}
+
+/**
+ * Runs an ensemble of jobs and streams the results to the client.
+ *
+ * @param jobs		The jobs, alike but for their coefficients, seeds
+ * 			and destinations.
+ * @param workers	Threads to run them on, an ensemble of up to
+ * 			ENSEMBLE_LANES jobs per thread at a time.
+ * @param reply		Stream to the client.
+ * @return		false if the client went away.
+ */
+bool runEnsemble(const vector<Job>& jobs, WorkerPool& workers, FILE* reply){
+	const Job& shared = jobs[0];
+	Point edges(shared.width, shared.height);
+	vector<LaneEnsemble*> ensembles;
+	try{
+		for(unsigned int first = 0; first < jobs.size(); first += ENSEMBLE_LANES){
+			vector<vector<Boid> > populations;
+			vector<RuleCoefficients> coefficients;
+			vector<unsigned int> seeds;
+			for(unsigned int j = first; j < jobs.size() && j < first + ENSEMBLE_LANES; j++){
+				populations.push_back(vector<Boid>());
+				spawnPopulation(jobs[j], workers, populations.back());
+				RuleCoefficients laneCoefficients = {jobs[j].cohesion, jobs[j].separation, jobs[j].alignment, jobs[j].attraction, DRAG_COEFFICIENT};
+				coefficients.push_back(laneCoefficients);
+				seeds.push_back(jobs[j].seed);
+			}
+			ensembles.push_back(new LaneEnsemble(populations, coefficients, seeds, edges));
+		}
+	}
+	catch(runtime_error& e){
+		for(unsigned int i = 0; i < ensembles.size(); i++){
+			delete ensembles[i];
+		}
+		fprintf(reply, "error\t%s\n", e.what());
+		return fflush(reply) == 0;
+	}
+
+	float diagonal = sqrt(edges.x*edges.x + edges.y*edges.y);
+	float cutoff = shared.cutoff > 0.0 ? shared.cutoff : diagonal;
+	bool connected = true;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for(unsigned long s = 0; s < shared.steps && connected; s++){
+		bool observe = shared.observablesEvery > 0 && s % shared.observablesEvery == 0;
+		workers.run([&](unsigned int worker){
+			vector<Point> destinations;
+			for(unsigned int e = worker; e < ensembles.size(); e += workers.size()){
+				destinations.clear();
+				for(unsigned int l = 0; l < ensembles[e]->lanes(); l++){
+					destinations.push_back(destinationAt(jobs[e*ENSEMBLE_LANES + l], s));
+				}
+				ensembles[e]->step(destinations, cutoff, observe);
+			}
+		});
+		if(observe){
+			ostringstream lines;
+			for(unsigned int j = 0; j < jobs.size(); j++){
+				lines << "observables\t" << j << '\t';
+				writeObservables(lines, s, ensembles[j/ENSEMBLE_LANES]->getObservables(j%ENSEMBLE_LANES));
+			}
+			connected = fputs(lines.str().c_str(), reply) >= 0;
+		}
+	}
+	chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+	for(unsigned int i = 0; i < ensembles.size(); i++){
+		delete ensembles[i];
+	}
+
+	if(connected){
+		fprintf(reply, "done\t%lu\t%g\t%g\n", shared.steps, elapsed.count(), shared.steps/elapsed.count());
+	}
+
+	return connected && fflush(reply) == 0;
+}
+
+/**
+ * Runs a job in parallel in time and streams the results to the client.
+ *
+ * @param job		The job.
+ * @param parareal	How to run it.
+ * @param workers	Threads to run the slices on.
+ * @param reply		Stream to the client.
+ * @return		false if the client went away.
+ */
+bool runParareal(const Job& job, const PararealJob& parareal, WorkerPool& workers, FILE* reply){
+	static vector<Boid> pop;
+	Point edges(job.width, job.height);
+	float diagonal = sqrt(edges.x*edges.x + edges.y*edges.y);
+	float cutoff = job.cutoff > 0.0 ? job.cutoff : diagonal;
+	PararealSettings settings;
+	settings.slices = parareal.slices > 0 ? parareal.slices : workers.size();
+	settings.slices = settings.slices < job.steps ? settings.slices : job.steps;
+	settings.steps = job.steps;
+	settings.coarseStep = parareal.coarseStep;
+	settings.fine.cutoff = cutoff;
+	settings.fine.stride = job.stride;
+	settings.fine.renderEvery = 1;
+	settings.coarse.cutoff = parareal.coarseCutoff > 0.0 && parareal.coarseCutoff < cutoff ? parareal.coarseCutoff : cutoff;
+	settings.coarse.stride = parareal.coarseStride;
+	settings.coarse.renderEvery = 1;
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	Parareal* run = NULL;
+	try{
+		spawnPopulation(job, workers, pop);
+		run = new Parareal(pop, edges, settings, [&](unsigned long s){ return destinationAt(job, s); }, job.seed, workers);
+	}
+	catch(runtime_error& e){
+		fprintf(reply, "error\t%s\n", e.what());
+		return fflush(reply) == 0;
+	}
+
+	unsigned int maxIterations = parareal.maxIterations > 0 ? parareal.maxIterations : settings.slices;
+	bool connected = true;
+	bool converged = false;
+	while(connected && !converged && !run->isExact() && run->getIterations() < maxIterations){
+		run->iterate();
+		chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+		converged = run->getLargestChange() <= parareal.tolerance;
+		connected = fprintf(reply, "parareal\t%u\t%g\t%g\t%g\n", run->getIterations(), run->getLargestChange(), run->getMeanChange(), elapsed.count()) >= 0 && fflush(reply) == 0;
+	}
+	chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+	if(job.observablesEvery > 0 && connected){
+		ostringstream lines;
+		for(unsigned int n = 0; n < settings.slices; n++){
+			lines << "observables\t";
+			writeObservables(lines, run->getSliceStart(n), run->getObservables(n));
+		}
+		connected = fputs(lines.str().c_str(), reply) >= 0;
+	}
+	if(connected){
+		fprintf(reply, "done\t%lu\t%g\t%g\n", run->getSteps(), elapsed.count(), run->getSteps()/elapsed.count());
+	}
+	delete run;
+
+	return connected && fflush(reply) == 0;
+}
+
+/**
+ * Runs a job, and turns whatever it throws (running out of memory
+ * included) into an error line, so that no job takes the daemon down.
+ *
+ * @param reply	Stream to the client.
+ * @param job	Runs the job; returns false if the client went away.
+ * @return	false if the client went away.
+ */
+bool runSafely(FILE* reply, const function<bool()>& job){
+	try{
+		return job();
+	}
+	catch(exception& e){
+		fprintf(reply, "error\t%s\n", e.what());
+		return fflush(reply) == 0;
+	}
+}
+
+/**
+ * Main function.
+ *
+ * Sets up the socket and the workers, then serves one client at a time
+ * until told to shut down.
+ */
+int main(int argc, char* argv[]){
+	string usage = " [--socket path] [--threads n]";
+
+	/* Read optional settings.
+	 */
+	string socketPath = DEFAULT_SOCKET;
+	unsigned int numThreads = thread::hardware_concurrency();
+	for(int i = 1; i < argc; i++){
+		string option(argv[i]);
+		if(i+1 >= argc){
+			cerr << "Missing value for " << option << endl << "Usage: " << argv[0] << usage << endl;
+			exit(1);
+		}
+		if(option == "--socket"){
+			socketPath = argv[++i];
+		}
+		else if(option == "--threads"){
+			numThreads = atoi(argv[++i]) > 1 ? atoi(argv[i]) : 1;
+		}
+		else{
+			cerr << "Unknown option " << option << endl << "Usage: " << argv[0] << usage << endl;
+			exit(1);
+		}
+	}
+
+	/* A client hanging up mid-job must not take the daemon down.
+	 */
+	signal(SIGPIPE, SIG_IGN);
+
+	sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if(socketPath.size() >= sizeof(address.sun_path)){
+		cerr << "Socket path too long: " << socketPath << endl;
+		exit(1);
+	}
+	strcpy(address.sun_path, socketPath.c_str());
+	int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+	unlink(socketPath.c_str());
+	if(listener < 0 || bind(listener, (sockaddr*) &address, sizeof(address)) < 0 || listen(listener, 16) < 0){
+		cerr << "Unable to listen on " << socketPath << ": " << strerror(errno) << endl;
+		exit(1);
+	}
+
+	WorkerPool workers(numThreads);
+	Simulation* sim = NULL;
+	cerr << "Listening on " << socketPath << " with " << workers.size() << " workers" << endl;
+
+	bool serving = true;
+	while(serving){
+		int connection = accept(listener, NULL, NULL);
+		if(connection < 0){
+			continue;
+		}
+		FILE* request = fdopen(connection, "r");
+		FILE* reply = fdopen(dup(connection), "w");
+
+		/* Serve requests until the client is done.
+		 */
+		char* line = NULL;
+		size_t capacity = 0;
+		bool connected = true;
+		while(connected && getline(&line, &capacity, request) > 0){
+			string command(line);
+			command.erase(command.find_last_not_of(" \r\n") + 1);
+			if(command == "quit"){
+				break;
+			}
+			else if(command == "shutdown"){
+				serving = false;
+				break;
+			}
+			else if(command == "run" || command.compare(0, 4, "run ") == 0){
+				Job job;
+				string error;
+				if(parseJob(command.substr(3), job, error)){
+					connected = runSafely(reply, [&](){ return runJob(job, workers, sim, reply); });
+				}
+				else{
+					fprintf(reply, "error\t%s\n", error.c_str());
+					connected = fflush(reply) == 0;
+				}
+			}
+			else if(command == "ensemble" || command.compare(0, 9, "ensemble ") == 0){
+				vector<Job> jobs;
+				string error;
+				if(parseEnsemble(command.substr(8), jobs, error)){
+					connected = runSafely(reply, [&](){ return runEnsemble(jobs, workers, reply); });
+				}
+				else{
+					fprintf(reply, "error\t%s\n", error.c_str());
+					connected = fflush(reply) == 0;
+				}
+			}
+			else if(command == "parareal" || command.compare(0, 9, "parareal ") == 0){
+				Job job;
+				PararealJob parareal;
+				string error;
+				if(parsePararealJob(command.substr(8), job, parareal, error)){
+					connected = runSafely(reply, [&](){ return runParareal(job, parareal, workers, reply); });
+				}
+				else{
+					fprintf(reply, "error\t%s\n", error.c_str());
+					connected = fflush(reply) == 0;
+				}
+			}
+			else if(!command.empty()){
+				fprintf(reply, "error\tunknown command %s\n", command.c_str());
+				connected = fflush(reply) == 0;
+			}
+		}
+		free(line);
+		fclose(request);
+		fclose(reply);
+	}
+
+	delete sim;
+	close(listener);
+	unlink(socketPath.c_str());
+
+	exit(0);
+}
@@ -11,8 +11,20 @@
 /**
  * Definitions.
  */
-#define PI 3.14159265
 #define WRAPPED false // Should Boids wrap around the edge of the playing field?
+#define STRUCTURE_BINS 50 // Distance bins for the pair correlation function
+#define BOID_HEIGHT 20 // Size of a sprite
+#define BOID_WIDTH 20
+#define NUM_ANIM_FRAMES 12 // Headings in the sprite sheet
+#define ATLAS_HEADINGS 36 // Headings drawn from it, unless told otherwise
+#define BIRD_ICON_FILE "gfx/red-arrow-rot-12x.bmp"
+#define SEEK_STEP 100 // Recorded frames skipped by the arrow keys during replay
+#define ARCHIVE_CHUNK_FRAMES 64 // Frames per independently compressed chunk
+#define ARCHIVE_THREADS 2 // Compressor threads, next to the simulation workers
+#define TILE_SIZE 64 // Pixels along the side of a drawing tile, unless tuned
+#define DENSITY_HOTSPOTS 3 // Fullest cells reported by the density telemetry
+#define FLIGHT_FRAMES 150 // Frames the flight recorder keeps the timings of, unless told otherwise
+#define FLIGHT_SNAPSHOTS 8 // Frames it keeps the population of, unless told otherwise
 
 /**
  * Includes.
@@ -22,54 +34,215 @@
 #include <time.h>
 #include <math.h>
 #include <algorithm>
+#include <chrono>
+#include <thread>
+#include <fstream>
+#include <sstream>
 #include <stdexcept>
+#include "TrajectoryArchiver.h" // Before Boid.h: its standard headers break on the min() and max() macros of geometry/common.h
 #include "Boid.h"
+#include "QualityController.h"
+#include "WorkerPool.h"
+#include "Simulation.h"
+#include "DomainDecomposition.h"
+#include "ClusterAnalysis.h"
+#include "DensityTelemetry.h"
+#include "Observables.h"
+#include "PairCorrelation.h"
+#include "TrajectoryRecorder.h"
+#include "NeighborGraphWriter.h"
+#include "TrajectoryFile.h"
+#include "SpriteAtlas.h"
+#include "TileRenderer.h"
+#include "Placement.h"
+#include "Autotuner.h"
+#include "FlightRecorder.h"
 #include "sdl/sdl-wrapper.h"
 
 using namespace std;
 
 /**
- * Generates (crappy) random whole integers on some interval.
+ * Draws the sprites of the Boids at every heading, zoom level and tint.
  *
- * Doesn't actually generate numbers that are uniformly distributed on the 
- * interval, but reasonably close.
- * 
- * @param start	Start of the interval.
- * @param end	End of the interval.
- * @return	Floating-point representation of the integer.
+ * Tint 0 is the red of the sprite sheet, the others tell sub-flocks apart.
+ * Exits with exit code 1 if the sprite sheet can't be used.
+ *
+ * @param birdIcons	Sprite sheet with a Boid at each of NUM_ANIM_FRAMES
+ * 			headings.
+ * @param numHeadings	Number of headings to draw.
+ * @return		The atlas, to be deleted by the caller.
  */
-float badRandom(int start, int end){
-	return (float) (start + rand() % (end-start));
+SpriteAtlas* makeAtlas(SDL_Surface* birdIcons, unsigned int numHeadings){
+	const float zooms[] = {1.0, 1.5, 2.0, 3.0};
+	const Uint32 tints[] = {0x4080ff, 0x40ff60, 0xffd040, 0xff60ff, 0x40ffff, 0xffffff};
+	try{
+		return new SpriteAtlas(birdIcons, NUM_ANIM_FRAMES, BOID_WIDTH, BOID_HEIGHT, numHeadings, vector<float>(zooms, zooms + 4), vector<Uint32>(tints, tints + 6));
+	}
+	catch(runtime_error& e){
+		SDL_Quit();
+		cerr << e.what() << endl;
+		exit(1);
+	}
 }
 
 /**
- * Find the closest animation sprite for a rotating moving object.
+ * Changes the zoom level of the sprites on page up and page down.
  *
- * Determines the closest animation frame to a particular direction of travel. 
- * Assumes that the frames are ordered from 0 to N-1, rotated  
- * counter-clockwise from the X-axis.
+ * @param zoom		Current zoom level.
+ * @param key		Key that was pressed.
+ * @param numZooms	Number of zoom levels.
+ * @return		The new zoom level.
+ */
+unsigned int zoomed(unsigned int zoom, int key, unsigned int numZooms){
+	if(key == SDLK_PAGEUP && zoom + 1 < numZooms){
+		return zoom + 1;
+	}
+	if(key == SDLK_PAGEDOWN && zoom > 0){
+		return zoom - 1;
+	}
+	return zoom;
+}
+
+/**
+ * Gives every sub-flock a tint of its own.
  *
- * @param velocity	Direction in which the object is moving.
- * @param numFrames	The number of frames in the animated sprite.
+ * @param pop		The population.
+ * @param clusters	The last analysis of the sub-flocks of the population.
+ * @param numTints	Number of tints in the atlas.
+ * @param tints		Filled with the tint of each Boid, by identity.
  */
-unsigned int closestFrame(Vector velocity, unsigned int numFrames){
-	/* Calculate the angle to the X-axis.
-	 *
-	 * The coordinate system on screen is left-handed, not the standard
-	 * right-handedness, so a 90 degree rotation needs to be applied.
-	 */
-	float angle = -90.0 + (180.0/PI)*atan2(velocity.x, velocity.y);
+void tintClusters(const vector<Boid>& pop, const ClusterAnalysis& clusters, unsigned int numTints, vector<unsigned char>& tints){
+	const vector<unsigned int>& roots = clusters.getRoots();
+	tints.assign(pop.size(), 0);
+	for(unsigned int i = 0; i < pop.size() && numTints > 1; i++){
+		unsigned int id = pop[i].getId();
+		if(id < tints.size()){
+			tints[id] = 1 + pop[roots[i]].getId() % (numTints - 1);
+		}
+	}
+}
+
+/**
+ * Plays back a recorded run, without simulating anything.
+ *
+ * The recording is memory-mapped, so only the frames being shown are read.
+ * Playback runs at any speed, in recorded frames per drawn frame; in
+ * between recorded frames the Boids are interpolated linearly, which keeps
+ * slow motion smooth. Keys: space pauses, the up and down arrows double and
+ * halve the speed, the left and right arrows seek by SEEK_STEP frames, home
+ * and end seek to the start and end, and page up and page down zoom.
+ *
+ * @param path		Path of the trajectory file.
+ * @param speed		Recorded frames per drawn frame.
+ * @param seek		Recorded frame to start at.
+ * @param trails	Fading of the trails behind the Boids per drawn
+ * 			frame, 0 for none (see TileRenderer.cpp).
+ */
+void replay(const string& path, double speed, double seek, float trails){
+	TrajectoryFile* file = NULL;
+	try{
+		file = new TrajectoryFile(path);
+	}
+	catch(runtime_error& e){
+		cerr << e.what() << endl;
+		exit(1);
+	}
+	if(file->getNumFrames() == 0){
+		cerr << "Nothing recorded in " << path << endl;
+		exit(1);
+	}
+	unsigned int numBoids = file->getNumBoids();
+	Point edges = file->getEdges();
+	double lastFrame = file->getNumFrames() - 1;
+
+	SDL_Surface* screen = initializeDisplay(edges.x, edges.y);
+	if(!screen) cleanUpAndQuit();
+
+	SDL_Surface* birdIcons = loadBMPImage(BIRD_ICON_FILE);
+	if(!birdIcons) cleanUpAndQuit();
+	if(!transparentize(birdIcons, 255, 0, 255)) cleanUpAndQuit();
 
-	/* Convert to the frame with closest rotations, assuming they're
-	 * ordred counter-clockwise.
-	 *
-	 * Note that atan2() delivers signed angles on [-pi,pi], not
-	 * unsigned ones on [0,2*pi], so it needs some transformation.
+	/* Nothing is simulated, so drawing gets all of the cores.
 	 */
-	float degreesPerFrame = 360.0 / (float) numFrames;
-	unsigned int frame = angle >= 0.0 ? (unsigned int) floor(angle/degreesPerFrame) : (unsigned int) floor((angle+360.0)/degreesPerFrame);
+	WorkerPool workers(thread::hardware_concurrency());
+	SpriteAtlas* atlas = makeAtlas(birdIcons, ATLAS_HEADINGS);
+	TileRenderer* renderer = new TileRenderer(*atlas, workers, TILE_SIZE);
+	renderer->setTrails(trails);
+	vector<unsigned char> tints;
+	unsigned int zoom = 0;
 
-	return frame;
+	SDL_Event event;
+	vector<Boid> pop;
+	double position = seek < lastFrame ? seek : lastFrame;
+	bool paused = false;
+	bool running = true;
+	while(running){
+		/* Blend the two recorded frames around the playback position.
+		 */
+		unsigned long before = (unsigned long) position;
+		unsigned long after = before < lastFrame ? before + 1 : before;
+		float blend = position - before;
+		const TrajectoryRecord* from = file->getFrame(before);
+		const TrajectoryRecord* to = file->getFrame(after);
+		pop.clear();
+		for(unsigned int i = 0; i < numBoids; i++){
+			Point coordinates(from[i].x + blend*(to[i].x - from[i].x), from[i].y + blend*(to[i].y - from[i].y));
+			Vector velocity(from[i].vx + blend*(to[i].vx - from[i].vx), from[i].vy + blend*(to[i].vy - from[i].vy));
+			pop.push_back(Boid(coordinates, velocity, 0.0, 0.0, 0.0, 0.0, edges, i));
+		}
+		renderer->draw(screen, pop, zoom, tints);
+
+		/* Move on, stopping at the end of the recording.
+		 */
+		if(!paused){
+			position = position + speed < lastFrame ? position + speed : lastFrame;
+		}
+
+		/* Check for the user quitting or steering the playback.
+		 */
+		while(SDL_PollEvent(&event)){
+			switch(event.type){
+				case SDL_QUIT:
+					running = false;
+					break;
+				case SDL_KEYDOWN:
+					switch(event.key.keysym.sym){
+						case SDLK_SPACE:
+							paused = !paused;
+							break;
+						case SDLK_UP:
+							speed *= 2.0;
+							break;
+						case SDLK_DOWN:
+							speed *= 0.5;
+							break;
+						case SDLK_LEFT:
+							position = position > SEEK_STEP ? position - SEEK_STEP : 0.0;
+							break;
+						case SDLK_RIGHT:
+							position = position + SEEK_STEP < lastFrame ? position + SEEK_STEP : lastFrame;
+							break;
+						case SDLK_HOME:
+							position = 0.0;
+							break;
+						case SDLK_END:
+							position = lastFrame;
+							break;
+						default:
+							zoom = zoomed(zoom, event.key.keysym.sym, atlas->getNumZooms());
+							break;
+					}
+					break;
+			}
+		}
+	}
+
+	delete renderer;
+	delete atlas;
+	delete file;
+	SDL_Quit();
+
+	exit(0);
 }
 
 /**
@@ -81,12 +254,47 @@ unsigned int closestFrame(Vector velocity, unsigned int numFrames){
  * @see		SDL.h
  */
 int main(int argc, char* argv[]){
-	string usage = " [# of boids] [cohesion param] [separation param] [alignment param] [attraction param]";
+	string usage = " [# of boids] [cohesion param] [separation param] [alignment param] [attraction param]"
+		" [--frame-budget ms] [--min-cutoff px] [--max-stride k] [--max-render-skip n] [--threads n] [--processes n]"
+		" [--clusters every-k-frames] [--cluster-radius px] [--density every-k-frames] [--density-cell px] [--heatmap boids-per-cell] [--trails decay]"
+		" [--observables file] [--structure file] [--structure-interval k] [--structure-radius px]"
+		" [--record file] [--archive file] [--graph file] [--spawn-size px] [--spawn-spacing px] [--headings n] [--autotune cache-file]"
+		" [--flight-recorder path-prefix] [--slow-frame ms] [--flight-frames n] [--flight-snapshots n]";
+	string replayUsage = " --replay [trajectory file] [--speed frames-per-frame] [--seek frame] [--trails decay]";
+
+	/* Play back a recording instead, if asked to.
+	 */
+	if(argc >= 3 && string(argv[1]) == "--replay"){
+		double speed = 1.0;
+		double seek = 0.0;
+		float trails = 0.0;
+		for(int i = 3; i < argc; i++){
+			string option(argv[i]);
+			if(i+1 >= argc){
+				cerr << "Missing value for " << option << endl << "Usage: " << argv[0] << replayUsage << endl;
+				exit(1);
+			}
+			if(option == "--speed"){
+				speed = atof(argv[++i]) > 0.0 ? atof(argv[i]) : 1.0;
+			}
+			else if(option == "--seek"){
+				seek = atof(argv[++i]) > 0.0 ? atof(argv[i]) : 0.0;
+			}
+			else if(option == "--trails"){
+				trails = atof(argv[++i]);
+			}
+			else{
+				cerr << "Unknown option " << option << endl << "Usage: " << argv[0] << replayUsage << endl;
+				exit(1);
+			}
+		}
+		replay(argv[2], speed, seek, trails);
+	}
 
 	/* Check for arguments.
 	 */
 	if(argc < 6){
-		cerr << "Usage: " << argv[0] << usage << endl;
+		cerr << "Usage: " << argv[0] << usage << endl << "   or: " << argv[0] << replayUsage << endl;
 		exit(1);
 	}
 
@@ -98,103 +306,435 @@ int main(int argc, char* argv[]){
 	float alignmentCoeff = atof(argv[4]);
 	float attractionCoeff = atof(argv[5]);
 
+	/* Read optional settings.
+	 */
+	float frameBudgetMs = 0.0; // No budget: always run at best quality
+	float minCutoff = 50.0;
+	unsigned int maxStride = 4;
+	unsigned int maxRenderSkip = 3;
+	unsigned int numThreads = thread::hardware_concurrency();
+	unsigned int numProcesses = 0; // Run in this process
+	unsigned int clusterInterval = 0; // No cluster analysis
+	float clusterRadius = 25.0;
+	unsigned int densityInterval = 0; // No density telemetry
+	float densityCell = 50.0;
+	unsigned int heatmapSaturation = 0; // No heatmap
+	float trailDecay = 0.0; // No trails
+	string observablesFile; // No time series
+	string structureFile; // No structure analysis
+	unsigned int structureInterval = 10;
+	float structureRadius = 100.0;
+	string recordFile; // No recording
+	string archiveFile; // No archive
+	string graphFile; // No neighbor graphs
+	float spawnSize = 200.0;
+	float spawnSpacing = 5.0;
+	unsigned int numHeadings = ATLAS_HEADINGS;
+	string tuningFile; // No tuning
+	string flightPrefix; // No flight recorder
+	float slowFrameMs = 100.0;
+	unsigned int flightFrames = FLIGHT_FRAMES;
+	unsigned int flightSnapshots = FLIGHT_SNAPSHOTS;
+	for(int i = 6; i < argc; i++){
+		string option(argv[i]);
+		if(i+1 >= argc){
+			cerr << "Missing value for " << option << endl << "Usage: " << argv[0] << usage << endl;
+			exit(1);
+		}
+		if(option == "--frame-budget"){
+			frameBudgetMs = atof(argv[++i]);
+		}
+		else if(option == "--min-cutoff"){
+			minCutoff = atof(argv[++i]);
+		}
+		else if(option == "--max-stride"){
+			maxStride = atoi(argv[++i]) > 1 ? atoi(argv[i]) : 1;
+		}
+		else if(option == "--max-render-skip"){
+			maxRenderSkip = atoi(argv[++i]) > 0 ? atoi(argv[i]) : 0;
+		}
+		else if(option == "--threads"){
+			numThreads = atoi(argv[++i]) > 1 ? atoi(argv[i]) : 1;
+		}
+		else if(option == "--processes"){
+			numProcesses = atoi(argv[++i]) > 0 ? atoi(argv[i]) : 0;
+		}
+		else if(option == "--clusters"){
+			clusterInterval = atoi(argv[++i]) > 0 ? atoi(argv[i]) : 0;
+		}
+		else if(option == "--cluster-radius"){
+			clusterRadius = atof(argv[++i]);
+		}
+		else if(option == "--density"){
+			densityInterval = atoi(argv[++i]) > 0 ? atoi(argv[i]) : 0;
+		}
+		else if(option == "--density-cell"){
+			densityCell = atof(argv[++i]);
+		}
+		else if(option == "--heatmap"){
+			heatmapSaturation = atoi(argv[++i]) > 0 ? atoi(argv[i]) : 0;
+		}
+		else if(option == "--trails"){
+			trailDecay = atof(argv[++i]);
+		}
+		else if(option == "--observables"){
+			observablesFile = argv[++i];
+		}
+		else if(option == "--structure"){
+			structureFile = argv[++i];
+		}
+		else if(option == "--structure-interval"){
+			structureInterval = atoi(argv[++i]) > 1 ? atoi(argv[i]) : 1;
+		}
+		else if(option == "--structure-radius"){
+			structureRadius = atof(argv[++i]);
+		}
+		else if(option == "--record"){
+			recordFile = argv[++i];
+		}
+		else if(option == "--archive"){
+			archiveFile = argv[++i];
+		}
+		else if(option == "--graph"){
+			graphFile = argv[++i];
+		}
+		else if(option == "--spawn-size"){
+			spawnSize = atof(argv[++i]) > 0.0 ? atof(argv[i]) : 0.0;
+		}
+		else if(option == "--spawn-spacing"){
+			spawnSpacing = atof(argv[++i]) > 1.0 ? atof(argv[i]) : 1.0;
+		}
+		else if(option == "--headings"){
+			numHeadings = atoi(argv[++i]) > 1 ? atoi(argv[i]) : 1;
+		}
+		else if(option == "--autotune"){
+			tuningFile = argv[++i];
+		}
+		else if(option == "--flight-recorder"){
+			flightPrefix = argv[++i];
+		}
+		else if(option == "--slow-frame"){
+			slowFrameMs = atof(argv[++i]) > 0.0 ? atof(argv[i]) : 0.0;
+		}
+		else if(option == "--flight-frames"){
+			flightFrames = atoi(argv[++i]) > 1 ? atoi(argv[i]) : 1;
+		}
+		else if(option == "--flight-snapshots"){
+			flightSnapshots = atoi(argv[++i]) > 0 ? atoi(argv[i]) : 0;
+		}
+		else{
+			cerr << "Unknown option " << option << endl << "Usage: " << argv[0] << usage << endl;
+			exit(1);
+		}
+	}
+
+	/* Only the threads keep track of the flockmates.
+	 */
+	if(!graphFile.empty() && numProcesses > 0){
+		cerr << "--graph can't be used with --processes" << endl;
+		exit(1);
+	}
+
 	/* Setup the drawing area and load graphics.
 	 */
 	const unsigned int screenWidth = 1200;
 	const unsigned int screenHeight = 700;
 	const pair<int, int> screenCenter(screenWidth/2, screenHeight/2);
-	const unsigned int boidHeight = 20;
-	const unsigned int boidWidth = 20;
-	const unsigned int numAnimFrames = 12;
 	pair<int,int> screenLimits(screenWidth, screenHeight);
-	const char* birdIconFile = "gfx/red-arrow-rot-12x.bmp";
+
+	/* Best quality considers every flockmate on screen and draws every
+	 * frame; the frame budget (if any) may trade that away down to the
+	 * configured limits.
+	 */
+	const float screenDiagonal = sqrt(screenWidth*screenWidth + screenHeight*screenHeight);
+	QualitySettings bestQuality = {screenDiagonal, 1, 1};
+	QualitySettings worstQuality = {minCutoff < screenDiagonal ? minCutoff : screenDiagonal, maxStride, maxRenderSkip + 1};
+	QualityController quality(frameBudgetMs, bestQuality, worstQuality);
 
 	SDL_Surface* screen = initializeDisplay(screenWidth, screenHeight);
 	if(!screen) cleanUpAndQuit();
 
-	SDL_Surface* birdIcons = loadBMPImage(birdIconFile);
+	SDL_Surface* birdIcons = loadBMPImage(BIRD_ICON_FILE);
 	if(!birdIcons) cleanUpAndQuit();
 	if(!transparentize(birdIcons, 255, 0, 255)) cleanUpAndQuit();
 
-	/* Instantiate a population of boids with random coordinates, 
-	 * initially moving outwards from the center of the screen.
+	/* Instantiate a population of boids a little ways away from the
+	 * middle of the screen, none of them too close to another, initially
+	 * moving outwards. The threads placing them are done before any
+	 * processes are forked off.
 	 */
-	srand(time(NULL));
 	vector<Boid> pop;
-	for(unsigned int i = 0; i < numBoids; i++){
-		/* Start a little ways away from the middle of the
-		 * box, and head outwards.
-		 */
-		float x = badRandom(screenCenter.first - 100, screenCenter.first + 100);
-		float y = badRandom(screenCenter.second - 100, screenCenter.second + 100);
-		Point coordinates(x, y);
-		Vector velocity(copysign(3.0, x-screenCenter.first), copysign(3.0, y-screenCenter.second));
-		pop.push_back(Boid(coordinates, velocity, cohesionCoeff, separationCoeff, alignmentCoeff, attractionCoeff, Point(screenLimits.first, screenLimits.second)));
+	{
+		WorkerPool placers(numThreads);
+		vector<Point> positions;
+		try{
+			placePoissonDisk(numBoids, Point(screenCenter.first, screenCenter.second), spawnSize, spawnSpacing, Point(screenLimits.first, screenLimits.second), time(NULL), placers, positions);
+		}
+		catch(runtime_error& e){
+			SDL_Quit();
+			cerr << e.what() << endl;
+			exit(1);
+		}
+		for(unsigned int i = 0; i < numBoids; i++){
+			Point coordinates = positions[i];
+			Vector velocity(copysign(3.0, coordinates.x-screenCenter.first), copysign(3.0, coordinates.y-screenCenter.second));
+			pop.push_back(Boid(coordinates, velocity, cohesionCoeff, separationCoeff, alignmentCoeff, attractionCoeff, Point(screenLimits.first, screenLimits.second), i));
+		}
+	}
+
+	/* Run with the settings that are fastest on this host for this kind
+	 * of run, if asked to: from the cache, or timed now and cached. At
+	 * most as many threads as asked for are tried. Done before any
+	 * processes are forked off, too.
+	 */
+	SpriteAtlas* atlas = makeAtlas(birdIcons, numHeadings);
+	TuningSettings tuning = {numThreads, 1, TILE_SIZE};
+	if(!tuningFile.empty()){
+		ostringstream workload;
+		workload << numBoids << ' ' << cohesionCoeff << ' ' << separationCoeff << ' ' << alignmentCoeff << ' ' << attractionCoeff
+			<< ' ' << spawnSize << ' ' << spawnSpacing << ' ' << screenWidth << 'x' << screenHeight << ' ' << numThreads;
+		string host = hostName();
+		if(!findTuning(tuningFile, host, workload.str(), tuning)){
+			cout << "Tuning " << numBoids << " Boids for " << host << endl;
+			try{
+				autotune(pop, Point(screenLimits.first, screenLimits.second), WRAPPED, Point(screenCenter.first, screenCenter.second), bestQuality, *atlas, screen, numThreads, tuning);
+				storeTuning(tuningFile, host, workload.str(), tuning);
+			}
+			catch(runtime_error& e){
+				SDL_Quit();
+				cerr << e.what() << endl;
+				exit(1);
+			}
+		}
+		cout << "Running on " << tuning.threads << " threads, " << tuning.stripsPerWorker << " strips per thread, " << tuning.tileSize << " pixel tiles" << endl;
+	}
+
+	/* Hand the population over to the worker threads, each of them
+	 * pinned to a core and responsible for strips of the world. Or,
+	 * if asked to, to separate processes for each strip (forked off
+	 * before any threads are started).
+	 */
+	Simulation* sim = NULL;
+	DomainDecomposition* domains = NULL;
+	if(numProcesses > 0){
+		try{
+			domains = new DomainDecomposition(pop, Point(screenLimits.first, screenLimits.second), WRAPPED, numProcesses);
+		}
+		catch(runtime_error& e){
+			SDL_Quit();
+			cerr << e.what() << endl;
+			exit(1);
+		}
+	}
+	WorkerPool workers(tuning.threads);
+	if(!domains){
+		sim = new Simulation(pop, Point(screenLimits.first, screenLimits.second), WRAPPED, workers, tuning.stripsPerWorker);
+	}
+	TileRenderer* renderer = new TileRenderer(*atlas, workers, tuning.tileSize);
+	renderer->setTrails(trailDecay);
+	vector<unsigned char> tints;
+	unsigned int zoom = 0;
+	ClusterAnalysis clusters(Point(screenLimits.first, screenLimits.second), clusterRadius, workers);
+	DensityTelemetry density(Point(screenLimits.first, screenLimits.second), densityCell, DENSITY_HOTSPOTS);
+	vector<float> heat;
+
+	/* Stream the order parameters of the flock, if asked to.
+	 */
+	ofstream observablesOut;
+	if(!observablesFile.empty()){
+		observablesOut.open(observablesFile.c_str());
+		if(!observablesOut){
+			cerr << "Unable to write to " << observablesFile << endl;
+			exit(1);
+		}
+		writeObservablesHeader(observablesOut);
+	}
+
+	/* Accumulate the structure of the flock, if asked to. The file is
+	 * opened right away so that a bad path shows up before the run.
+	 */
+	PairCorrelation structure(Point(screenLimits.first, screenLimits.second), structureRadius, STRUCTURE_BINS, workers);
+	ofstream structureOut;
+	if(!structureFile.empty()){
+		structureOut.open(structureFile.c_str());
+		if(!structureOut){
+			cerr << "Unable to write to " << structureFile << endl;
+			exit(1);
+		}
+	}
+
+	/* Record the run for later analysis, if asked to.
+	 */
+	TrajectoryRecorder* recorder = NULL;
+	TrajectoryArchiver* archiver = NULL;
+	NeighborGraphWriter* graphWriter = NULL;
+	try{
+		if(!recordFile.empty()){
+			recorder = new TrajectoryRecorder(recordFile, numBoids, Point(screenLimits.first, screenLimits.second));
+		}
+		if(!archiveFile.empty()){
+			archiver = new TrajectoryArchiver(archiveFile, numBoids, Point(screenLimits.first, screenLimits.second), ARCHIVE_CHUNK_FRAMES, ARCHIVE_THREADS);
+		}
+		if(!graphFile.empty()){
+			graphWriter = new NeighborGraphWriter(graphFile, numBoids);
+		}
+	}
+	catch(runtime_error& e){
+		cerr << e.what() << endl;
+		exit(1);
+	}
+
+	/* Keep the last few seconds of the run, and write them out when a
+	 * frame takes too long, if asked to.
+	 */
+	FlightRecorder* flight = NULL;
+	if(!flightPrefix.empty()){
+		flight = new FlightRecorder(flightPrefix, slowFrameMs, flightFrames, flightSnapshots, numBoids, Point(screenLimits.first, screenLimits.second), sim ? sim->getProfile().stripStart.size() : 0);
+	}
+
+	/* Keep track of the flockmates for the neighbor graphs.
+	 */
+	NeighborGraph graph;
+	if(graphWriter){
+		sim->keepNeighbors(true);
 	}
 
 	/* Run simulation and display results until the user gets sick of it.
 	 */
-	vector<Boid> newPop;
 	SDL_Event event;
 	Point mousePos(screenCenter.first, screenCenter.second);
+	unsigned long frame = 0;
 	bool running = true;
 	while(running){
+		chrono::steady_clock::time_point frameStart = chrono::steady_clock::now();
+		QualitySettings settings = quality.getSettings();
+		if(flight){
+			flight->beginFrame(frame, pop);
+		}
+
 		/* Advance the simulation one step.
 		 */
-		newPop.clear();
-		for(unsigned int i = 0; i < pop.size(); i++){
-			/* Only consider the coordinates of the rest of the
-			 * flock, not yourself.
-			 */
-			vector<Boid> allOthers(pop);
-			allOthers.erase(allOthers.begin() + i);
-
-			 /*
-			 * Wrap-around the screen as necessary, or deal with
-			 * errors that can occur during collision with the
-			 * edge of the simulation world.
+		if(domains){
+			/* A domain process that died takes the run with it.
 			 */
-			if(WRAPPED){
-				newPop.push_back(pop[i].wrappedStep(allOthers, mousePos, screenLimits.first, screenLimits.second));
+			try{
+				domains->step(mousePos, settings);
 			}
-			else{
-				try{
-					newPop.push_back(pop[i].step(allOthers, mousePos));
-				}
-				catch(domain_error& e){
-					/* Just cheat and replace the boid
-					 * at some random valid position near
-					 * the center of the screen.
-					 */
-					float x = badRandom(screenCenter.first - 100, screenCenter.first + 100);
-					float y = badRandom(screenCenter.second - 100, screenCenter.second + 100);
-					newPop.push_back(Boid(Point(x,y), Vector(0.0, 0.0), cohesionCoeff, separationCoeff, alignmentCoeff, attractionCoeff, Point(screenLimits.first, screenLimits.second)));
-				}	
+			catch(runtime_error& e){
+				SDL_Quit();
+				cerr << e.what() << endl;
+				exit(1);
+			}
+			domains->getBoids(pop);
+		}
+		else{
+			sim->step(mousePos, settings);
+			sim->getBoids(pop);
+		}
+		if(flight){
+			flight->endPhase("step");
+			if(sim){
+				flight->addProfile(sim->getProfile());
 			}
 		}
-		pop = newPop;
-		
-		/* Setup drawing for the next frame.
+
+		/* The order parameters come for free with the step, and
+		 * describe the population as it was before it.
 		 */
-		SDL_FillRect(screen, NULL, SDL_MapRGB(screen->format, 0, 0, 0));
+		if(observablesOut.is_open()){
+			writeObservables(observablesOut, frame, domains ? domains->getObservables() : sim->getObservables());
+		}
+
+		if(recorder){
+			recorder->record(pop);
+		}
+		if(archiver){
+			archiver->record(pop);
+		}
+		if(graphWriter){
+			sim->getNeighborGraph(graph);
+			graphWriter->record(frame, graph);
+		}
+		if(flight){
+			flight->endPhase("output");
+		}
 
-		/* Draw the new population.
+		/* Count the sub-flocks every so often.
 		 */
-		for(unsigned int i = 0; i < pop.size(); i++){
-			Point coordinates = pop[i].getCoordinates();
-			Vector velocity = pop[i].getVelocity();
+		if(clusterInterval > 0 && frame % clusterInterval == 0){
+			clusters.analyze(pop);
+			clusters.report(cout, frame);
+			tintClusters(pop, clusters, atlas->getNumTints(), tints);
+		}
 
-			/* Draw part of the animation sprite.
-			 */
-			unsigned int frameNum = closestFrame(velocity, numAnimFrames);
-			unsigned int x = coordinates.x - (int)boidHeight*0.5;
-			unsigned int y = coordinates.y - (int)boidWidth*0.5; // Image should be _centered_ on the coordinates
-			drawPartOfImage(screen, birdIcons, x, y, frameNum*20, 0, boidHeight, boidWidth); 
+		/* Count the Boids per cell every so often, and report them
+		 * along with the work the step took. The heatmap needs them
+		 * every frame that is drawn.
+		 */
+		bool densityDue = densityInterval > 0 && frame % densityInterval == 0;
+		bool heatmapDue = heatmapSaturation > 0 && frame % settings.renderEvery == 0;
+		if(densityDue || heatmapDue){
+			density.analyze(pop);
+		}
+		if(densityDue){
+			density.report(cout, frame, domains ? domains->getObservables() : sim->getObservables());
+		}
+		if(heatmapDue){
+			density.getHeat(heatmapSaturation, heat);
+			renderer->setHeatmap(heat, density.getColumns(), density.getCellSize());
 		}
 
-		/* Preform the actual rendering.
+		/* Bin the pair distances every so often.
 		 */
-		SDL_Flip(screen);
+		if(structureOut.is_open() && frame % structureInterval == 0){
+			structure.accumulate(pop);
+		}
+		if(flight){
+			flight->endPhase("analysis");
+		}
+
+		/* Draw the new population, unless running behind schedule
+		 * and this frame is to be skipped.
+		 */
+		if(frame % settings.renderEvery == 0){
+			renderer->draw(screen, pop, zoom, tints);
+		}
+		if(flight){
+			flight->endPhase("draw");
+		}
+
+		/* Hold the frame budget, if there is one.
+		 */
+		if(frameBudgetMs > 0.0){
+			chrono::duration<float, milli> frameTime = chrono::steady_clock::now() - frameStart;
+			quality.frameFinished(frameTime.count());
+		}
+
+		/* Write out the last few seconds if the frame was slow. That
+		 * takes a while, but isn't counted against any frame.
+		 */
+		if(flight){
+			Observables observed = domains ? domains->getObservables() : sim->getObservables();
+			flight->count("cutoff", settings.cutoff);
+			flight->count("stride", settings.stride);
+			flight->count("render every", settings.renderEvery);
+			flight->count("pair tests", observed.pairTests);
+			flight->count("interactions", observed.interactions);
+			flight->count("destination x", mousePos.x);
+			flight->count("destination y", mousePos.y);
+			if(sim){
+				flight->count("halo", sim->haloSize());
+			}
+			try{
+				if(flight->endFrame()){
+					cout << "Frame " << frame << " was slow, wrote " << flight->getLastDump() << ".json and .trj" << endl;
+				}
+			}
+			catch(runtime_error& e){
+				cerr << e.what() << endl;
+			}
+		}
+		frame++;
 
 		/* Check for the user quitting the application or moving
 		 * the mouse.
@@ -208,12 +748,34 @@ int main(int argc, char* argv[]){
 					mousePos.x = event.motion.x;
 					mousePos.y = event.motion.y;
 					break;
+				case SDL_KEYDOWN:
+					zoom = zoomed(zoom, event.key.keysym.sym, atlas->getNumZooms());
+					break;
 			}
 		}
 	}
 
-	/* Clean-up SDL resources.
+	/* Write out what was accumulated over the run.
+	 */
+	if(structureOut.is_open()){
+		structure.write(structureOut);
+	}
+
+	/* Flush the output files by hand: exit() won't.
+	 */
+	observablesOut.close();
+	structureOut.close();
+	delete recorder;
+	delete archiver;
+	delete graphWriter;
+	delete flight;
+
+	/* Clean-up simulation and SDL resources.
 	 */
+	delete renderer;
+	delete atlas;
+	delete domains;
+	delete sim;
 	SDL_Quit();
 
 	exit(0);
@@ -0,0 +1,361 @@
+/**
+ * \file flockmodule.cpp
+ *
+ * Python extension module "flock", for running flocks from Python without
+ * going through files.
+ *
+ *     import flock, numpy
+ *     f = flock.Flock(100000, cohesion=0.01, threads=8)
+ *     x, y, vx, vy = numpy.asarray(f)
+ *     f.step(100)
+ *
+ * A Flock is a Simulation on worker threads of its own (see Simulation.cpp),
+ * started from a population placed as the daemon places it. step() runs
+ * any number of steps with the interpreter lock released, so other Python
+ * threads carry on meanwhile, and at the end the workers collect the
+ * positions and velocities into one block of doubles, by identity: x, y,
+ * vx and vy, one row each. The Flock hands out that block through the
+ * buffer protocol, read-only and with shape (4, N), so NumPy arrays made
+ * from it alias it instead of copying it, and show the new state after
+ * every call to step() without being made again. The block is collected
+ * once per call, not once per step, so stepping many times per call costs
+ * next to nothing on top of the steps themselves.
+ *
+ * The block never moves while the Flock lives (the number of Boids never
+ * changes), and arrays made from it keep the Flock alive.
+ *
+ * @since	2026-10-18
+ */
+
+/**
+ * Includes.
+ *
+ * Python.h goes first, as Python asks, and the standard headers before the
+ * other headers of the project, since they break on the min() and max()
+ * macros of geometry/common.h.
+ */
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <vector>
+#include <thread>
+#include <stdexcept>
+#include <new>
+#include <string>
+#include <math.h>
+#include "../WorkerPool.h"
+#include "../Simulation.h"
+#include "../Placement.h"
+
+/**
+ * Definitions.
+ */
+#define STATE_ROWS 4 // x, y, vx and vy
+
+using namespace std;
+
+/**
+ * A Flock as Python sees it.
+ */
+struct FlockObject {
+	PyObject_HEAD
+	WorkerPool* workers;
+	Simulation* sim;
+	vector<double>* state;		// STATE_ROWS rows of numBoids, by identity.
+	unsigned int numBoids;
+	Point edges;
+	unsigned long steps;		// Taken so far.
+	bool stepping;			// A step() is under way on another thread.
+	Py_ssize_t shape[2];
+	Py_ssize_t strides[2];
+};
+
+/**
+ * Sets the Python exception that corresponds to a C++ one.
+ *
+ * @param e	The C++ exception: MemoryError for running out of memory,
+ * 		ValueError for what the arguments asked for, and
+ * 		RuntimeError for anything else.
+ */
+static void setPythonError(const exception& e){
+	if(dynamic_cast<const bad_alloc*>(&e)){
+		PyErr_NoMemory();
+	}
+	else if(dynamic_cast<const runtime_error*>(&e)){
+		PyErr_SetString(PyExc_ValueError, e.what());
+	}
+	else{
+		PyErr_SetString(PyExc_RuntimeError, e.what());
+	}
+}
+
+/**
+ * Makes a Flock: Flock(boids, cohesion=0.005, separation=0.2,
+ * alignment=0.05, attraction=1.0, width=1200, height=700, threads=0,
+ * seed=1, spawn=200, spacing=5). Zero threads means one per core.
+ *
+ * @return	0, or -1 with a Python exception set.
+ */
+static int flockInit(FlockObject* self, PyObject* args, PyObject* kwargs){
+	const char* keywords[] = {"boids", "cohesion", "separation", "alignment", "attraction", "width", "height", "threads", "seed", "spawn", "spacing", NULL};
+	unsigned int numBoids = 0, numThreads = 0, seed = 1;
+	float cohesion = 0.005, separation = 0.2, alignment = 0.05, attraction = 1.0;
+	float width = 1200, height = 700, spawnSize = 200, spacing = 5;
+	if(!PyArg_ParseTupleAndKeywords(args, kwargs, "I|ffffffIIff", (char**) keywords, &numBoids, &cohesion, &separation, &alignment, &attraction, &width, &height, &numThreads, &seed, &spawnSize, &spacing)){
+		return -1;
+	}
+	if(self->sim){
+		PyErr_SetString(PyExc_RuntimeError, "Flock is already set up");
+		return -1;
+	}
+	if(numBoids == 0 || width < 1.0 || height < 1.0){
+		PyErr_SetString(PyExc_ValueError, "A flock needs Boids and a world to fly in");
+		return -1;
+	}
+	if(!isfinite(cohesion) || !isfinite(separation) || !isfinite(alignment) || !isfinite(attraction)
+		|| !isfinite(width) || !isfinite(height) || !isfinite(spawnSize) || !isfinite(spacing)){
+		PyErr_SetString(PyExc_ValueError, "Coefficients and sizes must be finite numbers");
+		return -1;
+	}
+
+	/* A little ways away from the middle of the world, none of them too
+	 * close to another, heading outwards. No C++ exception may get
+	 * into the interpreter, so whatever is thrown on the way is undone
+	 * and turned into a Python exception.
+	 */
+	self->edges = Point(width, height);
+	Point center(width/2, height/2);
+	try{
+		self->workers = new WorkerPool(numThreads > 0 ? numThreads : thread::hardware_concurrency());
+		vector<Point> positions;
+		placePoissonDisk(numBoids, center, spawnSize, spacing > 1.0 ? spacing : 1.0, self->edges, seed, *self->workers, positions);
+		vector<Boid> pop;
+		for(unsigned int i = 0; i < numBoids; i++){
+			Vector velocity(copysign(3.0, positions[i].x-center.x), copysign(3.0, positions[i].y-center.y));
+			pop.push_back(Boid(positions[i], velocity, cohesion, separation, alignment, attraction, self->edges, i));
+		}
+
+		self->sim = new Simulation(pop, self->edges, false, *self->workers, 1);
+		self->state = new vector<double>(STATE_ROWS*(size_t) numBoids);
+	}
+	catch(exception& e){
+		delete self->sim;
+		delete self->workers;
+		self->sim = NULL;
+		self->workers = NULL;
+		setPythonError(e);
+		return -1;
+	}
+	self->numBoids = numBoids;
+	double* state = &(*self->state)[0];
+	self->sim->getState(state, state + numBoids, state + 2*(size_t) numBoids, state + 3*(size_t) numBoids, numBoids);
+	self->steps = 0;
+	self->shape[0] = STATE_ROWS;
+	self->shape[1] = numBoids;
+	self->strides[0] = numBoids*sizeof(double);
+	self->strides[1] = sizeof(double);
+
+	return 0;
+}
+
+/**
+ * Frees a Flock, once nothing refers to it or its state any more.
+ */
+static void flockDealloc(FlockObject* self){
+	delete self->sim;
+	delete self->workers;
+	delete self->state;
+	Py_TYPE(self)->tp_free((PyObject*) self);
+}
+
+/**
+ * Advances the flock: step(steps=1, x=width/2, y=height/2, cutoff=0,
+ * stride=1). The Boids head for (x, y), with flockmates up to cutoff away
+ * in sight (0 for the whole world), considering every stride-th of them.
+ *
+ * @return	None, or NULL with a Python exception set.
+ */
+static PyObject* flockStep(FlockObject* self, PyObject* args, PyObject* kwargs){
+	const char* keywords[] = {"steps", "x", "y", "cutoff", "stride", NULL};
+	unsigned long numSteps = 1;
+	float x = self->edges.x/2, y = self->edges.y/2, cutoff = 0.0;
+	unsigned int stride = 1;
+	if(!PyArg_ParseTupleAndKeywords(args, kwargs, "|kfffI", (char**) keywords, &numSteps, &x, &y, &cutoff, &stride)){
+		return NULL;
+	}
+	if(!self->sim){
+		PyErr_SetString(PyExc_RuntimeError, "Flock is not set up");
+		return NULL;
+	}
+	if(self->stepping){
+		PyErr_SetString(PyExc_RuntimeError, "Flock is being stepped on another thread");
+		return NULL;
+	}
+	if(!isfinite(x) || !isfinite(y) || !isfinite(cutoff)){
+		PyErr_SetString(PyExc_ValueError, "Destination and cutoff must be finite numbers");
+		return NULL;
+	}
+
+	float diagonal = sqrt(self->edges.x*self->edges.x + self->edges.y*self->edges.y);
+	QualitySettings quality = {cutoff > 0.0 ? cutoff : diagonal, stride > 1 ? stride : 1, 1};
+	Point destination(x, y);
+	double* state = &(*self->state)[0];
+	size_t numBoids = self->numBoids;
+	unsigned long taken = 0;
+	bool failed = false;
+	bool outOfMemory = false;
+	string what;
+	self->stepping = true;
+	Py_BEGIN_ALLOW_THREADS
+	try{
+		for(; taken < numSteps; taken++){
+			self->sim->step(destination, quality);
+		}
+		self->sim->getState(state, state + numBoids, state + 2*numBoids, state + 3*numBoids, numBoids);
+	}
+	catch(exception& e){
+		/* Raised once the interpreter lock is back.
+		 */
+		failed = true;
+		outOfMemory = dynamic_cast<bad_alloc*>(&e) != NULL;
+		what = e.what();
+	}
+	Py_END_ALLOW_THREADS
+	self->stepping = false;
+	self->steps += taken;
+	if(failed){
+		if(outOfMemory){
+			return PyErr_NoMemory();
+		}
+		PyErr_SetString(PyExc_RuntimeError, what.c_str());
+		return NULL;
+	}
+
+	Py_RETURN_NONE;
+}
+
+/**
+ * Order parameters of the flock before the last step, and the work the step
+ * took (see Observables.h).
+ *
+ * @return	A dict, or NULL with a Python exception set.
+ */
+static PyObject* flockObservables(FlockObject* self, PyObject*){
+	if(!self->sim){
+		PyErr_SetString(PyExc_RuntimeError, "Flock is not set up");
+		return NULL;
+	}
+	Observables o = self->sim->getObservables();
+
+	return Py_BuildValue("{s:d,s:d,s:d,s:d,s:(dd),s:k,s:k}", "polarization", o.polarization, "milling", o.milling,
+		"nearest_neighbor", o.nearestNeighbor, "group_speed", o.groupSpeed, "centroid", (double) o.centroid.x, (double) o.centroid.y,
+		"pair_tests", o.pairTests, "interactions", o.interactions);
+}
+
+/**
+ * Getter for the number of Boids, as len(flock).
+ */
+static Py_ssize_t flockLength(FlockObject* self){
+	return self->numBoids;
+}
+
+/**
+ * Getter for the number of steps taken.
+ */
+static PyObject* flockGetSteps(FlockObject* self, void*){
+	return PyLong_FromUnsignedLong(self->steps);
+}
+
+/**
+ * Hands out the state block, read-only, as a (4, N) array of doubles.
+ *
+ * @return	0, or -1 with a Python exception set.
+ */
+static int flockGetBuffer(FlockObject* self, Py_buffer* view, int flags){
+	if(!self->state){
+		PyErr_SetString(PyExc_BufferError, "Flock is not set up");
+		view->obj = NULL;
+		return -1;
+	}
+	if(flags & PyBUF_WRITABLE){
+		PyErr_SetString(PyExc_BufferError, "The state of a Flock is read-only");
+		view->obj = NULL;
+		return -1;
+	}
+
+	view->obj = (PyObject*) self;
+	Py_INCREF(self);
+	view->buf = &(*self->state)[0];
+	view->len = self->state->size()*sizeof(double);
+	view->readonly = 1;
+	view->itemsize = sizeof(double);
+	view->format = (flags & PyBUF_FORMAT) ? (char*) "d" : NULL;
+	/* Without a shape, the state goes out as plain bytes.
+	 */
+	view->ndim = (flags & PyBUF_ND) == PyBUF_ND ? 2 : 1;
+	view->shape = (flags & PyBUF_ND) == PyBUF_ND ? self->shape : NULL;
+	view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? self->strides : NULL;
+	view->suboffsets = NULL;
+	view->internal = NULL;
+
+	return 0;
+}
+
+static PyMethodDef flockMethods[] = {
+	{"step", (PyCFunction) (void(*)(void)) flockStep, METH_VARARGS | METH_KEYWORDS, "step(steps=1, x=width/2, y=height/2, cutoff=0, stride=1)\n\nAdvances the flock, with the interpreter lock released."},
+	{"observables", (PyCFunction) (void(*)(void)) flockObservables, METH_NOARGS, "observables()\n\nOrder parameters before the last step, and the work it took."},
+	{NULL, NULL, 0, NULL}
+};
+
+static PyGetSetDef flockGetSet[] = {
+	{(char*) "steps", (getter) flockGetSteps, NULL, (char*) "Steps taken so far.", NULL},
+	{NULL, NULL, NULL, NULL, NULL}
+};
+
+static PySequenceMethods flockSequence;
+static PyBufferProcs flockBuffer;
+static PyTypeObject flockType;
+static PyModuleDef flockModule;
+
+/**
+ * Sets up the module.
+ *
+ * @return	The module, or NULL with a Python exception set.
+ */
+PyMODINIT_FUNC PyInit_flock(){
+	flockSequence.sq_length = (lenfunc) flockLength;
+	flockBuffer.bf_getbuffer = (getbufferproc) flockGetBuffer;
+
+	flockType.tp_name = "flock.Flock";
+	flockType.tp_basicsize = sizeof(FlockObject);
+	flockType.tp_flags = Py_TPFLAGS_DEFAULT;
+	flockType.tp_doc = "Flock(boids, cohesion=0.005, separation=0.2, alignment=0.05, attraction=1.0, width=1200, height=700, threads=0, seed=1, spawn=200, spacing=5)\n\n"
+		"A flock on worker threads of its own. numpy.asarray(flock) is its state, x, y, vx and vy by identity, updated in place by step().";
+	flockType.tp_new = PyType_GenericNew;
+	flockType.tp_init = (initproc) flockInit;
+	flockType.tp_dealloc = (destructor) flockDealloc;
+	flockType.tp_methods = flockMethods;
+	flockType.tp_getset = flockGetSet;
+	flockType.tp_as_sequence = &flockSequence;
+	flockType.tp_as_buffer = &flockBuffer;
+	Py_SET_REFCNT(&flockType, 1);
+	if(PyType_Ready(&flockType) < 0){
+		return NULL;
+	}
+
+	flockModule.m_base = PyModuleDef_HEAD_INIT;
+	flockModule.m_name = "flock";
+	flockModule.m_doc = "Flocking simulation, with zero-copy access to the state of the flock.";
+	flockModule.m_size = -1;
+	PyObject* module = PyModule_Create(&flockModule);
+	if(!module){
+		return NULL;
+	}
+	Py_INCREF(&flockType);
+	if(PyModule_AddObject(module, "Flock", (PyObject*) &flockType) < 0){
+		Py_DECREF(&flockType);
+		Py_DECREF(module);
+		return NULL;
+	}
+
+	return module;
+}